@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_BULK_INSERT_ACK_HPP
+#define REPO_BULK_INSERT_ACK_HPP
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/name.hpp>
+#include "repo-tlv.hpp"
+
+namespace repo {
+
+using ndn::Name;
+using ndn::Block;
+using ndn::EncodingImpl;
+using ndn::EncodingEstimator;
+using ndn::EncodingBuffer;
+
+/**
+ * @brief cumulative acknowledgement of a TCP bulk insert connection
+ *
+ * A client that sends a BulkInsertAckRequest element on its connection receives an
+ * acknowledgement after every batch that contained its Data.  Counters cover all
+ * Data elements received on the connection so far, and LastName is the name of the
+ * most recent Data that was processed.  StatusCode is 200 while every Data was stored
+ * or already present, otherwise it is the code of the most recent failure:
+ * 400 (undecodable Data), 500 (storage error) or 507 (repo is full).
+ *
+ *     BulkInsertAck ::= BULK-INSERT-ACK-TYPE TLV-LENGTH
+ *                         StatusCode
+ *                         InsertNum
+ *                         DuplicateNum
+ *                         FailedNum
+ *                         Name?
+ */
+class BulkInsertAck
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : ndn::tlv::Error(what)
+    {
+    }
+  };
+
+  BulkInsertAck()
+    : m_statusCode(200)
+    , m_insertNum(0)
+    , m_duplicateNum(0)
+    , m_failedNum(0)
+  {
+  }
+
+  explicit
+  BulkInsertAck(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  uint64_t
+  getStatusCode() const
+  {
+    return m_statusCode;
+  }
+
+  BulkInsertAck&
+  setStatusCode(uint64_t statusCode)
+  {
+    m_statusCode = statusCode;
+    m_wire.reset();
+    return *this;
+  }
+
+  uint64_t
+  getInsertNum() const
+  {
+    return m_insertNum;
+  }
+
+  BulkInsertAck&
+  setInsertNum(uint64_t insertNum)
+  {
+    m_insertNum = insertNum;
+    m_wire.reset();
+    return *this;
+  }
+
+  uint64_t
+  getDuplicateNum() const
+  {
+    return m_duplicateNum;
+  }
+
+  BulkInsertAck&
+  setDuplicateNum(uint64_t duplicateNum)
+  {
+    m_duplicateNum = duplicateNum;
+    m_wire.reset();
+    return *this;
+  }
+
+  uint64_t
+  getFailedNum() const
+  {
+    return m_failedNum;
+  }
+
+  BulkInsertAck&
+  setFailedNum(uint64_t failedNum)
+  {
+    m_failedNum = failedNum;
+    m_wire.reset();
+    return *this;
+  }
+
+  /**
+   * @brief number of Data elements processed so far
+   */
+  uint64_t
+  getProcessedNum() const
+  {
+    return m_insertNum + m_duplicateNum + m_failedNum;
+  }
+
+  /**
+   * @brief name of the most recent processed Data, empty if none could be decoded
+   */
+  const Name&
+  getLastName() const
+  {
+    return m_lastName;
+  }
+
+  BulkInsertAck&
+  setLastName(const Name& lastName)
+  {
+    m_lastName = lastName;
+    m_wire.reset();
+    return *this;
+  }
+
+  template<bool T>
+  size_t
+  wireEncode(EncodingImpl<T>& block) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  uint64_t m_statusCode;
+  uint64_t m_insertNum;
+  uint64_t m_duplicateNum;
+  uint64_t m_failedNum;
+  Name m_lastName;
+
+  mutable Block m_wire;
+};
+
+template<bool T>
+inline size_t
+BulkInsertAck::wireEncode(EncodingImpl<T>& encoder) const
+{
+  size_t totalLength = 0;
+
+  if (!m_lastName.empty())
+    totalLength += m_lastName.wireEncode(encoder);
+
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::FailedNum, m_failedNum);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::DuplicateNum, m_duplicateNum);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::InsertNum, m_insertNum);
+  totalLength += prependNonNegativeIntegerBlock(encoder, tlv::StatusCode, m_statusCode);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::BulkInsertAck);
+  return totalLength;
+}
+
+inline const Block&
+BulkInsertAck::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+inline void
+BulkInsertAck::wireDecode(const Block& wire)
+{
+  m_statusCode = 0;
+  m_insertNum = 0;
+  m_duplicateNum = 0;
+  m_failedNum = 0;
+  m_lastName.clear();
+
+  m_wire = wire;
+
+  m_wire.parse();
+
+  if (m_wire.type() != tlv::BulkInsertAck)
+    throw Error("Requested decoding of BulkInsertAck, but Block is of different type");
+
+  Block::element_const_iterator val = m_wire.elements_begin();
+
+  if (val == m_wire.elements_end() || val->type() != tlv::StatusCode)
+    throw Error("required field StatusCode is missing");
+  m_statusCode = readNonNegativeInteger(*val);
+  ++val;
+
+  if (val == m_wire.elements_end() || val->type() != tlv::InsertNum)
+    throw Error("required field InsertNum is missing");
+  m_insertNum = readNonNegativeInteger(*val);
+  ++val;
+
+  if (val == m_wire.elements_end() || val->type() != tlv::DuplicateNum)
+    throw Error("required field DuplicateNum is missing");
+  m_duplicateNum = readNonNegativeInteger(*val);
+  ++val;
+
+  if (val == m_wire.elements_end() || val->type() != tlv::FailedNum)
+    throw Error("required field FailedNum is missing");
+  m_failedNum = readNonNegativeInteger(*val);
+  ++val;
+
+  if (val != m_wire.elements_end() && val->type() == tlv::Name)
+    m_lastName.wireDecode(*val);
+}
+
+} // namespace repo
+
+#endif // REPO_BULK_INSERT_ACK_HPP
@@ -66,6 +66,7 @@ using std::make_shared;
 using std::bind;
 using std::placeholders::_1;
 using std::placeholders::_2;
+using std::placeholders::_3;
 
 using boost::noncopyable;
 
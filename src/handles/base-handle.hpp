@@ -25,6 +25,7 @@
 #include "storage/repo-storage.hpp"
 #include "repo-command-response.hpp"
 #include "repo-command-parameter.hpp"
+#include "util/response-signer.hpp"
 
 namespace repo {
 
@@ -42,11 +43,11 @@ public:
   };
 
 public:
-  BaseHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
+  BaseHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
              Scheduler& scheduler)
     : m_face(face)
     , m_storageHandle(storageHandle)
-    , m_keyChain(keyChain)
+    , m_signer(signer)
     , m_scheduler(scheduler)
    // , m_storeindex(storeindex)
   {
@@ -75,6 +76,12 @@ protected:
     return m_scheduler;
   }
 
+  inline ResponseSigner&
+  getSigner()
+  {
+    return m_signer;
+  }
+
   // inline RepoStorage&
   // getStoreIndex()
   // {
@@ -98,11 +105,15 @@ protected:
   void
   extractParameter(const Interest& interest, const Name& prefix, RepoCommandParameter& parameter);
 
+private:
+  void
+  onResponseSigned(const shared_ptr<Data>& data);
+
 private:
 
   Face& m_face;
   RepoStorage& m_storageHandle;
-  KeyChain& m_keyChain;
+  ResponseSigner& m_signer;
   Scheduler& m_scheduler;
  // RepoStorage& m_storeindex;
 };
@@ -112,8 +123,13 @@ BaseHandle::reply(const Interest& commandInterest, const RepoCommandResponse& re
 {
   std::shared_ptr<Data> rdata = std::make_shared<Data>(commandInterest.getName());
   rdata->setContent(response.wireEncode());
-  m_keyChain.sign(*rdata);
-  m_face.put(*rdata);
+  m_signer.signAsync(rdata, bind(&BaseHandle::onResponseSigned, this, _1));
+}
+
+inline void
+BaseHandle::onResponseSigned(const shared_ptr<Data>& data)
+{
+  m_face.put(*data);
 }
 
 inline void
@@ -21,10 +21,10 @@
 
 namespace repo {
 
-DeleteHandle::DeleteHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
+DeleteHandle::DeleteHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
                            Scheduler& scheduler,// RepoStorage& storeindex,
                            ValidatorConfig& validator)
-  : BaseHandle(face, storageHandle, keyChain, scheduler)
+  : BaseHandle(face, storageHandle, signer, scheduler)
   , m_validator(validator)
 {
 }
@@ -40,7 +40,7 @@ public:
   };
 
 public:
-  DeleteHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
+  DeleteHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
                Scheduler& scheduler, ValidatorConfig& validator);
 
   virtual void
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "maintenance-handle.hpp"
+
+namespace repo {
+
+MaintenanceHandle::MaintenanceHandle(Face& face, RepoStorage& storageHandle,
+                                     ResponseSigner& signer, Scheduler& scheduler,
+                                     ValidatorConfig& validator)
+  : BaseHandle(face, storageHandle, signer, scheduler)
+  , m_validator(validator)
+  , m_idleInterval(0)
+  , m_idlePages(0)
+{
+}
+
+void
+MaintenanceHandle::listen(const Name& prefix)
+{
+  ndn::Name maintenancePrefix = Name(prefix).append("maintenance");
+  ndn::InterestFilter filter(maintenancePrefix);
+  getFace().setInterestFilter(filter,
+                              bind(&MaintenanceHandle::onInterest, this, _1, _2),
+                              bind(&MaintenanceHandle::onRegisterFailed, this, _1, _2));
+}
+
+void
+MaintenanceHandle::onInterest(const Name& prefix, const Interest& interest)
+{
+  m_validator.validate(interest, bind(&MaintenanceHandle::onValidated, this, _1, prefix),
+                       bind(&MaintenanceHandle::onValidationFailed, this, _1, _2));
+}
+
+void
+MaintenanceHandle::onRegisterFailed(const Name& prefix, const std::string& reason)
+{
+  throw Error("Maintenance prefix registration failed");
+}
+
+void
+MaintenanceHandle::onValidated(const shared_ptr<const Interest>& interest, const Name& prefix)
+{
+  RepoCommandParameter parameter;
+
+  try {
+    extractParameter(*interest, prefix, parameter);
+  }
+  catch (RepoCommandParameter::Error) {
+    negativeReply(*interest, 403);
+    return;
+  }
+
+  // an unbounded reclamation could stall the repo as long as a full VACUUM
+  if (!parameter.hasMaxPageNum() || parameter.getMaxPageNum() == 0) {
+    negativeReply(*interest, 403);
+    return;
+  }
+
+  int64_t nFreedBytes = 0;
+  try {
+    nFreedBytes = getStorageHandle().reclaimSpace(parameter.getMaxPageNum());
+  }
+  catch (std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    negativeReply(*interest, 405);
+    return;
+  }
+
+  RepoCommandResponse response;
+  if (parameter.hasProcessId())
+    response.setProcessId(parameter.getProcessId());
+  response.setStatusCode(200);
+  response.setFreedBytes(nFreedBytes);
+  reply(*interest, response);
+}
+
+void
+MaintenanceHandle::onValidationFailed(const shared_ptr<const Interest>& interest,
+                                      const std::string& reason)
+{
+  std::cerr << reason << std::endl;
+  negativeReply(*interest, 401);
+}
+
+void
+MaintenanceHandle::negativeReply(const Interest& interest, uint64_t statusCode)
+{
+  RepoCommandResponse response;
+  response.setStatusCode(statusCode);
+  reply(interest, response);
+}
+
+void
+MaintenanceHandle::startIdleReclamation(const milliseconds& interval, int64_t nPages)
+{
+  m_idleInterval = interval;
+  m_idlePages = nPages;
+  getScheduler().scheduleEvent(m_idleInterval, bind(&MaintenanceHandle::onIdleTimer, this));
+}
+
+void
+MaintenanceHandle::onIdleTimer()
+{
+  // only a short, bounded step is taken per tick so that a burst of commands
+  // arriving right after the check waits for at most m_idlePages page moves
+  ndn::time::steady_clock::Duration idleTime =
+    ndn::time::steady_clock::now() - getStorageHandle().getLastWriteTime();
+  if (idleTime >= m_idleInterval) {
+    try {
+      getStorageHandle().reclaimSpace(m_idlePages);
+    }
+    catch (std::runtime_error& e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+
+  getScheduler().scheduleEvent(m_idleInterval, bind(&MaintenanceHandle::onIdleTimer, this));
+}
+
+} // namespace repo
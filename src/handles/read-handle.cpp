@@ -21,14 +21,108 @@
 
 namespace repo {
 
+static const size_t MAX_LATENCY_SAMPLES = 65536;
+
+ReadHandle::ReadHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
+                       Scheduler& scheduler, size_t maxPrefetchDepth, size_t maxBatchSize,
+                       const ndn::time::milliseconds& batchWindow, size_t nThreads)
+  : BaseHandle(face, storageHandle, signer, scheduler)
+  , m_nLatencySamples(0)
+  , m_prefetcher(face.getIoService(), storageHandle, maxPrefetchDepth)
+  , m_coalescer(face.getIoService(), storageHandle, nThreads)
+  , m_maxBatchSize(maxBatchSize)
+  , m_batchWindow(batchWindow)
+{
+  m_latencySamples.reserve(MAX_LATENCY_SAMPLES);
+}
+
 void
 ReadHandle::onInterest(const Name& prefix, const Interest& interest)
 {
+  ndn::time::steady_clock::TimePoint arrival = ndn::time::steady_clock::now();
+
+  if (m_maxBatchSize <= 1) {
+    m_coalescer.read(interest, bind(&ReadHandle::reply, this, _1, arrival));
+    return;
+  }
+
+  if (m_pendingInterests.empty())
+    m_batchEvent = getScheduler().scheduleEvent(m_batchWindow,
+                                                bind(&ReadHandle::processBatch, this));
+  m_pendingInterests.push_back(interest);
+  m_pendingArrivals.push_back(arrival);
+
+  if (m_pendingInterests.size() >= m_maxBatchSize)
+    processBatch();
+}
+
+void
+ReadHandle::processBatch()
+{
+  getScheduler().cancelEvent(m_batchEvent);
+
+  std::vector<Interest> interests;
+  std::vector<ndn::time::steady_clock::TimePoint> arrivals;
+  interests.swap(m_pendingInterests);
+  arrivals.swap(m_pendingArrivals);
+
+  std::vector<shared_ptr<Data> > data;
+  try {
+    data = getStorageHandle().readDataBatch(interests);
+  }
+  catch (Storage::Error& e) {
+    // the Interests of the batch are left unanswered
+    std::cerr << "Reading a batch of " << interests.size() << " Interests failed: "
+              << e.what() << std::endl;
+    return;
+  }
+  for (size_t i = 0; i < data.size(); ++i)
+    reply(data[i], arrivals[i]);
+}
 
-  shared_ptr<ndn::Data> data = getStorageHandle().readData(interest);
+void
+ReadHandle::reply(const shared_ptr<Data>& data,
+                  const ndn::time::steady_clock::TimePoint& arrival)
+{
   if (data != NULL) {
       getFace().put(*data);
   }
+
+  recordLatency(ndn::time::steady_clock::now() - arrival);
+
+  if (data != NULL)
+    m_prefetcher.onRead(*data);
+}
+
+void
+ReadHandle::recordLatency(const ndn::time::steady_clock::Duration& latency)
+{
+  int64_t us = ndn::time::duration_cast<ndn::time::microseconds>(latency).count();
+  if (m_latencySamples.size() < MAX_LATENCY_SAMPLES)
+    m_latencySamples.push_back(us);
+  else
+    m_latencySamples[m_nLatencySamples % MAX_LATENCY_SAMPLES] = us;
+  ++m_nLatencySamples;
+}
+
+void
+ReadHandle::printLatencyStatistics(std::ostream& os) const
+{
+  if (m_latencySamples.empty()) {
+    os << "no samples";
+    return;
+  }
+
+  std::vector<int64_t> samples(m_latencySamples);
+  static const double QUANTILES[] = {0.5, 0.99, 0.999};
+  os << m_nLatencySamples << " reads";
+  for (size_t i = 0; i < sizeof(QUANTILES) / sizeof(QUANTILES[0]); ++i) {
+    std::vector<int64_t>::iterator nth =
+      samples.begin() + static_cast<size_t>(QUANTILES[i] * (samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    os << ", p" << QUANTILES[i] * 100 << " " << *nth << "us";
+  }
+  os << ", max " << *std::max_element(samples.begin(), samples.end()) << "us";
 }
 
 void
@@ -21,6 +21,8 @@
 #define REPO_HANDLES_READ_HANDLE_HPP
 
 #include "base-handle.hpp"
+#include "storage/read-coalescer.hpp"
+#include "storage/segment-prefetcher.hpp"
 
 
 namespace repo {
@@ -29,15 +31,43 @@ class ReadHandle : public BaseHandle
 {
 
 public:
-  ReadHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
-             Scheduler& scheduler)
-    : BaseHandle(face, storageHandle, keyChain, scheduler)
-  {
-  }
+  /**
+   * @param maxPrefetchDepth maximum number of following segments loaded into the read
+   *                         cache on a read of a segment, 0 disables prefetching
+   * @param maxBatchSize     Interests answered together, 1 answers each on arrival
+   * @param batchWindow      longest time an Interest waits for its batch to fill
+   * @param nThreads         worker threads reading Interests that are not batched,
+   *                         0 reads on the main loop
+   */
+  ReadHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
+             Scheduler& scheduler, size_t maxPrefetchDepth = 0, size_t maxBatchSize = 1,
+             const ndn::time::milliseconds& batchWindow = ndn::time::milliseconds(1),
+             size_t nThreads = 0);
 
   virtual void
   listen(const Name& prefix);
 
+  /**
+   * @brief print percentiles of recent storage read latencies
+   *
+   * Latency is measured from the arrival of an Interest until the Data is
+   * handed to the face, over the last MAX_LATENCY_SAMPLES Interests.
+   */
+  void
+  printLatencyStatistics(std::ostream& os) const;
+
+  const SegmentPrefetcher&
+  getPrefetcher() const
+  {
+    return m_prefetcher;
+  }
+
+  const ReadCoalescer&
+  getCoalescer() const
+  {
+    return m_coalescer;
+  }
+
 private:
   /**
    * @brief Read data from backend storage
@@ -45,8 +75,35 @@ private:
   void
   onInterest(const Name& prefix, const Interest& interest);
 
+  /**
+   * @brief read data for all pending Interests with one index walk and one storage fetch
+   */
+  void
+  processBatch();
+
+  /**
+   * @brief send the Data found for an Interest that arrived at @p arrival
+   */
+  void
+  reply(const shared_ptr<Data>& data, const ndn::time::steady_clock::TimePoint& arrival);
+
   void
   onRegisterFailed(const Name& prefix, const std::string& reason);
+
+  void
+  recordLatency(const ndn::time::steady_clock::Duration& latency);
+
+private:
+  std::vector<int64_t> m_latencySamples; ///< microseconds, used as a ring buffer
+  size_t m_nLatencySamples;              ///< total number of recorded samples
+  SegmentPrefetcher m_prefetcher;
+  ReadCoalescer m_coalescer;
+
+  size_t m_maxBatchSize;
+  ndn::time::milliseconds m_batchWindow;
+  std::vector<Interest> m_pendingInterests;
+  std::vector<ndn::time::steady_clock::TimePoint> m_pendingArrivals;
+  ndn::EventId m_batchEvent;  ///< answers pending Interests when the window has elapsed
 };
 
 } // namespace repo
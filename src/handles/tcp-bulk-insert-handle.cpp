@@ -18,22 +18,67 @@
  */
 
 #include "tcp-bulk-insert-handle.hpp"
+#include "bulk-insert-ack.hpp"
+#include "util/ring-buffer.hpp"
+#include "util/shared-memory-ring.hpp"
+
+#include <boost/filesystem.hpp>
+#include <set>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
 
 namespace repo {
 
 const size_t MAX_NDN_PACKET_SIZE = 8800;
 
+/**
+ * @brief receive buffer of a connection, room for a few hundred packets
+ */
+static const size_t INPUT_BUFFER_SIZE = 1048576;
+
+/**
+ * @brief limits of the queue of Data waiting to be stored in one batch
+ */
+static const size_t QUEUE_MAX_PACKETS = 1024;
+static const size_t QUEUE_MAX_BYTES = 8388608;
+
+/**
+ * @brief empty BulkInsertRing element, which tells the other side to look at the ring
+ */
+static const uint8_t RING_WAKEUP[] = {
+  tlv::BulkInsertRing, 0x00
+};
+
 namespace detail {
 
+/**
+ * @brief a bulk insert connection
+ *
+ * Everything runs on the main thread, except decodeInput(), which may run on a worker
+ * of the handle.  No input is received while it runs.
+ */
 class TcpBulkInsertClient : noncopyable
 {
 public:
   TcpBulkInsertClient(TcpBulkInsertHandle& writer,
-                      const shared_ptr<boost::asio::ip::tcp::socket>& socket)
+                      const shared_ptr<boost::asio::generic::stream_protocol::socket>& socket,
+                      uint64_t id,
+                      bool isSharedMemoryRingAllowed)
     : m_writer(writer)
     , m_socket(socket)
+    , m_id(id)
+    , m_isSharedMemoryRingAllowed(isSharedMemoryRingAllowed)
     , m_hasStarted(false)
-    , m_inputBufferSize(0)
+    , m_inputBuffer(INPUT_BUFFER_SIZE)
+    , m_isInputValid(true)
+    , m_hasDecodedAckRequest(false)
+    , m_hasFreedRingSpace(false)
+    , m_isAckRequested(false)
+    , m_isWriting(false)
+    , m_hasPendingAck(false)
+    , m_hasPendingWakeup(false)
   {
   }
 
@@ -42,33 +87,129 @@ public:
   {
     BOOST_ASSERT(!client->m_hasStarted);
 
-    client->m_socket->async_receive(
-      boost::asio::buffer(client->m_inputBuffer, MAX_NDN_PACKET_SIZE), 0,
-      bind(&TcpBulkInsertClient::handleReceive, client, _1, _2, client));
+    client->receive(client);
 
     client->m_hasStarted = true;
   }
 
+  /**
+   * @brief count the outcome of a queued element into the acknowledgement
+   * @param data the stored Data, or nullptr if the element could not be decoded
+   */
+  void
+  onInsertResult(const shared_ptr<const Data>& data, RepoStorage::InsertResult result);
+
+  /**
+   * @brief send the cumulative acknowledgement, if the connection requested it
+   */
+  void
+  sendAck(const shared_ptr<TcpBulkInsertClient>& client);
+
 private:
+  void
+  receive(const shared_ptr<TcpBulkInsertClient>& client);
+
   void
   handleReceive(const boost::system::error_code& error,
                 std::size_t nBytesReceived,
                 const shared_ptr<TcpBulkInsertClient>& client);
 
+  /**
+   * @brief decode received elements on a worker
+   */
+  void
+  processInput(const shared_ptr<TcpBulkInsertClient>& client);
+
+  /**
+   * @brief decode and hash all complete elements in the input buffer, then take
+   *        elements out of the shared memory ring, if there is one
+   *
+   * Results are left in m_decodedData, m_hasDecodedAckRequest, m_hasFreedRingSpace
+   * and m_isInputValid.
+   */
+  void
+  decodeInput();
+
+  /**
+   * @return false if the connection must be closed
+   */
+  bool
+  decodeElement(const Block& element);
+
+  void
+  decodeSharedMemoryRing();
+
+  /**
+   * @brief get the user of the process on the other side of a Unix socket
+   * @return false if the socket cannot tell
+   */
+  bool
+  getPeerUid(uid_t& uid) const;
+
+  /**
+   * @brief queue decoded Data, and continue unless the insert queue is full
+   */
+  void
+  onInputDecoded(const shared_ptr<TcpBulkInsertClient>& client);
+
+  /**
+   * @brief decode what is left in the shared memory ring, otherwise receive
+   */
+  void
+  continueInput(const shared_ptr<TcpBulkInsertClient>& client);
+
+  /**
+   * @brief write the pending acknowledgement and wakeup
+   *
+   * Only one write is in progress at a time.  An acknowledgement that is still
+   * waiting for the socket is replaced by a newer one.
+   */
+  void
+  flushOutput(const shared_ptr<TcpBulkInsertClient>& client);
+
+  void
+  handleOutputWritten(const boost::system::error_code& error,
+                      const shared_ptr<ndn::Buffer>& output,
+                      const shared_ptr<TcpBulkInsertClient>& client);
+
+  void
+  close();
+
 private:
   TcpBulkInsertHandle& m_writer;
-  shared_ptr<boost::asio::ip::tcp::socket> m_socket;
+  shared_ptr<boost::asio::generic::stream_protocol::socket> m_socket;
+  uint64_t m_id;
+  bool m_isSharedMemoryRingAllowed;
   bool m_hasStarted;
-  uint8_t m_inputBuffer[MAX_NDN_PACKET_SIZE];
-  std::size_t m_inputBufferSize;
+  RingBuffer m_inputBuffer;
+  shared_ptr<SharedMemoryRing> m_sharedMemoryRing;
+
+  // output of decodeInput()
+  std::vector<shared_ptr<const Data> > m_decodedData;
+  bool m_isInputValid;
+  bool m_hasDecodedAckRequest;
+  bool m_hasFreedRingSpace;
+
+  bool m_isAckRequested;
+  bool m_isWriting;
+  bool m_hasPendingAck;
+  bool m_hasPendingWakeup;
+  BulkInsertAck m_ack;
 };
 
 } // namespace detail
 
 TcpBulkInsertHandle::TcpBulkInsertHandle(boost::asio::io_service& ioService,
-                                         RepoStorage& storageHandle)
+                                         RepoStorage& storageHandle,
+                                         size_t nThreads)
   : m_acceptor(ioService)
+  , m_localAcceptor(ioService)
+  , m_isSharedMemoryRingAllowed(false)
   , m_storageHandle(storageHandle)
+  , m_workerPool(ioService, nThreads)
+  , m_lastClientId(0)
+  , m_nQueuedBytes(0)
+  , m_isFlushScheduled(false)
 {
 }
 
@@ -98,44 +239,181 @@ TcpBulkInsertHandle::listen(const std::string& host, const std::string& port)
   m_acceptor.bind(m_localEndpoint);
   m_acceptor.listen(255);
 
-  shared_ptr<ip::tcp::socket> clientSocket =
-    make_shared<ip::tcp::socket>(boost::ref(m_acceptor.get_io_service()));
+  acceptTcp();
+}
+
+void
+TcpBulkInsertHandle::listenLocal(const std::string& path, bool isSharedMemoryRingAllowed)
+{
+  using namespace boost::asio;
+
+  // a socket file left by a previous run would make bind() fail
+  boost::system::error_code error;
+  if (boost::filesystem::status(path, error).type() == boost::filesystem::socket_file)
+    boost::filesystem::remove(path, error);
+
+  m_localPath = path;
+  m_isSharedMemoryRingAllowed = isSharedMemoryRingAllowed;
+  std::cerr << "Start listening on " << m_localPath
+            << (m_isSharedMemoryRingAllowed ? " (shared memory ring allowed)" : "") << std::endl;
+
+  local::stream_protocol::endpoint endpoint(m_localPath);
+  m_localAcceptor.open(endpoint.protocol());
+  m_localAcceptor.bind(endpoint);
+  m_localAcceptor.listen(255);
+
+  acceptLocal();
+}
+
+void
+TcpBulkInsertHandle::stop()
+{
+  boost::system::error_code error;
+  m_acceptor.cancel(error);
+  m_acceptor.close(error);
+
+  if (m_localAcceptor.is_open()) {
+    m_localAcceptor.cancel(error);
+    m_localAcceptor.close(error);
+    boost::filesystem::remove(m_localPath, error);
+  }
+
+  flushQueue();
+}
+
+void
+TcpBulkInsertHandle::enqueue(const shared_ptr<const Data>& data,
+                             const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  m_queue.push_back(data);
+  m_queuedClients.push_back(client);
+  if (static_cast<bool>(data))
+    m_nQueuedBytes += data->wireEncode().size();
+
+  if (!m_isFlushScheduled) {
+    m_acceptor.get_io_service().post(bind(&TcpBulkInsertHandle::flushQueue, this));
+    m_isFlushScheduled = true;
+  }
+}
+
+bool
+TcpBulkInsertHandle::isQueueFull() const
+{
+  return m_queue.size() >= QUEUE_MAX_PACKETS || m_nQueuedBytes >= QUEUE_MAX_BYTES;
+}
+
+void
+TcpBulkInsertHandle::waitForQueue(const std::function<void()>& resume)
+{
+  m_waitingClients.push_back(resume);
+}
+
+void
+TcpBulkInsertHandle::flushQueue()
+{
+  m_isFlushScheduled = false;
+
+  if (!m_queue.empty()) {
+    std::vector<shared_ptr<const Data> > queue;
+    std::vector<shared_ptr<detail::TcpBulkInsertClient> > clients;
+    queue.swap(m_queue);
+    clients.swap(m_queuedClients);
+    m_nQueuedBytes = 0;
+
+    std::vector<shared_ptr<const Data> > batch;
+    batch.reserve(queue.size());
+    for (size_t i = 0; i < queue.size(); ++i) {
+      if (static_cast<bool>(queue[i]))
+        batch.push_back(queue[i]);
+    }
+
+    std::vector<RepoStorage::InsertResult> results;
+    size_t nInserted = 0;
+    try {
+      nInserted = m_storageHandle.insertDataBatch(batch, results);
+    }
+    catch (Storage::Error& error) {
+      // the transaction is rolled back, but clients still wait for their acks
+      std::cerr << "Error inserting received Data: " << error.what() << std::endl;
+      results.assign(batch.size(), RepoStorage::INSERT_FAILED);
+    }
+    if (nInserted < batch.size())
+      std::cerr << "FAILED to inject " << batch.size() - nInserted << " of " << batch.size()
+                << " received Data, which are duplicates or could not be stored" << std::endl;
+
+    std::set<shared_ptr<detail::TcpBulkInsertClient> > batchClients;
+    std::vector<RepoStorage::InsertResult>::const_iterator result = results.begin();
+    for (size_t i = 0; i < queue.size(); ++i) {
+      if (static_cast<bool>(queue[i]))
+        clients[i]->onInsertResult(queue[i], *result++);
+      else
+        clients[i]->onInsertResult(queue[i], RepoStorage::INSERT_FAILED);
+      batchClients.insert(clients[i]);
+    }
+
+    for (std::set<shared_ptr<detail::TcpBulkInsertClient> >::const_iterator it =
+           batchClients.begin(); it != batchClients.end(); ++it)
+      (*it)->sendAck(*it);
+  }
+
+  std::vector<std::function<void()> > waitingClients;
+  waitingClients.swap(m_waitingClients);
+  for (size_t i = 0; i < waitingClients.size(); ++i)
+    waitingClients[i]();
+}
+
+void
+TcpBulkInsertHandle::acceptTcp()
+{
+  shared_ptr<Socket> clientSocket = make_shared<Socket>(boost::ref(m_acceptor.get_io_service()));
   m_acceptor.async_accept(*clientSocket,
                           bind(&TcpBulkInsertHandle::handleAccept, this, _1,
-                               clientSocket));
+                               clientSocket, false));
 }
 
 void
-TcpBulkInsertHandle::stop()
+TcpBulkInsertHandle::acceptLocal()
 {
-  m_acceptor.cancel();
-  m_acceptor.close();
+  shared_ptr<Socket> clientSocket =
+    make_shared<Socket>(boost::ref(m_localAcceptor.get_io_service()));
+  m_localAcceptor.async_accept(*clientSocket,
+                               bind(&TcpBulkInsertHandle::handleAccept, this, _1,
+                                    clientSocket, true));
 }
 
 void
 TcpBulkInsertHandle::handleAccept(const boost::system::error_code& error,
-                                  const shared_ptr<boost::asio::ip::tcp::socket>& socket)
+                                  const shared_ptr<Socket>& socket,
+                                  bool isLocal)
 {
-  using namespace boost::asio;
-
   if (error) {
     // if (error == boost::system::errc::operation_canceled) // when socket is closed by someone
     //   return;
     return;
   }
 
-  std::cerr << "New connection from " << socket->remote_endpoint() << std::endl;
+  if (isLocal)
+    std::cerr << "New connection on " << m_localPath << std::endl;
+  else
+    std::cerr << "New connection on " << m_localEndpoint << std::endl;
 
   shared_ptr<detail::TcpBulkInsertClient> client =
-    make_shared<detail::TcpBulkInsertClient>(boost::ref(*this), socket);
+    make_shared<detail::TcpBulkInsertClient>(boost::ref(*this), socket, ++m_lastClientId,
+                                             isLocal && m_isSharedMemoryRingAllowed);
   detail::TcpBulkInsertClient::startReceive(client);
 
   // prepare accepting the next connection
-  shared_ptr<ip::tcp::socket> clientSocket =
-    make_shared<ip::tcp::socket>(boost::ref(m_acceptor.get_io_service()));
-  m_acceptor.async_accept(*clientSocket,
-                          bind(&TcpBulkInsertHandle::handleAccept, this, _1,
-                               clientSocket));
+  if (isLocal)
+    acceptLocal();
+  else
+    acceptTcp();
+}
+
+void
+detail::TcpBulkInsertClient::receive(const shared_ptr<TcpBulkInsertClient>& client)
+{
+  m_socket->async_receive(m_inputBuffer.prepare(), 0,
+                          bind(&TcpBulkInsertClient::handleReceive, this, _1, _2, client));
 }
 
 void
@@ -148,71 +426,289 @@ detail::TcpBulkInsertClient::handleReceive(const boost::system::error_code& erro
       if (error == boost::system::errc::operation_canceled) // when socket is closed by someone
         return;
 
-      boost::system::error_code error;
-      m_socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
-      m_socket->close(error);
+      close();
       return;
     }
 
-  m_inputBufferSize += nBytesReceived;
+  m_inputBuffer.commit(nBytesReceived);
+  processInput(client);
+}
+
+void
+detail::TcpBulkInsertClient::processInput(const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  // the client is kept alive by the completion, which runs after the work
+  m_writer.getWorkerPool().submit(m_id,
+                                  bind(&TcpBulkInsertClient::decodeInput, this),
+                                  bind(&TcpBulkInsertClient::onInputDecoded, this, client));
+}
+
+void
+detail::TcpBulkInsertClient::onInputDecoded(const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  if (m_hasDecodedAckRequest)
+    m_isAckRequested = true;
+
+  for (size_t i = 0; i < m_decodedData.size(); ++i)
+    m_writer.enqueue(m_decodedData[i], client);
+  m_decodedData.clear();
 
-  // do magic
+  if (m_hasFreedRingSpace) {
+    m_hasPendingWakeup = true;
+    flushOutput(client);
+  }
 
-  std::size_t offset = 0;
+  if (!m_isInputValid) {
+    close();
+    return;
+  }
 
-  bool isOk = true;
-  Block element;
-  while (m_inputBufferSize - offset > 0)
+  // stop reading until the storage catches up, TCP flow control (or a full shared memory
+  // ring) holds the sender back
+  if (m_writer.isQueueFull()) {
+    m_writer.waitForQueue(bind(&TcpBulkInsertClient::continueInput, this, client));
+    return;
+  }
+
+  continueInput(client);
+}
+
+void
+detail::TcpBulkInsertClient::continueInput(const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  if (static_cast<bool>(m_sharedMemoryRing) && m_sharedMemoryRing->size() > 0)
+    processInput(client);
+  else
+    receive(client);
+}
+
+void
+detail::TcpBulkInsertClient::decodeInput()
+{
+  m_hasDecodedAckRequest = false;
+  m_hasFreedRingSpace = false;
+  m_isInputValid = true;
+
+  while (m_inputBuffer.size() > 0)
     {
-      isOk = Block::fromBuffer(m_inputBuffer + offset, m_inputBufferSize - offset, element);
-      if (!isOk)
+      size_t headerSize = 0;
+      uint64_t type = 0;
+      uint64_t length = 0;
+      if (!m_inputBuffer.readVarNumber(headerSize, type) ||
+          !m_inputBuffer.readVarNumber(headerSize, length))
+        break;
+
+      if (length > MAX_NDN_PACKET_SIZE || headerSize + length > MAX_NDN_PACKET_SIZE) {
+        m_isInputValid = false;
+        return;
+      }
+
+      size_t elementSize = headerSize + static_cast<size_t>(length);
+      if (m_inputBuffer.size() < elementSize)
         break;
 
-      offset += element.size();
-      BOOST_ASSERT(offset <= m_inputBufferSize);
-
-      if (element.type() == ndn::tlv::Data)
-        {
-          try {
-            Data data(element);
-            bool isOk = m_writer.getStorageHandle().insertData(data);
-            if (isOk)
-              std::cerr << "Successfully injected " << data.getName() << std::endl;
-            else
-              std::cerr << "FAILED to inject " << data.getName() << std::endl;
-          }
-          catch (std::runtime_error& error) {
-            /// \todo Catch specific error after determining what wireDecode() can throw
-            std::cerr << "Error decoding received Data packet" << std::endl;
-          }
-        }
+      // Index keeps Names that share the wire of their Data, so every Data gets its own
+      // copy instead of pointing into the ring
+      shared_ptr<ndn::Buffer> wire = make_shared<ndn::Buffer>(elementSize);
+      m_inputBuffer.copy(0, elementSize, wire->buf());
+      m_inputBuffer.consume(elementSize);
+
+      if (!decodeElement(Block(wire))) {
+        m_isInputValid = false;
+        return;
+      }
+    }
+
+  if (static_cast<bool>(m_sharedMemoryRing))
+    decodeSharedMemoryRing();
+}
+
+bool
+detail::TcpBulkInsertClient::decodeElement(const Block& element)
+{
+  if (element.type() == ndn::tlv::Data)
+    {
+      shared_ptr<Data> data;
+      try {
+        data = make_shared<Data>(element);
+        // the implicit digest is cached by the Data, so that Index does not compute
+        // it on the main thread
+        data->getFullName();
+      }
+      catch (std::runtime_error& error) {
+        /// \todo Catch specific error after determining what wireDecode() can throw
+        std::cerr << "Error decoding received Data packet" << std::endl;
+        data.reset();
+      }
+      // an undecodable Data is queued as well, so that it is acknowledged in order
+      m_decodedData.push_back(data);
     }
-  if (!isOk && m_inputBufferSize == MAX_NDN_PACKET_SIZE && offset == 0)
+  else if (element.type() == tlv::BulkInsertAckRequest)
     {
-      boost::system::error_code error;
-      m_socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
-      m_socket->close(error);
-      return;
+      m_hasDecodedAckRequest = true;
     }
+  else if (element.type() == tlv::BulkInsertRing && element.value_size() > 0)
+    {
+      // an empty element is a wakeup, the ring is drained after the input
+      if (!m_isSharedMemoryRingAllowed || static_cast<bool>(m_sharedMemoryRing)) {
+        std::cerr << "Shared memory ring is not allowed on this connection" << std::endl;
+        return false;
+      }
+
+      // the ring is mapped only if the producer could write to the file anyway
+      uid_t peerUid;
+      if (!getPeerUid(peerUid)) {
+        std::cerr << "Cannot get the credentials of the shared memory ring producer" << std::endl;
+        return false;
+      }
+
+      std::string path(reinterpret_cast<const char*>(element.value()), element.value_size());
+      try {
+        m_sharedMemoryRing = make_shared<SharedMemoryRing>(path,
+                                                           SharedMemoryRing::Owner(peerUid));
+      }
+      catch (SharedMemoryRing::Error& error) {
+        std::cerr << error.what() << std::endl;
+        return false;
+      }
+    }
+  return true;
+}
 
-  if (offset > 0)
+bool
+detail::TcpBulkInsertClient::getPeerUid(uid_t& uid) const
+{
+#ifdef SO_PEERCRED
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+  if (::getsockopt(m_socket->native_handle(), SOL_SOCKET, SO_PEERCRED,
+                   &credentials, &length) != 0)
+    return false;
+  uid = credentials.uid;
+  return true;
+#else
+  gid_t gid;
+  return ::getpeereid(m_socket->native_handle(), &uid, &gid) == 0;
+#endif // SO_PEERCRED
+}
+
+void
+detail::TcpBulkInsertClient::decodeSharedMemoryRing()
+{
+  size_t nBytes = 0;
+  const uint8_t* element = nullptr;
+  size_t elementSize = 0;
+  try {
+    // at most as much as one receive, so that the queue limits still hold
+    while (nBytes < INPUT_BUFFER_SIZE && m_sharedMemoryRing->front(element, elementSize)) {
+      if (elementSize > MAX_NDN_PACKET_SIZE) {
+        m_isInputValid = false;
+        break;
+      }
+
+      // the only copy of the element; Index keeps Names that share the wire of their
+      // Data, so the Data cannot point into the ring
+      shared_ptr<ndn::Buffer> wire = make_shared<ndn::Buffer>(element, elementSize);
+      m_sharedMemoryRing->pop(elementSize);
+      nBytes += elementSize;
+
+      if (!decodeElement(Block(wire))) {
+        m_isInputValid = false;
+        break;
+      }
+    }
+  }
+  catch (SharedMemoryRing::Error& error) {
+    std::cerr << error.what() << std::endl;
+    m_isInputValid = false;
+  }
+
+  m_hasFreedRingSpace = nBytes > 0;
+}
+
+void
+detail::TcpBulkInsertClient::onInsertResult(const shared_ptr<const Data>& data,
+                                            RepoStorage::InsertResult result)
+{
+  switch (result) {
+  case RepoStorage::INSERT_OK:
+    m_ack.setInsertNum(m_ack.getInsertNum() + 1);
+    break;
+  case RepoStorage::INSERT_DUPLICATE:
+    m_ack.setDuplicateNum(m_ack.getDuplicateNum() + 1);
+    break;
+  case RepoStorage::INSERT_FULL:
+    m_ack.setFailedNum(m_ack.getFailedNum() + 1);
+    m_ack.setStatusCode(507);
+    break;
+  case RepoStorage::INSERT_FAILED:
+    m_ack.setFailedNum(m_ack.getFailedNum() + 1);
+    m_ack.setStatusCode(static_cast<bool>(data) ? 500 : 400);
+    break;
+  }
+
+  if (static_cast<bool>(data))
+    m_ack.setLastName(data->getName());
+}
+
+void
+detail::TcpBulkInsertClient::sendAck(const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  if (!m_isAckRequested)
+    return;
+
+  m_hasPendingAck = true;
+  flushOutput(client);
+}
+
+void
+detail::TcpBulkInsertClient::flushOutput(const shared_ptr<detail::TcpBulkInsertClient>& client)
+{
+  if (m_isWriting || !m_socket->is_open() || !(m_hasPendingAck || m_hasPendingWakeup))
+    return;
+
+  shared_ptr<ndn::Buffer> output = make_shared<ndn::Buffer>();
+  if (m_hasPendingAck) {
+    const Block& ack = m_ack.wireEncode();
+    output->insert(output->end(), ack.begin(), ack.end());
+  }
+  if (m_hasPendingWakeup)
+    output->insert(output->end(), RING_WAKEUP, RING_WAKEUP + sizeof(RING_WAKEUP));
+
+  m_isWriting = true;
+  m_hasPendingAck = false;
+  m_hasPendingWakeup = false;
+
+  boost::asio::async_write(*m_socket, boost::asio::buffer(output->buf(), output->size()),
+                           bind(&TcpBulkInsertClient::handleOutputWritten, this, _1,
+                                output, client));
+}
+
+void
+detail::TcpBulkInsertClient::handleOutputWritten(const boost::system::error_code& error,
+                                                 const shared_ptr<ndn::Buffer>& output,
+                                                 const shared_ptr<TcpBulkInsertClient>& client)
+{
+  m_isWriting = false;
+
+  if (error)
     {
-      if (offset != m_inputBufferSize)
-        {
-          std::copy(m_inputBuffer + offset, m_inputBuffer + m_inputBufferSize,
-                    m_inputBuffer);
-          m_inputBufferSize -= offset;
-        }
-      else
-        {
-          m_inputBufferSize = 0;
-        }
+      if (error == boost::system::errc::operation_canceled) // when socket is closed by someone
+        return;
+
+      close();
+      return;
     }
 
-  m_socket->async_receive(boost::asio::buffer(m_inputBuffer + m_inputBufferSize,
-                                              MAX_NDN_PACKET_SIZE - m_inputBufferSize), 0,
-                          bind(&TcpBulkInsertClient::handleReceive, this, _1, _2, client));
+  flushOutput(client);
 }
 
+void
+detail::TcpBulkInsertClient::close()
+{
+  boost::system::error_code error;
+  m_socket->shutdown(boost::asio::socket_base::shutdown_both, error);
+  m_socket->close(error);
+}
 
 } // namespace repo
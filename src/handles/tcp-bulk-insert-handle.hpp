@@ -22,11 +22,39 @@
 
 #include "common.hpp"
 #include "storage/repo-storage.hpp"
+#include "util/worker-pool.hpp"
 
 #include <boost/asio.hpp>
 
 namespace repo {
 
+namespace detail {
+class TcpBulkInsertClient;
+} // namespace detail
+
+/**
+ * @brief inserts Data packets streamed over TCP or Unix stream socket connections
+ *
+ * Each connection receives into a RingBuffer and decodes Data from it.  Decoded Data
+ * from all connections are queued and stored in batches, one batch per turn of the
+ * io_service.  While the queue is full, connections stop reading from their sockets,
+ * so TCP flow control slows the senders down to the speed of the storage.
+ *
+ * With worker threads, received input is decoded and hashed on the workers, so that
+ * several connections are decoded in parallel while the main thread only receives
+ * and stores.
+ *
+ * A connection that starts with a BulkInsertAckRequest element is acknowledged with a
+ * cumulative BulkInsertAck after every batch that contained its Data.
+ *
+ * A producer connected to the Unix socket may instead put Data into a SharedMemoryRing,
+ * if the socket allows it.  It sends a BulkInsertRing element naming the ring file, and
+ * afterwards an empty BulkInsertRing element whenever it published new Data.  The repo
+ * drains the ring when it receives one, and sends an empty BulkInsertRing element back
+ * after it freed space in the ring.  A producer may drop a wakeup when the socket has no
+ * room for it, because the repo then still has earlier wakeups to read.  The ring file
+ * must be a regular file of the producer's user, which no one else can write to.
+ */
 class TcpBulkInsertHandle : noncopyable
 {
 public:
@@ -41,12 +69,23 @@ public:
   };
 
 public:
+  /**
+   * @param nThreads number of worker threads decoding received input, 0 decodes inline
+   */
   TcpBulkInsertHandle(boost::asio::io_service& ioService,
-                      RepoStorage& storageHandle);
+                      RepoStorage& storageHandle,
+                      size_t nThreads = 0);
 
   void
   listen(const std::string& host, const std::string& port);
 
+  /**
+   * @brief listen on a Unix stream socket at @p path, replacing a stale socket file
+   * @param isSharedMemoryRingAllowed whether producers may use a SharedMemoryRing
+   */
+  void
+  listenLocal(const std::string& path, bool isSharedMemoryRingAllowed);
+
   void
   stop();
 
@@ -56,15 +95,66 @@ public:
     return m_storageHandle;
   }
 
+  WorkerPool&
+  getWorkerPool()
+  {
+    return m_workerPool;
+  }
+
+  /**
+   * @brief queue Data received by @p client for the next batch insert
+   * @param data Data to insert, or nullptr for an element that could not be decoded,
+   *             which keeps acknowledgements in the order the elements were received
+   */
+  void
+  enqueue(const shared_ptr<const Data>& data,
+          const shared_ptr<detail::TcpBulkInsertClient>& client);
+
+  bool
+  isQueueFull() const;
+
+  /**
+   * @brief call @p resume once the queue has been stored
+   */
+  void
+  waitForQueue(const std::function<void()>& resume);
+
 private:
+  /**
+   * @brief store all queued Data and resume waiting connections
+   */
+  void
+  flushQueue();
+
+private:
+  typedef boost::asio::generic::stream_protocol::socket Socket;
+
+  void
+  acceptTcp();
+
+  void
+  acceptLocal();
+
   void
   handleAccept(const boost::system::error_code& error,
-               const std::shared_ptr<boost::asio::ip::tcp::socket>& socket);
+               const std::shared_ptr<Socket>& socket,
+               bool isLocal);
 
 private:
   boost::asio::ip::tcp::acceptor m_acceptor;
   boost::asio::ip::tcp::endpoint m_localEndpoint;
+  boost::asio::local::stream_protocol::acceptor m_localAcceptor;
+  std::string m_localPath;
+  bool m_isSharedMemoryRingAllowed;
   RepoStorage& m_storageHandle;
+  WorkerPool m_workerPool;
+  uint64_t m_lastClientId;
+
+  std::vector<shared_ptr<const Data> > m_queue;
+  std::vector<shared_ptr<detail::TcpBulkInsertClient> > m_queuedClients;
+  size_t m_nQueuedBytes;
+  bool m_isFlushScheduled;
+  std::vector<std::function<void()> > m_waitingClients;
 };
 
 } // namespace repo
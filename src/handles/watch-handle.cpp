@@ -23,24 +23,33 @@ namespace repo {
 
 static const milliseconds PROCESS_DELETE_TIME(10000);
 static const milliseconds DEFAULT_INTEREST_LIFETIME(4000);
+static const uint64_t MAX_WATCH_WINDOW = 256;
+static const int MAX_SEQUENCE_RETRIES = 3;
 
-WatchHandle::WatchHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
-                         Scheduler& scheduler, ValidatorConfig& validator)
-  : BaseHandle(face, storageHandle, keyChain, scheduler)
+WatchHandle::WatchHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
+                         Scheduler& scheduler, ValidatorConfig& validator,
+                         ValidationPool& validationPool)
+  : BaseHandle(face, storageHandle, signer, scheduler)
   , m_validator(validator)
-  , m_interestNum(0)
-  , m_maxInterestNum(0)
-  , m_interestLifetime(DEFAULT_INTEREST_LIFETIME)
-  , m_watchTimeout(0)
-  , m_startTime(steady_clock::now())
-  , m_size(0)
+  , m_validationPool(validationPool)
+  , m_lastProcessId(0)
 {
 }
 
+WatchHandle::WatchProcess*
+WatchHandle::findProcess(const Name& name, uint64_t id)
+{
+  map<Name, WatchProcess>::iterator it = m_processes.find(name);
+  if (it == m_processes.end() || it->second.id != id)
+    return 0;
+  return &it->second;
+}
+
 void
-WatchHandle::deleteProcess(const Name& name)
+WatchHandle::deleteProcess(const Name& name, uint64_t id)
 {
-  m_processes.erase(name);
+  if (findProcess(name, id) != 0)
+    m_processes.erase(name);
 }
 
 // Interest.
@@ -88,13 +97,22 @@ WatchHandle::onValidated(const shared_ptr<const Interest>& interest, const Name&
 
 void WatchHandle::watchStop(const Name& name)
 {
-  m_processes[name].second = false;
-  m_maxInterestNum = 0;
-  m_interestNum = 0;
-  m_startTime = steady_clock::now();
-  m_watchTimeout = milliseconds(0);
-  m_interestLifetime = DEFAULT_INTEREST_LIFETIME;
-  m_size = 0;
+  map<Name, WatchProcess>::iterator it = m_processes.find(name);
+  if (it == m_processes.end())
+    return;
+
+  it->second.isRunning = false;
+  getScheduler().cancelEvent(it->second.timeoutEvent);
+}
+
+void
+WatchHandle::onWatchTimeout(const Name& name, uint64_t id)
+{
+  if (findProcess(name, id) == 0)
+    return;
+
+  deferredDeleteProcess(name);
+  watchStop(name);
 }
 
 void
@@ -106,28 +124,39 @@ WatchHandle::onValidationFailed(const shared_ptr<const Interest>& interest,
 }
 
 void
-WatchHandle::onData(const Interest& interest, ndn::Data& data, const Name& name)
+WatchHandle::onData(const Interest& interest, ndn::Data& data, const Name& name, uint64_t id)
 {
-  m_validator.validate(data,
-                       bind(&WatchHandle::onDataValidated, this, interest, _1, name),
-                       bind(&WatchHandle::onDataValidationFailed, this, interest, _1, _2, name));
+  // Data of one process share a key, as they share one count of inserted Data
+  m_validationPool.validate(id, data,
+                            bind(&WatchHandle::onDataValidated, this, interest, _1, name, id),
+                            bind(&WatchHandle::onDataValidationFailed, this,
+                                 interest, _1, _2, name, id));
 }
 
 void
 WatchHandle::onDataValidated(const Interest& interest, const shared_ptr<const Data>& data,
-                             const Name& name)
+                             const Name& name, uint64_t id)
 {
-  if (!m_processes[name].second) {
+  WatchProcess* process = findProcess(name, id);
+  if (process == 0 || !process->isRunning) {
+    return;
+  }
+  if (interest.getName().size() > name.size()) {
+    onSequencedData(interest, data, name, *process);
     return;
   }
   if (getStorageHandle().insertData(*data)) {
-    m_size++;
+    process->size++;
+    process->response.setInsertNum(process->size);
     if (!onRunning(name))
       return;
 
+    if (startSequencedFetch(*data, name, *process))
+      return;
+
     Interest fetchInterest(interest.getName());
     fetchInterest.setSelectors(interest.getSelectors());
-    fetchInterest.setInterestLifetime(m_interestLifetime);
+    fetchInterest.setInterestLifetime(process->interestLifetime);
     fetchInterest.setChildSelector(1);
 
     // update selectors
@@ -145,23 +174,24 @@ WatchHandle::onDataValidated(const Interest& interest, const shared_ptr<const Da
       fetchInterest.setExclude(exclude);
     }
 
-    ++m_interestNum;
-    getFace().expressInterest(fetchInterest,
-                              bind(&WatchHandle::onData, this, _1, _2, name),
-                              bind(&WatchHandle::onTimeout, this, _1, name));
+    expressFetchInterest(fetchInterest, name, *process);
   }
   else {
     throw Error("Insert into Repo Failed");
   }
-  m_processes[name].first.setInsertNum(m_size);
 }
 
 void
 WatchHandle::onDataValidationFailed(const Interest& interest, const shared_ptr<const Data>& data,
-                                    const std::string& reason, const Name& name)
+                                    const std::string& reason, const Name& name, uint64_t id)
 {
   std::cerr << reason << std::endl;
-  if (!m_processes[name].second) {
+  WatchProcess* process = findProcess(name, id);
+  if (process == 0 || !process->isRunning) {
+    return;
+  }
+  if (interest.getName().size() > name.size()) {
+    onSequencedValidationFailed(interest, name, *process);
     return;
   }
   if (!onRunning(name))
@@ -169,7 +199,7 @@ WatchHandle::onDataValidationFailed(const Interest& interest, const shared_ptr<c
 
   Interest fetchInterest(interest.getName());
   fetchInterest.setSelectors(interest.getSelectors());
-  fetchInterest.setInterestLifetime(m_interestLifetime);
+  fetchInterest.setInterestLifetime(process->interestLifetime);
   fetchInterest.setChildSelector(1);
 
   // update selectors
@@ -187,32 +217,149 @@ WatchHandle::onDataValidationFailed(const Interest& interest, const shared_ptr<c
     fetchInterest.setExclude(exclude);
   }
 
-  ++m_interestNum;
-  getFace().expressInterest(fetchInterest,
-                            bind(&WatchHandle::onData, this, _1, _2, name),
-                            bind(&WatchHandle::onTimeout, this, _1, name));
+  expressFetchInterest(fetchInterest, name, *process);
 }
 
 void
-WatchHandle::onTimeout(const ndn::Interest& interest, const Name& name)
+WatchHandle::onTimeout(const ndn::Interest& interest, const Name& name, uint64_t id)
 {
-  std::cerr << "Timeout" << std::endl;
-  if (!m_processes[name].second) {
+  WatchProcess* process = findProcess(name, id);
+  if (process == 0 || !process->isRunning) {
+    return;
+  }
+  if (interest.getName().size() > name.size()) {
+    onSequencedTimeout(interest, name, *process);
     return;
   }
+  std::cerr << "Timeout" << std::endl;
   if (!onRunning(name))
     return;
   // selectors do not need to be updated
   Interest fetchInterest(interest.getName());
   fetchInterest.setSelectors(interest.getSelectors());
-  fetchInterest.setInterestLifetime(m_interestLifetime);
+  fetchInterest.setInterestLifetime(process->interestLifetime);
   fetchInterest.setChildSelector(1);
 
-  ++m_interestNum;
+  expressFetchInterest(fetchInterest, name, *process);
+}
+
+void
+WatchHandle::expressFetchInterest(const Interest& fetchInterest, const Name& name,
+                                  WatchProcess& process)
+{
+  ++process.interestNum;
   getFace().expressInterest(fetchInterest,
-                            bind(&WatchHandle::onData, this, _1, _2, name),
-                            bind(&WatchHandle::onTimeout, this, _1, name));
+                            bind(&WatchHandle::onData, this, _1, _2, name, process.id),
+                            bind(&WatchHandle::onTimeout, this, _1, name, process.id));
+}
+
+bool
+WatchHandle::startSequencedFetch(const Data& data, const Name& name, WatchProcess& process)
+{
+  if (process.window <= 1 || data.getName().size() <= name.size())
+    return false;
 
+  const Name::Component& component = data.getName()[name.size()];
+  if (component.isSequenceNumber()) {
+    process.isSequenceMarker = true;
+    process.highestSequence = component.toSequenceNumber();
+  }
+  else if (component.isNumber()) {
+    process.isSequenceMarker = false;
+    process.highestSequence = component.toNumber();
+  }
+  else {
+    return false;
+  }
+
+  process.isSequenced = true;
+  process.nextSequence = process.highestSequence + 1;
+  fillWindow(name, process);
+  return true;
+}
+
+void
+WatchHandle::fillWindow(const Name& name, WatchProcess& process)
+{
+  while (process.nOutstanding < process.window) {
+    if (!onRunning(name))
+      return;
+
+    Name guess(name);
+    if (process.isSequenceMarker)
+      guess.appendSequenceNumber(process.nextSequence);
+    else
+      guess.appendNumber(process.nextSequence);
+    ++process.nextSequence;
+
+    Interest fetchInterest(guess);
+    fetchInterest.setInterestLifetime(process.interestLifetime);
+    ++process.nOutstanding;
+    expressFetchInterest(fetchInterest, name, process);
+  }
+}
+
+void
+WatchHandle::onSequencedData(const Interest& interest, const shared_ptr<const Data>& data,
+                             const Name& name, WatchProcess& process)
+{
+  --process.nOutstanding;
+
+  uint64_t sequence = getSequence(interest, name, process);
+  process.nRetries.erase(sequence);
+  process.highestSequence = std::max(process.highestSequence, sequence);
+
+  // a guess may be answered by Data that an earlier Interest has already brought
+  if (!getStorageHandle().hasData(*data)) {
+    if (!getStorageHandle().insertData(*data))
+      throw Error("Insert into Repo Failed");
+    process.size++;
+    process.response.setInsertNum(process.size);
+  }
+
+  fillWindow(name, process);
+}
+
+void
+WatchHandle::onSequencedTimeout(const Interest& interest, const Name& name,
+                                WatchProcess& process)
+{
+  uint64_t sequence = getSequence(interest, name, process);
+
+  // a number below the highest received may only be delayed or lost, so it is given up
+  // as skipped by the producer after a few retries; a higher one is not produced yet
+  if (sequence <= process.highestSequence &&
+      ++process.nRetries[sequence] > MAX_SEQUENCE_RETRIES) {
+    process.nRetries.erase(sequence);
+    --process.nOutstanding;
+    fillWindow(name, process);
+    return;
+  }
+
+  if (!onRunning(name)) {
+    --process.nOutstanding;
+    return;
+  }
+  Interest fetchInterest(interest.getName());
+  fetchInterest.setInterestLifetime(process.interestLifetime);
+  expressFetchInterest(fetchInterest, name, process);
+}
+
+void
+WatchHandle::onSequencedValidationFailed(const Interest& interest, const Name& name,
+                                         WatchProcess& process)
+{
+  process.nRetries.erase(getSequence(interest, name, process));
+  --process.nOutstanding;
+  fillWindow(name, process);
+}
+
+uint64_t
+WatchHandle::getSequence(const Interest& interest, const Name& name,
+                         const WatchProcess& process)
+{
+  const Name::Component& component = interest.getName()[name.size()];
+  return process.isSequenceMarker ? component.toSequenceNumber() : component.toNumber();
 }
 
 void
@@ -289,8 +436,9 @@ WatchHandle::onCheckValidated(const shared_ptr<const Interest>& interest, const
     return;
   }
 
-  RepoCommandResponse& response = m_processes[name].first;
-    if (!m_processes[name].second) {
+  WatchProcess& process = m_processes[name];
+  RepoCommandResponse& response = process.response;
+  if (!process.isRunning) {
     response.setStatusCode(101);
   }
 
@@ -309,49 +457,67 @@ WatchHandle::onCheckValidationFailed(const shared_ptr<const Interest>& interest,
 void
 WatchHandle::deferredDeleteProcess(const Name& name)
 {
-  getScheduler().scheduleEvent(PROCESS_DELETE_TIME,
-                               ndn::bind(&WatchHandle::deleteProcess, this, name));
+  WatchProcess& process = m_processes[name];
+  getScheduler().cancelEvent(process.deleteEvent);
+  process.deleteEvent =
+    getScheduler().scheduleEvent(PROCESS_DELETE_TIME,
+                                 bind(&WatchHandle::deleteProcess, this, name, process.id));
 }
 
 void
 WatchHandle::processWatchCommand(const Interest& interest,
                                  RepoCommandParameter& parameter)
 {
-  // if there is no watchTimeout specified, m_watchTimeout will be set as 0 and this handle will run forever
-  if (parameter.hasWatchTimeout()) {
-    m_watchTimeout = parameter.getWatchTimeout();
+  const Name& name = parameter.getName();
+
+  // a prefix watched anew starts over, and callbacks of the previous process are dropped
+  map<Name, WatchProcess>::iterator it = m_processes.find(name);
+  if (it != m_processes.end()) {
+    getScheduler().cancelEvent(it->second.timeoutEvent);
+    getScheduler().cancelEvent(it->second.deleteEvent);
+    m_processes.erase(it);
   }
-  else {
-    m_watchTimeout = milliseconds(0);
+
+  WatchProcess& process = m_processes[name];
+  process.id = ++m_lastProcessId;
+  process.response.setStatusCode(300);
+  process.isRunning = true;
+  process.interestLifetime = DEFAULT_INTEREST_LIFETIME;
+  process.startTime = steady_clock::now();
+
+  // if there is no watchTimeout specified, watchTimeout stays 0 and this process runs forever
+  if (parameter.hasWatchTimeout()) {
+    process.watchTimeout = parameter.getWatchTimeout();
   }
 
-  // if there is no maxInterestNum specified, m_maxInterestNum will be 0, which means infinity
+  // if there is no maxInterestNum specified, maxInterestNum will be 0, which means infinity
   if (parameter.hasMaxInterestNum()) {
-    m_maxInterestNum = parameter.getMaxInterestNum();
-  }
-  else {
-    m_maxInterestNum = 0;
+    process.maxInterestNum = parameter.getMaxInterestNum();
   }
 
   if (parameter.hasInterestLifetime()) {
-    m_interestLifetime = parameter.getInterestLifetime();
+    process.interestLifetime = parameter.getInterestLifetime();
+  }
+
+  if (parameter.hasWatchWindow() && parameter.getWatchWindow() > 1) {
+    process.window = std::min(parameter.getWatchWindow(), MAX_WATCH_WINDOW);
+  }
+
+  if (process.watchTimeout != milliseconds::zero()) {
+    process.timeoutEvent =
+      getScheduler().scheduleEvent(process.watchTimeout,
+                                   bind(&WatchHandle::onWatchTimeout, this, name, process.id));
   }
 
   reply(interest, RepoCommandResponse().setStatusCode(100));
 
-  m_processes[parameter.getName()] =
-                std::make_pair(RepoCommandResponse().setStatusCode(300), true);
-  Interest fetchInterest(parameter.getName());
+  Interest fetchInterest(name);
   if (parameter.hasSelectors()) {
     fetchInterest.setSelectors(parameter.getSelectors());
   }
   fetchInterest.setChildSelector(1);
-  fetchInterest.setInterestLifetime(m_interestLifetime);
-  m_startTime = steady_clock::now();
-  m_interestNum++;
-  getFace().expressInterest(fetchInterest,
-                            bind(&WatchHandle::onData, this, _1, _2, parameter.getName()),
-                            bind(&WatchHandle::onTimeout, this, _1, parameter.getName()));
+  fetchInterest.setInterestLifetime(process.interestLifetime);
+  expressFetchInterest(fetchInterest, name, process);
 }
 
 
@@ -366,9 +532,11 @@ WatchHandle::negativeReply(const Interest& interest, int statusCode)
 bool
 WatchHandle::onRunning(const Name& name)
 {
-  bool isTimeout = (m_watchTimeout != milliseconds::zero() &&
-                    steady_clock::now() - m_startTime > m_watchTimeout);
-  bool isMaxInterest = m_interestNum >= m_maxInterestNum && m_maxInterestNum != 0;
+  WatchProcess& process = m_processes[name];
+  bool isTimeout = (process.watchTimeout != milliseconds::zero() &&
+                    steady_clock::now() - process.startTime > process.watchTimeout);
+  bool isMaxInterest = process.interestNum >= process.maxInterestNum &&
+                       process.maxInterestNum != 0;
   if (isTimeout || isMaxInterest) {
     deferredDeleteProcess(name);
     watchStop(name);
@@ -21,6 +21,7 @@
 #define REPO_HANDLES_WATCH_HANDLE_HPP
 
 #include "base-handle.hpp"
+#include "util/validation-pool.hpp"
 
 #include <queue>
 
@@ -40,6 +41,13 @@ using namespace ndn::time;
  * watching the prefix until a command interest tell it to stop, the total
  *
  * amount of sent interests reaches a specific number or time out.
+ *
+ * A watch command with WatchWindow greater than 1 keeps that many Interests
+ * outstanding once the component following the prefix turns out to be a sequence
+ * number: each Interest guesses a following number, so their ranges are disjoint.
+ * A guess below the highest number received is retried a few times on timeout, and
+ * then taken as skipped by the producer.
+ * Data of other prefixes are still fetched one per round trip.
  */
 class WatchHandle : public BaseHandle
 {
@@ -57,12 +65,67 @@ public:
 
 
 public:
-  WatchHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
-              Scheduler& scheduler, ValidatorConfig& validator);
+  WatchHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
+              Scheduler& scheduler, ValidatorConfig& validator,
+              ValidationPool& validationPool);
 
   virtual void
   listen(const Name& prefix);
 
+private:
+  /**
+   * @brief state of watching one prefix
+   *
+   * Every watched prefix has its own limits and timers, so that any number of them can
+   * run at the same time.  Callbacks of fetching carry the id of the process that sent
+   * the Interest, and are dropped when the prefix has since been watched anew.
+   */
+  struct WatchProcess
+  {
+    WatchProcess()
+      : id(0)
+      , isRunning(false)
+      , interestNum(0)
+      , maxInterestNum(0)
+      , interestLifetime(0)
+      , watchTimeout(0)
+      , size(0)
+      , window(1)
+      , isSequenced(false)
+      , isSequenceMarker(false)
+      , nextSequence(0)
+      , highestSequence(0)
+      , nOutstanding(0)
+    {
+    }
+
+    uint64_t id;  ///< unique among processes, also the key of validated Data
+    RepoCommandResponse response;
+    bool isRunning;
+    int64_t interestNum;
+    int64_t maxInterestNum;  ///< 0 means no limit
+    milliseconds interestLifetime;
+    milliseconds watchTimeout;  ///< 0 means no timeout
+    steady_clock::TimePoint startTime;
+    int64_t size;  ///< number of inserted Data
+    ndn::EventId timeoutEvent;  ///< stops the watch when watchTimeout has elapsed
+    ndn::EventId deleteEvent;
+
+    size_t window;  ///< maximum number of outstanding sequence number guesses
+    bool isSequenced;  ///< whether Interests guess sequence numbers
+    bool isSequenceMarker;  ///< whether sequence numbers are marked, or plain numbers
+    uint64_t nextSequence;  ///< the next sequence number to request
+    uint64_t highestSequence;  ///< the highest sequence number received
+    size_t nOutstanding;  ///< outstanding sequence number guesses
+    map<uint64_t, int> nRetries;  ///< timeouts of guesses below highestSequence
+  };
+
+  /**
+   * @return the process watching @p name if its id is @p id, otherwise null
+   */
+  WatchProcess*
+  findProcess(const Name& name, uint64_t id);
+
 private: // watch-insert command
   /**
    * @brief handle watch commands
@@ -87,25 +150,63 @@ private: // data fetching
    * @brief fetch data and send next interest
    */
   void
-  onData(const Interest& interest, Data& data, const Name& name);
+  onData(const Interest& interest, Data& data, const Name& name, uint64_t id);
 
   /**
    * @brief handle when fetching one data timeout
    */
   void
-  onTimeout(const Interest& interest, const Name& name);
+  onTimeout(const Interest& interest, const Name& name, uint64_t id);
 
   void
   onDataValidated(const Interest& interest, const std::shared_ptr<const Data>& data,
-                  const Name& name);
+                  const Name& name, uint64_t id);
 
   /**
    * @brief failure of validation
    */
   void
   onDataValidationFailed(const Interest& interest, const std::shared_ptr<const Data>& data,
-                         const std::string& reason, const Name& name);
+                         const std::string& reason, const Name& name, uint64_t id);
+
+  /**
+   * @brief express the next Interest of a watch process
+   */
+  void
+  expressFetchInterest(const Interest& fetchInterest, const Name& name, WatchProcess& process);
 
+  /**
+   * @brief switch to guessing sequence numbers if @p data has one after the prefix
+   * @return whether the process guesses sequence numbers from now on
+   */
+  bool
+  startSequencedFetch(const Data& data, const Name& name, WatchProcess& process);
+
+  /**
+   * @brief express sequence number guesses until the window is full
+   */
+  void
+  fillWindow(const Name& name, WatchProcess& process);
+
+  /**
+   * @brief handle Data, timeout or failed validation of a sequence number guess
+   */
+  void
+  onSequencedData(const Interest& interest, const shared_ptr<const Data>& data,
+                  const Name& name, WatchProcess& process);
+
+  void
+  onSequencedTimeout(const Interest& interest, const Name& name, WatchProcess& process);
+
+  void
+  onSequencedValidationFailed(const Interest& interest, const Name& name,
+                              WatchProcess& process);
+
+  /**
+   * @return the sequence number that @p interest guesses
+   */
+  static uint64_t
+  getSequence(const Interest& interest, const Name& name, const WatchProcess& process);
 
   void
   processWatchCommand(const Interest& interest, RepoCommandParameter& parameter);
@@ -113,6 +214,12 @@ private: // data fetching
   void
   watchStop(const Name& name);
 
+  /**
+   * @brief stop a watch process whose watchTimeout has elapsed
+   */
+  void
+  onWatchTimeout(const Name& name, uint64_t id);
+
 private: // watch state check command
   /**
    * @brief handle watch check command
@@ -149,7 +256,7 @@ private:
   deferredDeleteProcess(const Name& name);
 
   void
-  deleteProcess(const Name& name);
+  deleteProcess(const Name& name, uint64_t id);
 
   bool
   onRunning(const Name& name);
@@ -157,14 +264,10 @@ private:
 private:
 
   ValidatorConfig& m_validator;
+  ValidationPool& m_validationPool;
 
-  map<Name, std::pair<RepoCommandResponse, bool> > m_processes;
-  int64_t m_interestNum;
-  int64_t m_maxInterestNum;
-  milliseconds m_interestLifetime;
-  milliseconds m_watchTimeout;
-  ndn::time::steady_clock::TimePoint m_startTime;
-  int64_t m_size;
+  map<Name, WatchProcess> m_processes;
+  uint64_t m_lastProcessId;
 };
 
 } // namespace repo
@@ -22,18 +22,24 @@
 namespace repo {
 
 static const int RETRY_TIMEOUT = 3;
-static const int DEFAULT_CREDIT = 12;
+static const double INITIAL_WINDOW = 4.0;
+static const double MAX_WINDOW = 1024.0;
+static const milliseconds INITIAL_RTO(1000);
+static const milliseconds MIN_RTO(200);
+static const size_t BATCH_MAX_SEGMENTS = 256;
+static const size_t BATCH_MAX_BYTES = 4 * 1024 * 1024;
+static const milliseconds BATCH_MAX_DELAY(200);
 static const milliseconds NOEND_TIMEOUT(10000);
 static const milliseconds PROCESS_DELETE_TIME(10000);
 static const milliseconds DEFAULT_INTEREST_LIFETIME(4000);
 
-WriteHandle::WriteHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
+WriteHandle::WriteHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
                          Scheduler& scheduler,// RepoStorage& storeindex,
-                         ValidatorConfig& validator)
-  : BaseHandle(face, storageHandle, keyChain, scheduler)
+                         ValidatorConfig& validator, ValidationPool& validationPool)
+  : BaseHandle(face, storageHandle, signer, scheduler)
   , m_validator(validator)
+  , m_validationPool(validationPool)
   , m_retryTime(RETRY_TIMEOUT)
-  , m_credit(DEFAULT_CREDIT)
   , m_noEndTimeout(NOEND_TIMEOUT)
   , m_interestLifetime(DEFAULT_INTEREST_LIFETIME)
 {
@@ -42,6 +48,7 @@ WriteHandle::WriteHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyCh
 void
 WriteHandle::deleteProcess(ProcessId processId)
 {
+  flushSegments(processId);
   m_processes.erase(processId);
 }
 
@@ -83,7 +90,21 @@ WriteHandle::onValidated(const std::shared_ptr<const Interest>& interest, const
     return;
   }
 
-  if (parameter.hasStartBlockId() || parameter.hasEndBlockId()) {
+  // the fetch started below must already use the requested lifetime
+  if (parameter.hasInterestLifetime())
+    m_interestLifetime = parameter.getInterestLifetime();
+
+  if (parameter.hasManifestName()) {
+    processManifestInsertCommand(*interest, parameter);
+  }
+  else if (parameter.hasObjectNames()) {
+    if (parameter.hasSelectors()) {
+      negativeReply(*interest, 402);
+      return;
+    }
+    processMultiObjectInsertCommand(*interest, parameter);
+  }
+  else if (parameter.hasStartBlockId() || parameter.hasEndBlockId()) {
     if (parameter.hasSelectors()) {
       negativeReply(*interest, 402);
       return;
@@ -93,8 +114,6 @@ WriteHandle::onValidated(const std::shared_ptr<const Interest>& interest, const
   else {
     processSingleInsertCommand(*interest, parameter);
   }
-  if (parameter.hasInterestLifetime())
-    m_interestLifetime = parameter.getInterestLifetime();
 }
 
 void
@@ -108,9 +127,9 @@ WriteHandle::onValidationFailed(const std::shared_ptr<const Interest>& interest,
 void
 WriteHandle::onData(const Interest& interest, Data& data, ProcessId processId)
 {
-  m_validator.validate(data,
-                       bind(&WriteHandle::onDataValidated, this, interest, _1, processId),
-                       bind(&WriteHandle::onDataValidationFailed, this, _1, _2));
+  m_validationPool.validate(processId, data,
+                            bind(&WriteHandle::onDataValidated, this, interest, _1, processId),
+                            bind(&WriteHandle::onDataValidationFailed, this, _1, _2));
 }
 
 void
@@ -143,46 +162,266 @@ WriteHandle::onDataValidationFailed(const std::shared_ptr<const Data>& data,
 }
 
 void
-WriteHandle::onSegmentData(const Interest& interest, Data& data, ProcessId processId)
+WriteHandle::onManifestData(const Interest& interest, Data& data, ProcessId processId)
 {
-  m_validator.validate(data,
-                       bind(&WriteHandle::onSegmentDataValidated, this, interest, _1, processId),
-                       bind(&WriteHandle::onDataValidationFailed, this, _1, _2));
+  m_validationPool.validate(processId, data,
+                            bind(&WriteHandle::onManifestValidated, this, interest, _1, processId),
+                            bind(&WriteHandle::onManifestValidationFailed, this,
+                                 _1, _2, processId));
+}
+
+void
+WriteHandle::onManifestValidated(const Interest& interest,
+                                 const std::shared_ptr<const Data>& data,
+                                 ProcessId processId)
+{
+  if (m_processes.count(processId) == 0) {
+    return;
+  }
+  ProcessInfo& process = m_processes[processId];
+  RepoCommandResponse& response = process.response;
+
+  RepoManifest manifest;
+  try {
+    manifest.wireDecode(data->getContent().blockFromValue());
+  }
+  catch (ndn::tlv::Error& e) {
+    std::cerr << "Malformed manifest: " << e.what() << std::endl;
+    response.setStatusCode(403);
+    deferredDeleteProcess(processId);
+    return;
+  }
+
+  // the manifest is already in repo when the same insert is repeated
+  if (!getStorageHandle().hasData(*data))
+    getStorageHandle().insertData(*data);
+
+  process.manifestEntries = manifest.getEntries();
+  response.setStartBlockId(0);
+  response.setEndBlockId(process.manifestEntries.size() - 1);
+
+  RepoCommandParameter parameter;
+  parameter.setStartBlockId(0);
+  parameter.setEndBlockId(process.manifestEntries.size() - 1);
+  segInit(processId, parameter, std::vector<Name>(1, data->getName()));
+}
+
+void
+WriteHandle::onManifestValidationFailed(const std::shared_ptr<const Data>& data,
+                                        const std::string& reason, ProcessId processId)
+{
+  std::cerr << reason << std::endl;
+  if (m_processes.count(processId) == 0) {
+    return;
+  }
+  m_processes[processId].response.setStatusCode(401);
+  deferredDeleteProcess(processId);
+}
+
+void
+WriteHandle::onSegmentData(const Interest& interest, Data& data, ProcessId processId,
+                           size_t object, SegmentNo segment)
+{
+  if (m_processes.count(processId) == 0) {
+    return;
+  }
+  ProcessInfo& process = m_processes[processId];
+  if (process.response.getStatusCode() != 300) {
+    // the process has completed or failed, and only waits to be deleted
+    return;
+  }
+
+  Name trustedName;
+  bool isTrusted = getTrustedName(process, segment, trustedName);
+  if (isTrusted && data.getFullName() != trustedName) {
+    // not the Data that was vouched for: it answered the Interest, so no timeout
+    // will follow, and the segment is requested again right away
+    std::cerr << "Digest mismatch: " << data.getName() << std::endl;
+    switch (process.pipeline->onInvalidData(object, segment, interest.getNonce())) {
+    case FetchPipeline::TIMEOUT_FAILED:
+      std::cerr << "Digest mismatch retry limit: " << processId << std::endl;
+      failProcess(processId, 401);
+      return;
+    case FetchPipeline::TIMEOUT_RETRY:
+      sendSegmentInterests(processId);
+      return;
+    case FetchPipeline::TIMEOUT_IGNORED:
+      // a superseded transmission of the segment
+      return;
+    }
+  }
+
+  // arrival is recorded before validation, so that validation time is not
+  // mistaken for network delay
+  if (!process.pipeline->onData(object, segment, interest.getNonce(),
+                                ndn::time::steady_clock::now())) {
+    // Data answering a superseded transmission of a segment that already arrived
+    return;
+  }
+
+  if (isTrusted) {
+    // a validated manifest or first segment vouches for this Data by its digest, but it
+    // is still stored after the segments that arrived before it
+    m_validationPool.deliver(processId, data,
+                             bind(&WriteHandle::onSegmentDataValidated, this,
+                                  interest, _1, processId, object, segment));
+    return;
+  }
+
+  m_validationPool.validate(processId, data,
+                            bind(&WriteHandle::onSegmentDataValidated, this,
+                                 interest, _1, processId, object, segment),
+                            bind(&WriteHandle::onDataValidationFailed, this, _1, _2));
 }
 
 void
 WriteHandle::onSegmentDataValidated(const Interest& interest,
                                     const std::shared_ptr<const Data>& data,
-                                    ProcessId processId)
+                                    ProcessId processId, size_t object, SegmentNo segment)
 {
   if (m_processes.count(processId) == 0) {
     return;
   }
-  RepoCommandResponse& response = m_processes[processId].response;
+  ProcessInfo& process = m_processes[processId];
+  RepoCommandResponse& response = process.response;
 
-  //refresh endBlockId
+  //refresh endBlockId, unless segments are Data listed in a manifest
   Name::Component finalBlockId = data->getFinalBlockId();
 
-  if (!finalBlockId.empty()) {
+  if (!finalBlockId.empty() && process.manifestEntries.empty()) {
     SegmentNo final = finalBlockId.toSegment();
-    if (response.hasEndBlockId()) {
-      if (final < response.getEndBlockId()) {
+    FetchPipeline& pipeline = *process.pipeline;
+    if (!pipeline.hasEndBlockId(object) || final < pipeline.getEndBlockId(object)) {
+      pipeline.setEndBlockId(object, final);
+      // only the response to a single object insert has block ids
+      if (response.hasStartBlockId())
         response.setEndBlockId(final);
-      }
-    }
-    else {
-      response.setEndBlockId(final);
     }
   }
 
-  //insert data
-  if (getStorageHandle().insertData(*data)) {
-    response.setInsertNum(response.getInsertNum() + 1);
+  if (data->getContentType() == tlv::ContentType_Manifest &&
+      process.objects.size() == 1 && response.hasStartBlockId() &&
+      segment == response.getStartBlockId()) {
+    addTrustedNames(process, *data);
   }
 
+  bufferSegment(processId, data);
+
   onSegmentDataControl(processId, interest);
 }
 
+bool
+WriteHandle::getTrustedName(const ProcessInfo& process, SegmentNo segment, Name& fullName) const
+{
+  if (!process.manifestEntries.empty()) {
+    fullName = process.manifestEntries[segment];
+    return true;
+  }
+
+  std::map<SegmentNo, Name>::const_iterator it = process.trustedNames.find(segment);
+  if (it == process.trustedNames.end())
+    return false;
+  fullName = it->second;
+  return true;
+}
+
+void
+WriteHandle::addTrustedNames(ProcessInfo& process, const Data& firstSegment)
+{
+  RepoManifest manifest;
+  try {
+    manifest.wireDecode(firstSegment.getContent().blockFromValue());
+  }
+  catch (ndn::tlv::Error& e) {
+    // later segments will be validated one by one
+    std::cerr << "Malformed manifest in first segment: " << e.what() << std::endl;
+    return;
+  }
+
+  const Name& objectName = process.objects.front();
+  const std::vector<Name>& entries = manifest.getEntries();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    // only segments of the same object can be vouched for
+    const Name& entry = entries[i];
+    if (entry.size() != objectName.size() + 2 || !objectName.isPrefixOf(entry) ||
+        !entry.get(-2).isSegment()) {
+      continue;
+    }
+    process.trustedNames[entry.get(-2).toSegment()] = entry;
+  }
+}
+
+void
+WriteHandle::bufferSegment(ProcessId processId, const std::shared_ptr<const Data>& data)
+{
+  ProcessInfo& process = m_processes[processId];
+  RepoCommandResponse& response = process.response;
+
+  if (process.pendingData.empty()) {
+    process.nPendingBytes = 0;
+    process.flushEvent =
+      getScheduler().scheduleEvent(BATCH_MAX_DELAY,
+                                   bind(&WriteHandle::flushSegments, this, processId));
+  }
+  process.pendingData.push_back(data);
+  process.nPendingBytes += data->wireEncode().size();
+
+  // the last segments are stored at once, so that the process can complete
+  uint64_t nSegments = 0;
+  bool isLastBatch = process.pipeline->getSegmentCount(nSegments) &&
+                     response.getInsertNum() + process.pendingData.size() >= nSegments;
+
+  if (process.pendingData.size() >= BATCH_MAX_SEGMENTS ||
+      process.nPendingBytes >= BATCH_MAX_BYTES ||
+      isLastBatch) {
+    flushSegments(processId);
+  }
+}
+
+void
+WriteHandle::flushSegments(ProcessId processId)
+{
+  if (m_processes.count(processId) == 0) {
+    return;
+  }
+  ProcessInfo& process = m_processes[processId];
+  if (process.pendingData.empty()) {
+    return;
+  }
+
+  getScheduler().cancelEvent(process.flushEvent);
+  std::vector<RepoStorage::InsertResult> results;
+  int failureCode = 0;
+  try {
+    getStorageHandle().insertDataBatch(process.pendingData, results);
+  }
+  catch (Storage::Error& e) {
+    std::cerr << "Storing segments of process " << processId << " failed: " << e.what()
+              << std::endl;
+    results.clear();
+    failureCode = 500;
+  }
+  process.pendingData.clear();
+  process.nPendingBytes = 0;
+
+  // a segment that is already in repo counts as stored, so that the process can complete
+  uint64_t nStored = std::count(results.begin(), results.end(), RepoStorage::INSERT_OK) +
+                     std::count(results.begin(), results.end(), RepoStorage::INSERT_DUPLICATE);
+  RepoCommandResponse& response = process.response;
+  response.setInsertNum(response.getInsertNum() + nStored);
+
+  // a segment that was not stored would keep the process from ever completing
+  if (std::count(results.begin(), results.end(), RepoStorage::INSERT_FULL) > 0)
+    failureCode = 507;
+  else if (std::count(results.begin(), results.end(), RepoStorage::INSERT_FAILED) > 0)
+    failureCode = 500;
+
+  if (failureCode != 0 && response.getStatusCode() == 300) {
+    // nothing is pending anymore, so failProcess does not come back here
+    failProcess(processId, failureCode);
+  }
+}
+
 void
 WriteHandle::onTimeout(const Interest& interest, ProcessId processId)
 {
@@ -191,11 +430,12 @@ WriteHandle::onTimeout(const Interest& interest, ProcessId processId)
 }
 
 void
-WriteHandle::onSegmentTimeout(const Interest& interest, ProcessId processId)
+WriteHandle::onSegmentTimeout(const Interest& interest, ProcessId processId, size_t object,
+                              SegmentNo segment)
 {
   std::cerr << "SegTimeout" << std::endl;
 
-  onSegmentTimeoutControl(processId, interest);
+  onSegmentTimeoutControl(processId, object, segment, interest);
 }
 
 void
@@ -216,46 +456,59 @@ WriteHandle::listen(const Name& prefix)
 }
 
 void
-WriteHandle::segInit(ProcessId processId, const RepoCommandParameter& parameter)
+WriteHandle::segInit(ProcessId processId, const RepoCommandParameter& parameter,
+                     const std::vector<Name>& objects)
 {
   ProcessInfo& process = m_processes[processId];
-  process.credit = 0;
-
-  map<SegmentNo, int>& processRetry = process.retryCounts;
-
-  Name name = parameter.getName();
-  SegmentNo startBlockId = parameter.getStartBlockId();
-
-  uint64_t initialCredit = m_credit;
+  process.objects = objects;
+  process.pipeline = make_shared<FetchPipeline>(CongestionWindow(INITIAL_WINDOW, 1.0, MAX_WINDOW),
+                                                RttEstimator(INITIAL_RTO, MIN_RTO,
+                                                             m_interestLifetime),
+                                                m_retryTime);
 
-  if (parameter.hasEndBlockId()) {
-    initialCredit =
-      std::min(initialCredit, parameter.getEndBlockId() - parameter.getStartBlockId() + 1);
+  SegmentNo startBlockId = parameter.hasStartBlockId() ? parameter.getStartBlockId() : 0;
+  for (size_t i = 0; i < objects.size(); ++i) {
+    process.pipeline->addObject(startBlockId);
+    if (parameter.hasEndBlockId())
+      process.pipeline->setEndBlockId(i, parameter.getEndBlockId());
   }
-  else {
+
+  if (!parameter.hasEndBlockId()) {
     // set noEndTimeout timer
     process.noEndTime = ndn::time::steady_clock::now() +
                         m_noEndTimeout;
   }
-  process.credit = initialCredit;
-  SegmentNo segment = startBlockId;
 
-  for (; segment < startBlockId + initialCredit; ++segment) {
-    Name fetchName = name;
-    fetchName.appendSegment(segment);
-    Interest interest(fetchName);
-    interest.setInterestLifetime(m_interestLifetime);
-    getFace().expressInterest(interest,
-                              bind(&WriteHandle::onSegmentData, this, _1, _2, processId),
-                              bind(&WriteHandle::onSegmentTimeout, this, _1, processId));
-    process.credit--;
-    processRetry[segment] = 0;
-  }
-
-  queue<SegmentNo>& nextSegmentQueue = process.nextSegmentQueue;
+  sendSegmentInterests(processId);
+}
 
-  process.nextSegment = segment;
-  nextSegmentQueue.push(segment);
+void
+WriteHandle::sendSegmentInterests(ProcessId processId)
+{
+  ProcessInfo& process = m_processes[processId];
+  FetchPipeline& pipeline = *process.pipeline;
+
+  size_t object = 0;
+  SegmentNo segment = 0;
+  while (pipeline.getNextSegment(object, segment)) {
+    Name fetchName;
+    if (!process.manifestEntries.empty()) {
+      fetchName = process.manifestEntries[segment];
+    }
+    else {
+      fetchName = process.objects[object];
+      fetchName.appendSegment(segment);
+    }
+    Interest fetchInterest(fetchName);
+    fetchInterest.setInterestLifetime(pipeline.getInterestLifetime());
+    // the nonce tells replies and timeouts of this transmission from earlier ones
+    pipeline.onSent(object, segment, fetchInterest.getNonce(), ndn::time::steady_clock::now());
+    getFace().expressInterest(fetchInterest,
+                              bind(&WriteHandle::onSegmentData, this,
+                                   _1, _2, processId, object, segment),
+                              bind(&WriteHandle::onSegmentTimeout, this,
+                                   _1, processId, object, segment));
+  }
 }
 
 void
@@ -266,22 +519,16 @@ WriteHandle::onSegmentDataControl(ProcessId processId, const Interest& interest)
   }
   ProcessInfo& process = m_processes[processId];
   RepoCommandResponse& response = process.response;
-  int& processCredit = process.credit;
-  //onSegmentDataControl is called when a data returns.
-  //When data returns, processCredit++
-  processCredit++;
-  SegmentNo& nextSegment = process.nextSegment;
-  queue<SegmentNo>& nextSegmentQueue = process.nextSegmentQueue;
-  map<SegmentNo, int>& retryCounts = process.retryCounts;
 
   //read whether notime timeout
-  if (!response.hasEndBlockId()) {
+  if (!process.pipeline->hasEndBlockId()) {
 
     ndn::time::steady_clock::TimePoint& noEndTime = process.noEndTime;
     ndn::time::steady_clock::TimePoint now = ndn::time::steady_clock::now();
 
     if (now > noEndTime) {
       std::cerr << "noEndtimeout: " << processId << std::endl;
+      flushSegments(processId);
       //m_processes.erase(processId);
       //StatusCode should be refreshed as 405
       response.setStatusCode(405);
@@ -292,9 +539,8 @@ WriteHandle::onSegmentDataControl(ProcessId processId, const Interest& interest)
   }
 
   //read whether this process has total ends, if ends, remove control info from the maps
-  if (response.hasEndBlockId()) {
-    uint64_t nSegments =
-      response.getEndBlockId() - response.getStartBlockId() + 1;
+  uint64_t nSegments = 0;
+  if (process.pipeline->getSegmentCount(nSegments)) {
     if (response.getInsertNum() >= nSegments) {
       //m_processes.erase(processId);
       //All the data has been inserted, StatusCode is refreshed as 200
@@ -304,97 +550,35 @@ WriteHandle::onSegmentDataControl(ProcessId processId, const Interest& interest)
     }
   }
 
-  //check whether there is any credit
-  if (processCredit == 0)
-    return;
-
-
-  //check whether sent queue empty
-  if (nextSegmentQueue.empty()) {
-    //do not do anything
-    return;
-  }
-
-  //pop the queue
-  SegmentNo sendingSegment = nextSegmentQueue.front();
-  nextSegmentQueue.pop();
-
-  //check whether sendingSegment exceeds
-  if (response.hasEndBlockId() && sendingSegment > response.getEndBlockId()) {
-    //do not do anything
-    return;
-  }
-
-  //read whether this is retransmitted data;
-  SegmentNo fetchedSegment =
-    interest.getName().get(interest.getName().size() - 1).toSegment();
-
-  BOOST_ASSERT(retryCounts.count(fetchedSegment) != 0);
-
-  //find this fetched data, remove it from this map
-  //rit->second.erase(oit);
-  retryCounts.erase(fetchedSegment);
-  //express the interest of the top of the queue
-  Name fetchName(interest.getName().getPrefix(-1));
-  fetchName.appendSegment(sendingSegment);
-  Interest fetchInterest(fetchName);
-  fetchInterest.setInterestLifetime(m_interestLifetime);
-  getFace().expressInterest(fetchInterest,
-                            bind(&WriteHandle::onSegmentData, this, _1, _2, processId),
-                            bind(&WriteHandle::onSegmentTimeout, this, _1, processId));
-  //When an interest is expressed, processCredit--
-  processCredit--;
-  if (retryCounts.count(sendingSegment) == 0) {
-    //not found
-    retryCounts[sendingSegment] = 0;
-  }
-  else {
-    //found
-    retryCounts[sendingSegment] = retryCounts[sendingSegment] + 1;
-  }
-  //increase the next seg and put it into the queue
-  if (!response.hasEndBlockId() || (nextSegment + 1) <= response.getEndBlockId()) {
-    nextSegment++;
-    nextSegmentQueue.push(nextSegment);
-  }
+  sendSegmentInterests(processId);
 }
 
 void
-WriteHandle::onSegmentTimeoutControl(ProcessId processId, const Interest& interest)
+WriteHandle::onSegmentTimeoutControl(ProcessId processId, size_t object, SegmentNo segment,
+                                     const Interest& interest)
 {
   if (m_processes.count(processId) == 0) {
     return;
   }
   ProcessInfo& process = m_processes[processId];
-  // RepoCommandResponse& response = process.response;
-  // SegmentNo& nextSegment = process.nextSegment;
-  // queue<SegmentNo>& nextSegmentQueue = process.nextSegmentQueue;
-  map<SegmentNo, int>& retryCounts = process.retryCounts;
-
-  SegmentNo timeoutSegment = interest.getName().get(-1).toSegment();
-
-  std::cerr << "timeoutSegment: " << timeoutSegment << std::endl;
+  if (process.response.getStatusCode() != 300) {
+    return;
+  }
 
-  BOOST_ASSERT(retryCounts.count(timeoutSegment) != 0);
+  std::cerr << "timeoutSegment: " << segment << std::endl;
 
-  //read the retry time. If retry out of time, fail the process. if not, plus
-  int& retryTime = retryCounts[timeoutSegment];
-  if (retryTime >= m_retryTime) {
-    //fail this process
+  switch (process.pipeline->onTimeout(object, segment, interest.getNonce())) {
+  case FetchPipeline::TIMEOUT_FAILED:
     std::cerr << "Retry timeout: " << processId << std::endl;
-    m_processes.erase(processId);
+    failProcess(processId, 408);
+    return;
+  case FetchPipeline::TIMEOUT_RETRY:
+    sendSegmentInterests(processId);
+    return;
+  case FetchPipeline::TIMEOUT_IGNORED:
+    // an earlier transmission of a segment that was already retransmitted or fetched
     return;
   }
-  else {
-    //Reput it in the queue, retryTime++
-    retryTime++;
-    Interest retryInterest(interest.getName());
-    retryInterest.setInterestLifetime(m_interestLifetime);
-    getFace().expressInterest(retryInterest,
-                              bind(&WriteHandle::onSegmentData, this, _1, _2, processId),
-                              bind(&WriteHandle::onSegmentTimeout, this, _1, processId));
-  }
-
 }
 
 void
@@ -435,14 +619,13 @@ WriteHandle::onCheckValidated(const shared_ptr<const Interest>& interest, const
   RepoCommandResponse& response = process.response;
 
   //Check whether it is single data fetching
-  if (!response.hasStartBlockId() &&
-      !response.hasEndBlockId()) {
+  if (!process.pipeline) {
     reply(*interest, response);
     return;
   }
 
   //read if noEndtimeout
-  if (!response.hasEndBlockId()) {
+  if (!process.pipeline->hasEndBlockId()) {
     extendNoEndTime(process);
     reply(*interest, response);
     return;
@@ -460,6 +643,14 @@ WriteHandle::onCheckValidationFailed(const shared_ptr<const Interest>& interest,
   negativeReply(*interest, 401);
 }
 
+void
+WriteHandle::failProcess(ProcessId processId, int statusCode)
+{
+  flushSegments(processId);
+  m_processes[processId].response.setStatusCode(statusCode);
+  deferredDeleteProcess(processId);
+}
+
 void
 WriteHandle::deferredDeleteProcess(ProcessId processId)
 {
@@ -525,7 +716,7 @@ WriteHandle::processSegmentedInsertCommand(const Interest& interest,
     //300 means data fetching is in progress
     response.setStatusCode(300);
 
-    segInit(processId, parameter);
+    segInit(processId, parameter, std::vector<Name>(1, parameter.getName()));
   }
   else {
     //no EndBlockId, so fetch FinalBlockId in data, if timeout, stop
@@ -541,8 +732,78 @@ WriteHandle::processSegmentedInsertCommand(const Interest& interest,
     //300 means data fetching is in progress
     response.setStatusCode(300);
 
-    segInit(processId, parameter);
+    segInit(processId, parameter, std::vector<Name>(1, parameter.getName()));
+  }
+}
+
+void
+WriteHandle::processMultiObjectInsertCommand(const Interest& interest,
+                                             RepoCommandParameter& parameter)
+{
+  // each object ends at its own FinalBlockId
+  if (parameter.hasEndBlockId()) {
+    negativeReply(interest, 403);
+    return;
+  }
+
+  ProcessId processId = generateProcessId();
+  ProcessInfo& process = m_processes[processId];
+  RepoCommandResponse& response = process.response;
+  response.setStatusCode(100);
+  response.setProcessId(processId);
+  response.setInsertNum(0);
+  reply(interest, response);
+
+  //300 means data fetching is in progress
+  response.setStatusCode(300);
+
+  segInit(processId, parameter, parameter.getObjectNames());
+}
+
+void
+WriteHandle::processManifestInsertCommand(const Interest& interest,
+                                          RepoCommandParameter& parameter)
+{
+  ProcessId processId = generateProcessId();
+  ProcessInfo& process = m_processes[processId];
+  RepoCommandResponse& response = process.response;
+  response.setStatusCode(100);
+  response.setProcessId(processId);
+  response.setInsertNum(0);
+  reply(interest, response);
+
+  //300 means data fetching is in progress
+  response.setStatusCode(300);
+
+  fetchManifest(processId, parameter.getManifestName(), 0);
+}
+
+void
+WriteHandle::fetchManifest(ProcessId processId, const Name& manifestName, int nRetries)
+{
+  Interest fetchInterest(manifestName);
+  fetchInterest.setInterestLifetime(m_interestLifetime);
+  getFace().expressInterest(fetchInterest,
+                            bind(&WriteHandle::onManifestData, this, _1, _2, processId),
+                            bind(&WriteHandle::onManifestTimeout, this, _1, processId,
+                                 nRetries));
+}
+
+void
+WriteHandle::onManifestTimeout(const Interest& interest, ProcessId processId, int nRetries)
+{
+  if (m_processes.count(processId) == 0) {
+    return;
+  }
+
+  if (nRetries < m_retryTime) {
+    std::cerr << "Manifest timeout: " << interest.getName() << std::endl;
+    fetchManifest(processId, interest.getName(), nRetries + 1);
+    return;
   }
+
+  std::cerr << "Manifest retry timeout: " << processId << std::endl;
+  failProcess(processId, 408);
 }
 
 void
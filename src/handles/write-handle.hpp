@@ -21,6 +21,9 @@
 #define REPO_HANDLES_WRITE_HANDLE_HPP
 
 #include "base-handle.hpp"
+#include "util/fetch-pipeline.hpp"
+#include "util/validation-pool.hpp"
+#include "repo-manifest.hpp"
 
 #include <ndn-cxx/security/validator-config.hpp>
 
@@ -33,15 +36,20 @@ using std::pair;
 using std::queue;
 
 /**
- * @brief WriteHandle provides basic credit based congestion control.
+ * @brief WriteHandle fetches inserted data under congestion control.
  *
- * First repo sends interests of credit number and then credit will be 0.
+ * Each segmented fetch process has its own congestion window, which starts small
+ * and doubles every round trip (slow start) until the first loss, after which it
+ * grows by one segment per round trip and is halved on every further loss (AIMD).
  *
- * If a data comes, credit++ and sends a interest then credit--.
+ * Interest lifetime is the retransmission timeout estimated from measured round
+ * trip times, bounded by the InterestLifetime of the insert command.
  *
- * If the interest timeout, repo will retry and send interest in retrytimes.
+ * A segment is retransmitted when its Interest times out, or as soon as Data of
+ * three segments requested after it have arrived (fast retransmit).
  *
- * If one interest timeout beyond retrytimes, the fetching process will terminate.
+ * If one segment is retransmitted beyond retrytimes, the fetching process fails with
+ * StatusCode 408.  The manifest of a manifest insert is requested as often.
  *
  * Another case is that if command will insert segmented data without EndBlockId.
  *
@@ -52,6 +60,23 @@ using std::queue;
  * If client sends a insert check command, the noendTimeout timer will be set to 0.
  *
  * If repo cannot get FinalBlockId in noendTimeout time, the fetching process will terminate.
+ *
+ * A multi-object insert command carries ObjectNames instead of Name.  All the objects are
+ * fetched by one process, whose segments share one congestion window, and the window is
+ * divided among the objects by taking their new segments in turn.  InsertNum counts
+ * the segments of all objects.
+ *
+ * A manifest insert command carries ManifestName.  The repo fetches and validates the
+ * manifest, and then fetches exactly the Data it lists, by their full names, as if they
+ * were the segments of one object.  Since the validated manifest vouches for their
+ * digests, those Data are checked against their full names instead of being validated
+ * one by one, and the process completes as soon as the last of them is stored.  A Data
+ * whose digest does not match is requested again, and once a segment has been retried
+ * retrytimes times, the process fails with StatusCode 401.
+ *
+ * Likewise, when the first segment of a segmented insert has ContentType Manifest and
+ * passes validation, the segments it lists by full name are only checked against
+ * their digests.  Segments it does not list are validated as usual.
  */
 class WriteHandle : public BaseHandle
 {
@@ -69,8 +94,9 @@ public:
 
 
 public:
-  WriteHandle(Face& face, RepoStorage& storageHandle, KeyChain& keyChain,
-              Scheduler& scheduler, ValidatorConfig& validator);
+  WriteHandle(Face& face, RepoStorage& storageHandle, ResponseSigner& signer,
+              Scheduler& scheduler, ValidatorConfig& validator,
+              ValidationPool& validationPool);
 
   virtual void
   listen(const Name& prefix);
@@ -78,17 +104,20 @@ public:
 private:
   /**
   * @brief Information of insert process including variables for response
-  *        and credit based flow control
+  *        and congestion control
   */
   struct ProcessInfo
   {
     //ProcessId id;
     RepoCommandResponse response;
-    queue<SegmentNo> nextSegmentQueue;  ///< queue of waiting segment
-                                        ///  to be sent when having credits
-    SegmentNo nextSegment;  ///< last segment put into the nextSegmentQueue
-    map<SegmentNo, int> retryCounts;  ///< to store retrying times of timeout segment
-    int credit;  ///< congestion control credits of process
+    std::vector<Name> objects;  ///< names of segmented objects, without segment number
+    std::vector<Name> manifestEntries;  ///< full names of Data listed in the manifest
+    std::map<SegmentNo, Name> trustedNames;  ///< full names of segments listed in the first segment
+    shared_ptr<FetchPipeline> pipeline;  ///< congestion control state of segmented fetch
+
+    std::vector<shared_ptr<const Data> > pendingData;  ///< validated segments not yet stored
+    size_t nPendingBytes;  ///< total wire size of pendingData
+    ndn::EventId flushEvent;  ///< stores pendingData when they have waited too long
 
     /**
      * @brief the latest time point at which EndBlockId must be determined
@@ -140,28 +169,74 @@ private: // single data fetching
   void
   processSingleInsertCommand(const Interest& interest, RepoCommandParameter& parameter);
 
+private: // manifest fetching
+  void
+  onManifestData(const Interest& interest, Data& data, ProcessId processId);
+
+  /**
+   * @brief store the manifest and start fetching the Data it lists
+   */
+  void
+  onManifestValidated(const Interest& interest, const std::shared_ptr<const Data>& data,
+                      ProcessId processId);
+
+  void
+  onManifestValidationFailed(const std::shared_ptr<const Data>& data, const std::string& reason,
+                             ProcessId processId);
+
+  void
+  processManifestInsertCommand(const Interest& interest, RepoCommandParameter& parameter);
+
+  /**
+   * @brief express the Interest for the manifest, which was retried @p nRetries times
+   */
+  void
+  fetchManifest(ProcessId processId, const Name& manifestName, int nRetries);
+
+  /**
+   * @brief retry the manifest up to retrytimes times, then fail the process
+   */
+  void
+  onManifestTimeout(const Interest& interest, ProcessId processId, int nRetries);
+
 private:  // segmented data fetching
   /**
    * @brief fetch segmented data
    */
   void
-  onSegmentData(const Interest& interest, Data& data, ProcessId processId);
+  onSegmentData(const Interest& interest, Data& data, ProcessId processId, size_t object,
+                SegmentNo segment);
 
   void
   onSegmentDataValidated(const Interest& interest, const std::shared_ptr<const Data>& data,
-                         ProcessId processId);
+                         ProcessId processId, size_t object, SegmentNo segment);
+
+  /**
+   * @brief get the full name a validated manifest or first segment lists for @p segment
+   * @return false if the segment is not listed, and needs to be validated
+   */
+  bool
+  getTrustedName(const ProcessInfo& process, SegmentNo segment, Name& fullName) const;
+
+  /**
+   * @brief remember the segments listed by the validated first segment of a segmented insert
+   */
+  void
+  addTrustedNames(ProcessInfo& process, const Data& firstSegment);
 
   /**
    * @brief Timeout when fetching segmented data. Data can be fetched RETRY_TIMEOUT times.
    */
   void
-  onSegmentTimeout(const Interest& interest, ProcessId processId);
+  onSegmentTimeout(const Interest& interest, ProcessId processId, size_t object,
+                   SegmentNo segment);
 
   /**
-   * @brief initiate fetching segmented data
+   * @brief initiate fetching segmented data of @p objects
    */
   void
-  segInit(ProcessId processId, const RepoCommandParameter& parameter);
+  segInit(ProcessId processId, const RepoCommandParameter& parameter,
+          const std::vector<Name>& objects);
 
   /**
    * @brief control for sending interests in function onSegmentData()
@@ -169,15 +244,44 @@ private:  // segmented data fetching
   void
   onSegmentDataControl(ProcessId processId, const Interest& interest);
 
+  /**
+   * @brief buffer a validated segment, and store the buffer if it is large enough
+   *
+   * Segments are written in batches of at most BATCH_MAX_SEGMENTS segments or
+   * BATCH_MAX_BYTES bytes, each in one transaction, and no segment waits in the
+   * buffer longer than BATCH_MAX_DELAY.
+   */
+  void
+  bufferSegment(ProcessId processId, const std::shared_ptr<const Data>& data);
+
+  /**
+   * @brief store all buffered segments of a process and count them in InsertNum
+   *
+   * The process fails with 507 if the repo is full, and with 500 if the database
+   * refused a segment, as it could not complete otherwise.
+   */
+  void
+  flushSegments(ProcessId processId);
+
+  /**
+   * @brief express Interests for as many segments as the congestion window allows
+   */
+  void
+  sendSegmentInterests(ProcessId processId);
+
   /**
    * @brief control for sending interest in function onSegmentTimeout
    */
   void
-  onSegmentTimeoutControl(ProcessId processId, const Interest& interest);
+  onSegmentTimeoutControl(ProcessId processId, size_t object, SegmentNo segment,
+                          const Interest& interest);
 
   void
   processSegmentedInsertCommand(const Interest& interest, RepoCommandParameter& parameter);
 
+  void
+  processMultiObjectInsertCommand(const Interest& interest, RepoCommandParameter& parameter);
+
 private:
   /**
    * @brief failure of validation for both one or segmented data
@@ -218,6 +322,12 @@ private:
   void
   deleteProcess(ProcessId processId);
 
+  /**
+   * @brief store what was fetched, report @p statusCode, and delete the process later
+   */
+  void
+  failProcess(ProcessId processId, int statusCode);
+
   /**
    * @brief schedule a event to delete the process
    */
@@ -230,11 +340,11 @@ private:
 private:
 
   ValidatorConfig& m_validator;
+  ValidationPool& m_validationPool;  ///< validates fetched Data, keyed by ProcessId
 
   map<ProcessId, ProcessInfo> m_processes;
 
   int m_retryTime;
-  int m_credit;
   ndn::time::milliseconds m_noEndTimeout;
   ndn::time::milliseconds m_interestLifetime;
 };
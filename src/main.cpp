@@ -89,6 +89,8 @@ main(int argc, char** argv)
     repoInstance.enableListening();
 
     ioService.run();
+
+    repoInstance.printStatistics(std::cerr);
   }
   catch (const std::exception& e) {
     std::cerr << "ERROR: " << e.what() << std::endl;
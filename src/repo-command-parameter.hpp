@@ -26,6 +26,8 @@
 #include <ndn-cxx/selectors.hpp>
 #include "repo-tlv.hpp"
 
+#include <vector>
+
 namespace repo {
 
 using ndn::Name;
@@ -62,6 +64,9 @@ public:
     , m_hasMaxInterestNum(false)
     , m_hasWatchTimeout(false)
     , m_hasInterestLifetime(false)
+    , m_hasMaxPageNum(false)
+    , m_hasWatchWindow(false)
+    , m_hasManifestName(false)
   {
   }
 
@@ -244,6 +249,109 @@ public:
     return m_hasInterestLifetime;
   }
 
+  uint64_t
+  getMaxPageNum() const
+  {
+    assert(hasMaxPageNum());
+    return m_maxPageNum;
+  }
+
+  RepoCommandParameter&
+  setMaxPageNum(uint64_t maxPageNum)
+  {
+    m_maxPageNum = maxPageNum;
+    m_hasMaxPageNum = true;
+    m_wire.reset();
+    return *this;
+  }
+
+  bool
+  hasMaxPageNum() const
+  {
+    return m_hasMaxPageNum;
+  }
+
+  /**
+   * @brief get how many Interests a watch process may keep outstanding
+   */
+  uint64_t
+  getWatchWindow() const
+  {
+    assert(hasWatchWindow());
+    return m_watchWindow;
+  }
+
+  RepoCommandParameter&
+  setWatchWindow(uint64_t watchWindow)
+  {
+    m_watchWindow = watchWindow;
+    m_hasWatchWindow = true;
+    m_wire.reset();
+    return *this;
+  }
+
+  bool
+  hasWatchWindow() const
+  {
+    return m_hasWatchWindow;
+  }
+
+  /**
+   * @brief get names of the segmented objects inserted by a multi-object insert command
+   */
+  const std::vector<Name>&
+  getObjectNames() const
+  {
+    return m_objectNames;
+  }
+
+  RepoCommandParameter&
+  setObjectNames(const std::vector<Name>& objectNames)
+  {
+    m_objectNames = objectNames;
+    m_wire.reset();
+    return *this;
+  }
+
+  RepoCommandParameter&
+  addObjectName(const Name& objectName)
+  {
+    m_objectNames.push_back(objectName);
+    m_wire.reset();
+    return *this;
+  }
+
+  bool
+  hasObjectNames() const
+  {
+    return !m_objectNames.empty();
+  }
+
+  /**
+   * @brief get name of the manifest listing the Data inserted by a manifest insert command
+   */
+  const Name&
+  getManifestName() const
+  {
+    assert(hasManifestName());
+    return m_manifestName;
+  }
+
+  RepoCommandParameter&
+  setManifestName(const Name& manifestName)
+  {
+    m_manifestName = manifestName;
+    m_hasManifestName = true;
+    m_wire.reset();
+    return *this;
+  }
+
+  bool
+  hasManifestName() const
+  {
+    return m_hasManifestName;
+  }
+
   template<bool T>
   size_t
   wireEncode(EncodingImpl<T>& block) const;
@@ -264,6 +372,10 @@ private:
   uint64_t m_maxInterestNum;
   milliseconds m_watchTimeout;
   milliseconds m_interestLifetime;
+  uint64_t m_maxPageNum;
+  uint64_t m_watchWindow;
+  std::vector<Name> m_objectNames;
+  Name m_manifestName;
 
   bool m_hasName;
   bool m_hasStartBlockId;
@@ -272,6 +384,9 @@ private:
   bool m_hasMaxInterestNum;
   bool m_hasWatchTimeout;
   bool m_hasInterestLifetime;
+  bool m_hasMaxPageNum;
+  bool m_hasWatchWindow;
+  bool m_hasManifestName;
 
   mutable Block m_wire;
 };
@@ -283,6 +398,38 @@ RepoCommandParameter::wireEncode(EncodingImpl<T>& encoder) const
   size_t totalLength = 0;
   size_t variableLength = 0;
 
+  if (m_hasManifestName) {
+    variableLength = m_manifestName.wireEncode(encoder);
+    totalLength += variableLength;
+    totalLength += encoder.prependVarNumber(variableLength);
+    totalLength += encoder.prependVarNumber(tlv::ManifestName);
+  }
+
+  if (!m_objectNames.empty()) {
+    variableLength = 0;
+    for (std::vector<Name>::const_reverse_iterator it = m_objectNames.rbegin();
+         it != m_objectNames.rend(); ++it) {
+      variableLength += it->wireEncode(encoder);
+    }
+    totalLength += variableLength;
+    totalLength += encoder.prependVarNumber(variableLength);
+    totalLength += encoder.prependVarNumber(tlv::ObjectNames);
+  }
+
+  if (m_hasWatchWindow) {
+    variableLength = encoder.prependNonNegativeInteger(m_watchWindow);
+    totalLength += variableLength;
+    totalLength += encoder.prependVarNumber(variableLength);
+    totalLength += encoder.prependVarNumber(tlv::WatchWindow);
+  }
+
+  if (m_hasMaxPageNum) {
+    variableLength = encoder.prependNonNegativeInteger(m_maxPageNum);
+    totalLength += variableLength;
+    totalLength += encoder.prependVarNumber(variableLength);
+    totalLength += encoder.prependVarNumber(tlv::MaxPageNum);
+  }
+
   if (m_hasProcessId) {
     variableLength = encoder.prependNonNegativeInteger(m_processId);
     totalLength += variableLength;
@@ -364,6 +511,10 @@ RepoCommandParameter::wireDecode(const Block& wire)
   m_hasMaxInterestNum = false;
   m_hasWatchTimeout = false;
   m_hasInterestLifetime = false;
+  m_hasMaxPageNum = false;
+  m_hasWatchWindow = false;
+  m_objectNames.clear();
+  m_hasManifestName = false;
 
   m_wire = wire;
 
@@ -437,6 +588,45 @@ RepoCommandParameter::wireDecode(const Block& wire)
     m_interestLifetime = milliseconds(readNonNegativeInteger(*val));
   }
 
+  // MaxPageNum
+  val = m_wire.find(tlv::MaxPageNum);
+  if (val != m_wire.elements_end())
+  {
+    m_hasMaxPageNum = true;
+    m_maxPageNum = readNonNegativeInteger(*val);
+  }
+
+  // WatchWindow
+  val = m_wire.find(tlv::WatchWindow);
+  if (val != m_wire.elements_end())
+  {
+    m_hasWatchWindow = true;
+    m_watchWindow = readNonNegativeInteger(*val);
+  }
+
+  // ObjectNames
+  val = m_wire.find(tlv::ObjectNames);
+  if (val != m_wire.elements_end())
+  {
+    val->parse();
+    for (Block::element_const_iterator it = val->elements_begin();
+         it != val->elements_end(); ++it) {
+      if (it->type() != tlv::Name)
+        throw Error("ObjectNames must contain only Name elements");
+      m_objectNames.push_back(Name(*it));
+    }
+  }
+
+  // ManifestName
+  val = m_wire.find(tlv::ManifestName);
+  if (val != m_wire.elements_end())
+  {
+    val->parse();
+    if (val->elements_size() != 1 || val->elements_begin()->type() != tlv::Name)
+      throw Error("ManifestName must contain one Name element");
+    m_hasManifestName = true;
+    m_manifestName.wireDecode(*val->elements_begin());
+  }
 
 }
 
@@ -473,6 +663,24 @@ operator<<(std::ostream& os, const RepoCommandParameter& repoCommandParameter)
   if (repoCommandParameter.hasProcessId()) {
     os << " InterestLifetime: " << repoCommandParameter.getInterestLifetime();
   }
+  // MaxPageNum
+  if (repoCommandParameter.hasMaxPageNum()) {
+    os << " MaxPageNum: " << repoCommandParameter.getMaxPageNum();
+  }
+  // WatchWindow
+  if (repoCommandParameter.hasWatchWindow()) {
+    os << " WatchWindow: " << repoCommandParameter.getWatchWindow();
+  }
+  // ObjectNames
+  if (repoCommandParameter.hasObjectNames()) {
+    os << " ObjectNames:";
+    for (size_t i = 0; i < repoCommandParameter.getObjectNames().size(); ++i)
+      os << " " << repoCommandParameter.getObjectNames()[i];
+  }
+  // ManifestName
+  if (repoCommandParameter.hasManifestName()) {
+    os << " ManifestName: " << repoCommandParameter.getManifestName();
+  }
   os << " )";
   return os;
 }
@@ -57,6 +57,7 @@ public:
     , m_hasInsertNum(false)
     , m_hasDeleteNum(false)
     , m_hasStatusCode(false)
+    , m_hasFreedBytes(false)
   {
   }
 
@@ -194,6 +195,27 @@ public:
     return m_hasDeleteNum;
   }
 
+  uint64_t
+  getFreedBytes() const
+  {
+    return m_freedBytes;
+  }
+
+  RepoCommandResponse&
+  setFreedBytes(uint64_t freedBytes)
+  {
+    m_freedBytes = freedBytes;
+    m_hasFreedBytes = true;
+    m_wire.reset();
+    return *this;
+  }
+
+  bool
+  hasFreedBytes() const
+  {
+    return m_hasFreedBytes;
+  }
+
   template<bool T>
   size_t
   wireEncode(EncodingImpl<T>& block) const;
@@ -211,6 +233,7 @@ private:
   uint64_t m_processId;
   uint64_t m_insertNum;
   uint64_t m_deleteNum;
+  uint64_t m_freedBytes;
 
   bool m_hasStartBlockId;
   bool m_hasEndBlockId;
@@ -218,6 +241,7 @@ private:
   bool m_hasInsertNum;
   bool m_hasDeleteNum;
   bool m_hasStatusCode;
+  bool m_hasFreedBytes;
 
   mutable Block m_wire;
 };
@@ -229,6 +253,13 @@ RepoCommandResponse::wireEncode(EncodingImpl<T>& encoder) const
   size_t totalLength = 0;
   size_t variableLength = 0;
 
+  if (m_hasFreedBytes) {
+    variableLength = encoder.prependNonNegativeInteger(m_freedBytes);
+    totalLength += variableLength;
+    totalLength += encoder.prependVarNumber(variableLength);
+    totalLength += encoder.prependVarNumber(tlv::FreedBytes);
+  }
+
   if (m_hasDeleteNum) {
     variableLength = encoder.prependNonNegativeInteger(m_deleteNum);
     totalLength += variableLength;
@@ -303,6 +334,7 @@ RepoCommandResponse::wireDecode(const Block& wire)
   m_hasStatusCode = false;
   m_hasInsertNum = false;
   m_hasDeleteNum = false;
+  m_hasFreedBytes = false;
 
   m_wire = wire;
 
@@ -363,6 +395,14 @@ RepoCommandResponse::wireDecode(const Block& wire)
     m_hasDeleteNum = true;
     m_deleteNum = readNonNegativeInteger(*val);
   }
+
+  // FreedBytes
+  val = m_wire.find(tlv::FreedBytes);
+  if (val != m_wire.elements_end())
+  {
+    m_hasFreedBytes = true;
+    m_freedBytes = readNonNegativeInteger(*val);
+  }
 }
 
 inline std::ostream&
@@ -389,6 +429,9 @@ operator<<(std::ostream& os, const RepoCommandResponse& repoCommandResponse)
     os << " DeleteNum: " << repoCommandResponse.getDeleteNum();
 
   }
+  if (repoCommandResponse.hasFreedBytes()) {
+    os << " FreedBytes: " << repoCommandResponse.getFreedBytes();
+  }
   os << " )";
   return os;
 }
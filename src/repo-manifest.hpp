@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_REPO_MANIFEST_HPP
+#define REPO_REPO_MANIFEST_HPP
+
+#include <ndn-cxx/encoding/block.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/name.hpp>
+#include "repo-tlv.hpp"
+
+#include <vector>
+
+namespace repo {
+
+using ndn::Name;
+using ndn::Block;
+using ndn::EncodingImpl;
+using ndn::EncodingEstimator;
+using ndn::EncodingBuffer;
+
+/**
+ * @brief Content of a manifest Data, which lists the Data to be inserted
+ *
+ * Every entry is the full name of a Data, whose last component is its implicit
+ * SHA-256 digest.  Once the manifest itself is validated, a listed Data is
+ * authenticated by comparing its full name with the entry.
+ *
+ *     Manifest ::= MANIFEST-TYPE TLV-LENGTH
+ *                    Name+
+ */
+class RepoManifest
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : ndn::tlv::Error(what)
+    {
+    }
+  };
+
+  RepoManifest()
+  {
+  }
+
+  explicit
+  RepoManifest(const Block& block)
+  {
+    wireDecode(block);
+  }
+
+  const std::vector<Name>&
+  getEntries() const
+  {
+    return m_entries;
+  }
+
+  /**
+   * @brief append the full name of a Data
+   * @throw Error @p fullName does not end with an implicit SHA-256 digest
+   */
+  RepoManifest&
+  addEntry(const Name& fullName)
+  {
+    if (fullName.empty() || !fullName.get(-1).isImplicitSha256Digest())
+      throw Error("Manifest entry must end with an implicit SHA-256 digest");
+
+    m_entries.push_back(fullName);
+    m_wire.reset();
+    return *this;
+  }
+
+  template<bool T>
+  size_t
+  wireEncode(EncodingImpl<T>& block) const;
+
+  const Block&
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+private:
+  std::vector<Name> m_entries;
+
+  mutable Block m_wire;
+};
+
+template<bool T>
+inline size_t
+RepoManifest::wireEncode(EncodingImpl<T>& encoder) const
+{
+  size_t totalLength = 0;
+
+  for (std::vector<Name>::const_reverse_iterator it = m_entries.rbegin();
+       it != m_entries.rend(); ++it) {
+    totalLength += it->wireEncode(encoder);
+  }
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(tlv::Manifest);
+  return totalLength;
+}
+
+inline const Block&
+RepoManifest::wireEncode() const
+{
+  if (m_wire.hasWire())
+    return m_wire;
+
+  EncodingEstimator estimator;
+  size_t estimatedSize = wireEncode(estimator);
+
+  EncodingBuffer buffer(estimatedSize, 0);
+  wireEncode(buffer);
+
+  m_wire = buffer.block();
+  return m_wire;
+}
+
+inline void
+RepoManifest::wireDecode(const Block& wire)
+{
+  m_entries.clear();
+
+  m_wire = wire;
+
+  m_wire.parse();
+
+  if (m_wire.type() != tlv::Manifest)
+    throw Error("Requested decoding of RepoManifest, but Block is of different type");
+
+  for (Block::element_const_iterator it = m_wire.elements_begin();
+       it != m_wire.elements_end(); ++it) {
+    if (it->type() != tlv::Name)
+      throw Error("Manifest must contain only Name elements");
+
+    Name entry(*it);
+    if (entry.empty() || !entry.get(-1).isImplicitSha256Digest())
+      throw Error("Manifest entry must end with an implicit SHA-256 digest");
+    m_entries.push_back(entry);
+  }
+
+  if (m_entries.empty())
+    throw Error("Manifest must list at least one Data");
+}
+
+} // namespace repo
+
+#endif // REPO_REPO_MANIFEST_HPP
@@ -37,7 +37,27 @@ enum {
   InsertNum            = 209,
   DeleteNum            = 210,
   MaxInterestNum       = 211,
-  WatchTimeout         = 212
+  WatchTimeout         = 212,
+  MaxPageNum           = 213,
+  FreedBytes           = 214,
+  ObjectNames          = 215,
+  ManifestName         = 216,
+  Manifest             = 217,
+  WatchWindow          = 218,
+  BulkInsertAckRequest = 219,
+  BulkInsertAck        = 220,
+  DuplicateNum         = 221,
+  FailedNum            = 222,
+  BulkInsertRing       = 223
+};
+
+enum {
+  /**
+   * @brief ContentType of a Data whose Content is a Manifest
+   *
+   * The value lies in the range left for application specific types.
+   */
+  ContentType_Manifest = 1024
 };
 
 } // tlv
@@ -20,6 +20,8 @@
 #include "repo.hpp"
 #include "storage/sqlite-storage.hpp"
 
+#include <fstream>
+
 namespace repo {
 
 RepoConfig
@@ -99,6 +101,30 @@ parseConfig(const std::string& configPath)
     repoConfig.tcpBulkInsertEndpoints.push_back(std::make_pair(host, port));
   }
 
+  // local_bulk_insert {
+  //   path /var/run/repo-ng-bulk-insert.sock  ; Unix stream socket to listen on
+  //   shared-memory-ring yes  ; let producers hand over Data in a shared memory ring
+  // }
+  repoConfig.isSharedMemoryRingEnabled = false;
+  boost::optional<ptree&> localBulkInsert = repoConf.get_child_optional("local_bulk_insert");
+  if (localBulkInsert) {
+    repoConfig.localBulkInsertPath = "/var/run/repo-ng-bulk-insert.sock";
+    for (ptree::const_iterator it = localBulkInsert->begin();
+         it != localBulkInsert->end();
+         ++it)
+    {
+      if (it->first == "path") {
+        repoConfig.localBulkInsertPath = it->second.get_value<std::string>();
+      }
+      else if (it->first == "shared-memory-ring") {
+        repoConfig.isSharedMemoryRingEnabled = it->second.get_value<std::string>() == "yes";
+      }
+      else
+        throw Repo::Error("Unrecognized '" + it->first + "' option in 'local_bulk_insert' "
+                          "section in configuration file '"+ configPath +"'");
+    }
+  }
+
   if (repoConf.get<std::string>("storage.method") != "sqlite")
     throw Repo::Error("Only 'sqlite' storage method is supported");
 
@@ -106,8 +132,89 @@ parseConfig(const std::string& configPath)
 
   repoConfig.validatorNode = repoConf.get_child("validator");
 
+  // threads {
+  //   validation 4    ; worker threads validating fetched Data, 0 validates inline
+  //   signing 2       ; worker threads signing command responses, 0 signs inline
+  //   tcp_bulk_insert 4 ; worker threads receiving and decoding TCP bulk inserts
+  //   read 4          ; worker threads reading Data from the database, 0 reads inline
+  // }
+  repoConfig.nValidationThreads = repoConf.get<size_t>("threads.validation", 0);
+  repoConfig.nSigningThreads = repoConf.get<size_t>("threads.signing", 0);
+  repoConfig.nTcpBulkInsertThreads = repoConf.get<size_t>("threads.tcp_bulk_insert", 0);
+  repoConfig.nReadThreads = repoConf.get<size_t>("threads.read", 0);
+
+  // signing {
+  //   command digest                 ; policy of command responses: identity, digest or hmac
+  //   identity /example/repo         ; identity signing under the identity policy
+  //   hmac-key-name /example/repo/KEY/hmac
+  //   hmac-key-file /etc/ndn/repo-ng.hmac-key  ; raw secret key of the hmac policy
+  // }
+  try {
+    repoConfig.commandSigningPolicy =
+      ResponseSigner::parsePolicy(repoConf.get<std::string>("signing.command", "identity"));
+  }
+  catch (ResponseSigner::Error& e) {
+    throw Repo::Error(std::string(e.what()) + " in 'signing' section in configuration file '" +
+                      configPath + "'");
+  }
+  if (repoConfig.commandSigningPolicy == ResponseSigner::POLICY_ECDSA)
+    throw Repo::Error("Command responses cannot be signed with 'ecdsa' policy in configuration "
+                      "file '" + configPath + "'");
+  repoConfig.signingIdentity = Name(repoConf.get<std::string>("signing.identity", ""));
+  repoConfig.hmacKeyName = Name(repoConf.get<std::string>("signing.hmac-key-name", ""));
+  repoConfig.hmacKeyFile = repoConf.get<std::string>("signing.hmac-key-file", "");
+  if (repoConfig.commandSigningPolicy == ResponseSigner::POLICY_HMAC_SHA256 &&
+      repoConfig.hmacKeyFile.empty())
+    throw Repo::Error("'hmac' signing policy requires 'hmac-key-file' in configuration file '" +
+                      configPath + "'");
+
   repoConfig.nMaxPackets = repoConf.get<int>("storage.max-packets");
 
+  // storage {
+  //   synchronous "off"           ; durability level: off, normal or full
+  //   checkpoint-interval 1000    ; passive WAL checkpoint period in milliseconds
+  //   mmap-size 268435456         ; bytes of the database file to memory-map
+  //   cache-size -16384           ; page cache size, negative values are in KiB
+  //   page-size 4096              ; page size in bytes, applied to new databases only
+  //   incremental-vacuum true     ; create new databases with auto_vacuum = INCREMENTAL
+  //   vacuum-interval 5000        ; idle period in milliseconds before free pages are reclaimed
+  //   vacuum-pages 64             ; pages reclaimed per idle period
+  //   scrub-interval 1000         ; period in milliseconds of background Data verification
+  //   scrub-bytes 1048576         ; bytes of Data verified per period
+  //   read-cache-bytes 16777216   ; bytes of recently read Data kept in memory, 0 disables
+  //   prefetch-depth 16           ; maximum number of segments loaded ahead of a reader
+  //   read-batch-size 32          ; Interests answered with one storage fetch, 1 disables
+  //   read-batch-window 1         ; longest wait in milliseconds for a batch to fill
+  // }
+  SqliteStorage::Options& storageOptions = repoConfig.storageOptions;
+  storageOptions.synchronous = repoConf.get<std::string>("storage.synchronous", "off");
+  storageOptions.mmapSize = repoConf.get<int64_t>("storage.mmap-size", -1);
+  storageOptions.cacheSize = repoConf.get<int64_t>("storage.cache-size", 0);
+  storageOptions.pageSize = repoConf.get<int64_t>("storage.page-size", 0);
+
+  storageOptions.checkpointInterval =
+    ndn::time::milliseconds(repoConf.get<int64_t>("storage.checkpoint-interval", 0));
+
+  storageOptions.incrementalVacuum = repoConf.get<bool>("storage.incremental-vacuum", false);
+  repoConfig.vacuumInterval =
+    ndn::time::milliseconds(repoConf.get<int64_t>("storage.vacuum-interval", 0));
+  repoConfig.vacuumPages = repoConf.get<int64_t>("storage.vacuum-pages", 64);
+  if (repoConfig.vacuumPages <= 0)
+    throw Repo::Error("'vacuum-pages' in 'storage' section in configuration file '" +
+                      configPath + "' must be positive");
+
+  repoConfig.scrubInterval =
+    ndn::time::milliseconds(repoConf.get<int64_t>("storage.scrub-interval", 0));
+  repoConfig.scrubBytes = repoConf.get<size_t>("storage.scrub-bytes", 1048576);
+
+  repoConfig.readCacheBytes = repoConf.get<size_t>("storage.read-cache-bytes", 0);
+  // prefetched Data have nowhere to go without a read cache
+  repoConfig.maxPrefetchDepth = repoConfig.readCacheBytes == 0 ? 0 :
+                                repoConf.get<size_t>("storage.prefetch-depth", 16);
+  repoConfig.maxReadBatchSize = repoConf.get<size_t>("storage.read-batch-size", 1);
+  repoConfig.readBatchWindow =
+    ndn::time::milliseconds(repoConf.get<int64_t>("storage.read-batch-window", 1));
+
   return repoConfig;
 }
 
@@ -115,17 +222,38 @@ Repo::Repo(boost::asio::io_service& ioService, const RepoConfig& config)
   : m_config(config)
   , m_scheduler(ioService)
   , m_face(ioService)
-  , m_store(std::make_shared<SqliteStorage>(config.dbPath))
-  , m_storageHandle(config.nMaxPackets, *m_store)
-  , m_validator(m_face)
-  , m_readHandle(m_face, m_storageHandle, m_keyChain, m_scheduler)
-  , m_writeHandle(m_face, m_storageHandle, m_keyChain, m_scheduler, m_validator)
-  , m_watchHandle(m_face, m_storageHandle, m_keyChain, m_scheduler, m_validator)
-  , m_deleteHandle(m_face, m_storageHandle, m_keyChain, m_scheduler, m_validator)
-  , m_tcpBulkInsertHandle(ioService, m_storageHandle)
+  , m_store(std::make_shared<SqliteStorage>(config.dbPath, config.storageOptions))
+  , m_storageHandle(config.nMaxPackets, *m_store, config.readCacheBytes)
+  , m_scrubber(m_storageHandle, m_scheduler)
+  , m_responseSigner(ioService, m_keyChain, config.nSigningThreads)
+  , m_certificateCache(make_shared<SharedCertificateCache>())
+  , m_validator(&m_face, m_certificateCache)
+  , m_validationPool(ioService, m_validator, m_certificateCache, config.nValidationThreads)
+  , m_readHandle(m_face, m_storageHandle, m_responseSigner, m_scheduler,
+                 config.maxPrefetchDepth, config.maxReadBatchSize, config.readBatchWindow,
+                 config.nReadThreads)
+  , m_writeHandle(m_face, m_storageHandle, m_responseSigner, m_scheduler, m_validator,
+                  m_validationPool)
+  , m_watchHandle(m_face, m_storageHandle, m_responseSigner, m_scheduler, m_validator,
+                  m_validationPool)
+  , m_deleteHandle(m_face, m_storageHandle, m_responseSigner, m_scheduler, m_validator)
+  , m_tcpBulkInsertHandle(ioService, m_storageHandle, config.nTcpBulkInsertThreads)
+  , m_maintenanceHandle(m_face, m_storageHandle, m_responseSigner, m_scheduler, m_validator)
 
 {
   m_validator.load(config.validatorNode, config.repoConfigPath);
+  m_validationPool.load(config.validatorNode, config.repoConfigPath);
+
+  if (!config.hmacKeyFile.empty()) {
+    std::ifstream keyFile(config.hmacKeyFile.c_str(), std::ios::binary);
+    shared_ptr<ndn::Buffer> key =
+      make_shared<ndn::Buffer>(std::istreambuf_iterator<char>(keyFile),
+                               std::istreambuf_iterator<char>());
+    if (!keyFile.eof() || key->empty())
+      throw Error("Cannot read HMAC key from '" + config.hmacKeyFile + "'");
+    m_responseSigner.setHmacKey(config.hmacKeyName, key);
+  }
+  m_responseSigner.setPolicy(config.commandSigningPolicy, config.signingIdentity);
 }
 
 void
@@ -137,6 +265,14 @@ Repo::initializeStorage()
   ndn::time::steady_clock::TimePoint end = ndn::time::steady_clock::now();
   ndn::time::milliseconds cost = ndn::time::duration_cast<ndn::time::milliseconds>(end - start);
   std::cerr << "initialize storage cost: " << cost << "ms" << std::endl;
+
+  if (m_config.vacuumInterval > ndn::time::milliseconds::zero()) {
+    m_maintenanceHandle.startIdleReclamation(m_config.vacuumInterval, m_config.vacuumPages);
+  }
+
+  if (m_config.scrubInterval > ndn::time::milliseconds::zero()) {
+    m_scrubber.start(m_config.scrubInterval, m_config.scrubBytes);
+  }
 }
 
 void
@@ -158,6 +294,7 @@ Repo::enableListening()
       m_writeHandle.listen(*it);
       m_watchHandle.listen(*it);
       m_deleteHandle.listen(*it);
+      m_maintenanceHandle.listen(*it);
     }
 
   // Enable listening on TCP bulk insert addresses
@@ -167,12 +304,34 @@ Repo::enableListening()
     {
       m_tcpBulkInsertHandle.listen(it->first, it->second);
     }
+
+  if (!m_config.localBulkInsertPath.empty())
+    m_tcpBulkInsertHandle.listenLocal(m_config.localBulkInsertPath,
+                                      m_config.isSharedMemoryRingEnabled);
 }
 
 void
 Repo::enableValidation()
 {
   m_validator.load(m_config.validatorNode, m_config.repoConfigPath);
+  m_validationPool.load(m_config.validatorNode, m_config.repoConfigPath);
+}
+
+void
+Repo::printStatistics(std::ostream& os) const
+{
+  os << "read latency (synchronous=" << m_config.storageOptions.synchronous << "): ";
+  m_readHandle.printLatencyStatistics(os);
+  os << std::endl;
+  m_storageHandle.getReadCache().printStatistics(os);
+  os << " prefetched: " << m_readHandle.getPrefetcher().getNPrefetched();
+  os << " storage reads: " << m_readHandle.getCoalescer().getNStorageReads()
+     << " coalesced: " << m_readHandle.getCoalescer().getNCoalesced();
+  os << std::endl;
+  m_scrubber.printStatistics(os);
+  os << std::endl;
+  m_certificateCache->printStatistics(os);
+  os << std::endl;
 }
 
 } // namespace repo
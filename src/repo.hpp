@@ -23,12 +23,17 @@
 //#include "storage/repo_storage.hpp"
 #include "storage/sqlite-storage.hpp"
 #include "storage/repo-storage.hpp"
+#include "storage/scrubber.hpp"
 
 #include "handles/read-handle.hpp"
 #include "handles/write-handle.hpp"
 #include "handles/watch-handle.hpp"
 #include "handles/delete-handle.hpp"
 #include "handles/tcp-bulk-insert-handle.hpp"
+#include "handles/maintenance-handle.hpp"
+
+#include "util/certificate-cache.hpp"
+#include "util/response-signer.hpp"
 
 #include "common.hpp"
 
@@ -45,8 +50,27 @@ struct RepoConfig
   std::vector<ndn::Name> dataPrefixes;
   std::vector<ndn::Name> repoPrefixes;
   std::vector<std::pair<std::string, std::string> > tcpBulkInsertEndpoints;
+  std::string localBulkInsertPath;  ///< empty if local bulk insert is disabled
+  bool isSharedMemoryRingEnabled;
   int64_t nMaxPackets;
+  SqliteStorage::Options storageOptions;
+  ndn::time::milliseconds vacuumInterval;
+  int64_t vacuumPages;
+  ndn::time::milliseconds scrubInterval;
+  size_t scrubBytes;
+  size_t readCacheBytes;
+  size_t maxPrefetchDepth;
+  size_t maxReadBatchSize;
+  ndn::time::milliseconds readBatchWindow;
   boost::property_tree::ptree validatorNode;
+  size_t nValidationThreads;
+  size_t nSigningThreads;
+  size_t nTcpBulkInsertThreads;
+  size_t nReadThreads;
+  ResponseSigner::Policy commandSigningPolicy;
+  ndn::Name signingIdentity;
+  ndn::Name hmacKeyName;
+  std::string hmacKeyFile;
 };
 
 RepoConfig
@@ -78,19 +102,42 @@ public:
   void
   enableValidation();
 
+  /**
+   * @brief get the certificate cache shared by all validators of the repo
+   *
+   * A RepoSync running alongside should validate with a ValidatorConfig using this cache.
+   */
+  const shared_ptr<SharedCertificateCache>&
+  getCertificateCache() const
+  {
+    return m_certificateCache;
+  }
+
+  /**
+   * @brief print read latency percentiles observed by ReadHandle, scrubber counters
+   *        and certificate cache counters
+   */
+  void
+  printStatistics(std::ostream& os) const;
+
 private:
   RepoConfig m_config;
   ndn::Scheduler m_scheduler;
   ndn::Face m_face;
   std::shared_ptr<Storage> m_store;
   RepoStorage m_storageHandle;
+  Scrubber m_scrubber;
   KeyChain m_keyChain;
+  ResponseSigner m_responseSigner;
+  shared_ptr<SharedCertificateCache> m_certificateCache;
   ValidatorConfig m_validator;
+  ValidationPool m_validationPool;
   ReadHandle m_readHandle;
   WriteHandle m_writeHandle;
   WatchHandle m_watchHandle;
   DeleteHandle m_deleteHandle;
   TcpBulkInsertHandle m_tcpBulkInsertHandle;
+  MaintenanceHandle m_maintenanceHandle;
 };
 
 } // namespace repo
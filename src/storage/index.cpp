@@ -20,7 +20,6 @@
 #include "index.hpp"
 #include "skiplist.hpp"
 
-#include <ndn-cxx/util/crypto.hpp>
 #include "ndn-cxx/security/signature-sha256-with-rsa.hpp"
 
 namespace repo {
@@ -51,12 +50,42 @@ matchesSimpleSelectors(const Interest& interest, ndn::ConstBufferPtr& hash,
     return false;
   if (!interest.getPublisherPublicKeyLocator().empty())
     {
-      if (*entry.getKeyLocatorHash() != *hash)
+      if (entry.getKeyLocatorHash() == 0 || *entry.getKeyLocatorHash() != *hash)
           return false;
     }
   return true;
 }
 
+/** @brief maximum number of entries stepped over before a batched lookup falls
+ *         back to a search from the head of the skip list
+ */
+static const size_t MAX_WALK_STEPS = 16;
+
+/** @brief number of distinct KeyLocators whose digests are kept
+ */
+static const size_t KEYLOCATOR_HASH_CACHE_CAPACITY = 1024;
+
+/** @brief orders positions in a vector of Interests by Interest name
+ */
+class InterestNameLess
+{
+public:
+  explicit
+  InterestNameLess(const std::vector<Interest>& interests)
+    : m_interests(interests)
+  {
+  }
+
+  bool
+  operator()(size_t a, size_t b) const
+  {
+    return m_interests[a].getName() < m_interests[b].getName();
+  }
+
+private:
+  const std::vector<Interest>& m_interests;
+};
+
 Index::Index(const size_t nMaxPackets)
   : m_maxPackets(nMaxPackets)
   , m_size(0)
@@ -76,6 +105,12 @@ Index::insert(const Data& data, const int64_t id)
   return isInserted;
 }
 
+bool
+Index::insert(const PreparedData& data, const int64_t id)
+{
+  return insert(data.fullName, id, data.keyLocatorHash);
+}
+
 bool
 Index::insert(const Name& fullName, const int64_t id,
               const ndn::ConstBufferPtr& keyLocatorHash)
@@ -118,15 +153,51 @@ Index::find(const Name& name) const
     }
 }
 
+std::vector<std::pair<int64_t,Name> >
+Index::find(const std::vector<Interest>& interests) const
+{
+  std::vector<std::pair<int64_t,Name> > results(interests.size(), std::make_pair(0, Name()));
+
+  std::vector<size_t> order(interests.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), InterestNameLess(interests));
+
+  // the cursor never passes the lower bound of the next name, because names are ascending
+  IndexSkipList::const_iterator cursor = m_skipList.begin();
+  for (size_t i = 0; i < order.size(); ++i) {
+    const Interest& interest = interests[order[i]];
+    const Name& name = interest.getName();
+    for (size_t nSteps = 0; nSteps < MAX_WALK_STEPS; ++nSteps) {
+      if (cursor == m_skipList.end() || !(cursor->getName() < name))
+        break;
+      ++cursor;
+    }
+    if (cursor != m_skipList.end() && cursor->getName() < name)
+      cursor = m_skipList.lower_bound(name);
+
+    if (cursor == m_skipList.end())
+      break;
+    results[order[i]] = selectChild(interest, cursor);
+  }
+  return results;
+}
+
 bool
 Index::hasData(const Data& data) const
 {
-  Index::Entry entry(data, -1); // the id number is useless
+  Index::Entry entry(data.getFullName()); // lookups need only the name
   IndexSkipList::const_iterator result = m_skipList.find(entry);
   return result != m_skipList.end();
 
 }
 
+bool
+Index::hasData(const PreparedData& data) const
+{
+  return m_skipList.find(Index::Entry(data.fullName)) != m_skipList.end();
+}
+
 std::pair<int64_t,Name>
 Index::findFirstEntry(const Name& prefix,
                       IndexSkipList::const_iterator startingPoint) const
@@ -157,12 +228,41 @@ Index::erase(const Name& fullName)
     return false;
 }
 
+bool
+Index::eraseById(const int64_t id)
+{
+  for (IndexSkipList::const_iterator it = m_skipList.begin(); it != m_skipList.end(); ++it)
+    {
+      if (it->getId() == id)
+        {
+          m_skipList.erase(it);
+          m_size--;
+          return true;
+        }
+    }
+  return false;
+}
+
 const ndn::ConstBufferPtr
 Index::computeKeyLocatorHash(const KeyLocator& keyLocator)
 {
-  const Block& block = keyLocator.wireEncode();
-  ndn::ConstBufferPtr keyLocatorHash = ndn::crypto::sha256(block.wire(), block.size());
-  return keyLocatorHash;
+  return getKeyLocatorHashCache().get(keyLocator);
+}
+
+const ndn::ConstBufferPtr
+Index::computeKeyLocatorHash(const Data& data)
+{
+  const ndn::Signature& signature = data.getSignature();
+  if (!signature.hasKeyLocator())
+    return ndn::ConstBufferPtr();
+  return computeKeyLocatorHash(signature.getKeyLocator());
+}
+
+KeyLocatorHashCache&
+Index::getKeyLocatorHashCache()
+{
+  static KeyLocatorHashCache cache(KEYLOCATOR_HASH_CACHE_CAPACITY);
+  return cache;
 }
 
 std::pair<int64_t,Name>
@@ -174,9 +274,7 @@ Index::selectChild(const Interest& interest,
   ndn::ConstBufferPtr hash;
   if (!interest.getPublisherPublicKeyLocator().empty())
     {
-      KeyLocator keyLocator = interest.getPublisherPublicKeyLocator();
-      const Block& block = keyLocator.wireEncode();
-      hash = ndn::crypto::sha256(block.wire(), block.size());
+      hash = computeKeyLocatorHash(interest.getPublisherPublicKeyLocator());
     }
 
   if (isLeftmost)
@@ -192,12 +290,20 @@ Index::selectChild(const Interest& interest,
     }
   else
     {
-      IndexSkipList::const_iterator boundary = m_skipList.lower_bound(interest.getName());
-      if (boundary == m_skipList.end() || !interest.getName().isPrefixOf(boundary->getName()))
+      // the entries under the Interest name start at startingPoint, and a few of them are
+      // stepped over to find their end before searching for the successor of the name
+      IndexSkipList::const_iterator boundary = startingPoint;
+      if (!interest.getName().isPrefixOf(boundary->getName()))
         return std::make_pair(0, Name());
-      Name successor = interest.getName().getSuccessor();
-      IndexSkipList::const_iterator last = interest.getName().size() == 0 ?
-                    m_skipList.end() : m_skipList.lower_bound(interest.getName().getSuccessor());
+      IndexSkipList::const_iterator last = boundary;
+      for (size_t nSteps = 0; nSteps < MAX_WALK_STEPS; ++nSteps) {
+        if (last == m_skipList.end() || !interest.getName().isPrefixOf(last->getName()))
+          break;
+        ++last;
+      }
+      if (last != m_skipList.end() && interest.getName().isPrefixOf(last->getName()))
+        last = interest.getName().size() == 0 ?
+                 m_skipList.end() : m_skipList.lower_bound(interest.getName().getSuccessor());
       while (true)
         {
           IndexSkipList::const_iterator prev = last;
@@ -228,11 +334,9 @@ Index::selectChild(const Interest& interest,
 
 Index::Entry::Entry(const Data& data, const int64_t id)
   : m_name(data.getFullName())
+  , m_keyLocatorHash(computeKeyLocatorHash(data))
   , m_id(id)
 {
-  const ndn::Signature& signature = data.getSignature();
-  if (signature.hasKeyLocator())
-    m_keyLocatorHash = computeKeyLocatorHash(signature.getKeyLocator());
 }
 
 Index::Entry::Entry(const Name& fullName, const KeyLocator& keyLocator, const int64_t id)
@@ -22,6 +22,8 @@
 
 #include "common.hpp"
 #include "skiplist.hpp"
+#include "keylocator-hash-cache.hpp"
+#include "prepared-data.hpp"
 #include <queue>
 
 namespace repo {
@@ -159,6 +161,14 @@ public:
   bool
   insert(const Data& data, const int64_t id);
 
+  /**
+   *  @brief insert entries into index
+   *  @param  data    used to construct entries, without hashing data again
+   *  @param  id      obtained from database
+   */
+  bool
+  insert(const PreparedData& data, const int64_t id);
+
   /**
    *  @brief insert entries into index
    *  @param  data    used to construct entries
@@ -174,12 +184,31 @@ public:
   bool
   erase(const Name& fullName);
 
+  /**
+   *  @brief erase the entry in index by its record ID
+   *
+   *  The entries are ordered by name, so this walks the whole index; it is meant for
+   *  records whose name can no longer be read back from the database.
+   */
+  bool
+  eraseById(const int64_t id);
+
   /** @brief find the Entry for best match of an Interest
    * @return ID and fullName of the Entry, or (0,ignored) if not found
    */
   std::pair<int64_t, Name>
   find(const Interest& interest) const;
 
+  /** @brief find the Entries for best match of several Interests
+   *
+   *  The Interests are visited in name order with a single forward walk over the
+   *  index, so that Interests for neighboring names only step over the entries
+   *  between them instead of each searching from the head of the skip list.
+   *  @return ID and fullName for each Interest in the same order, (0,ignored) if not found
+   */
+  std::vector<std::pair<int64_t, Name> >
+  find(const std::vector<Interest>& interests) const;
+
   /** @brief find the first Entry under a Name prefix
    * @return ID and fullName of the Entry, or (0,ignored) if not found
    */
@@ -193,24 +222,51 @@ public:
   bool
   hasData(const Data& data) const;
 
+  /**
+   *  @brief determine whether same Data is already in the index
+   */
+  bool
+  hasData(const PreparedData& data) const;
+
   /**
     *  @brief compute the hash value of keyLocator
+    *
+    *  Digests are memoized in the KeyLocatorHashCache shared by all callers.
     */
   static const ndn::ConstBufferPtr
   computeKeyLocatorHash(const KeyLocator& keyLocator);
 
+  /**
+    *  @brief compute the hash value of the keyLocator of data
+    *  @return null if the signature of data has no keyLocator
+    */
+  static const ndn::ConstBufferPtr
+  computeKeyLocatorHash(const Data& data);
+
+  static KeyLocatorHashCache&
+  getKeyLocatorHashCache();
+
   const size_t
   size() const
   {
     return m_size;
   }
 
+  /**
+   *  @brief get the number of entries that can still be inserted
+   */
+  size_t
+  getRemainingCapacity() const
+  {
+    return isFull() ? 0 : m_maxPackets - m_size;
+  }
+
 private:
   /**
    *  @brief select entries which satisfy the selectors in interest and return their name
    *  @param  interest   used to select entries by comparing the name and checking selectors
    *  @param  idName    save the id and name of found entries
-   *  @param  startingPoint the entry whose name is equal or larger than the interest name
+   *  @param  startingPoint the first entry whose name is equal or larger than the interest name
    */
   std::pair<int64_t, Name>
   selectChild(const Interest& interest,
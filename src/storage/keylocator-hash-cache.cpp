@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keylocator-hash-cache.hpp"
+
+#include <ndn-cxx/util/crypto.hpp>
+
+namespace repo {
+
+KeyLocatorHashCache::KeyLocatorHashCache(size_t capacity)
+  : m_capacity(capacity)
+  , m_nHits(0)
+  , m_nMisses(0)
+{
+}
+
+ndn::ConstBufferPtr
+KeyLocatorHashCache::get(const KeyLocator& keyLocator)
+{
+  const Block& block = keyLocator.wireEncode();
+  ndn::Buffer wire(block.wire(), block.size());
+
+  boost::mutex::scoped_lock lock(m_mutex);
+  std::map<ndn::Buffer, ndn::ConstBufferPtr>::const_iterator it = m_hashes.find(wire);
+  if (it != m_hashes.end()) {
+    ++m_nHits;
+    return it->second;
+  }
+
+  ++m_nMisses;
+  ndn::ConstBufferPtr hash = ndn::crypto::sha256(block.wire(), block.size());
+  if (m_hashes.size() >= m_capacity)
+    m_hashes.clear();
+  if (m_capacity > 0)
+    m_hashes[wire] = hash;
+  return hash;
+}
+
+size_t
+KeyLocatorHashCache::size() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_hashes.size();
+}
+
+uint64_t
+KeyLocatorHashCache::getNHits() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_nHits;
+}
+
+uint64_t
+KeyLocatorHashCache::getNMisses() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_nMisses;
+}
+
+} // namespace repo
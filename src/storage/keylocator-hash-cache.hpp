@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_KEYLOCATOR_HASH_CACHE_HPP
+#define REPO_STORAGE_KEYLOCATOR_HASH_CACHE_HPP
+
+#include "../common.hpp"
+
+#include <boost/thread/mutex.hpp>
+
+namespace repo {
+
+/**
+ * @brief memoized SHA-256 digests of KeyLocators, keyed by their wire encoding
+ *
+ * The Data of a repo are signed by few keys, so inserts and Interests with a
+ * PublisherPublicKeyLocator hash the same handful of KeyLocators over and over.
+ * Digests are handed out as shared buffers, so entries of the same signer also
+ * share one copy of the digest.  When the cache is full it starts over, which
+ * costs one digest per signer.  It may be used from any thread.
+ */
+class KeyLocatorHashCache : noncopyable
+{
+public:
+  explicit
+  KeyLocatorHashCache(size_t capacity);
+
+  /**
+   * @brief get the digest of the wire encoding of @p keyLocator
+   */
+  ndn::ConstBufferPtr
+  get(const KeyLocator& keyLocator);
+
+  size_t
+  size() const;
+
+  /**
+   * @brief get the number of digests that did not have to be computed
+   */
+  uint64_t
+  getNHits() const;
+
+  uint64_t
+  getNMisses() const;
+
+private:
+  size_t m_capacity;
+  std::map<ndn::Buffer, ndn::ConstBufferPtr> m_hashes;
+  uint64_t m_nHits;
+  uint64_t m_nMisses;
+  mutable boost::mutex m_mutex;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_KEYLOCATOR_HASH_CACHE_HPP
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_PREFIX_KEY_HPP
+#define REPO_STORAGE_PREFIX_KEY_HPP
+
+#include "../common.hpp"
+
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+namespace repo {
+
+/**
+ * @brief encode a Name into an order-preserving binary key
+ *
+ * Every component is written as a 4-octet big-endian TLV-TYPE, a 4-octet
+ * big-endian TLV-LENGTH and then TLV-VALUE.  Because the header has fixed
+ * width, comparing two keys with memcmp (which is how SQLite compares BLOBs)
+ * orders names component by component, and the key of a Name is a byte prefix
+ * of the key of exactly those names it is a prefix of.  A prefix query is
+ * therefore a single range scan: [key(prefix), getPrefixKeySuccessor(key(prefix))).
+ */
+inline ndn::Buffer
+encodePrefixKey(const Name& name)
+{
+  ndn::Buffer key;
+  for (Name::const_iterator it = name.begin(); it != name.end(); ++it) {
+    uint32_t type = static_cast<uint32_t>(it->type());
+    uint32_t length = static_cast<uint32_t>(it->value_size());
+    for (int shift = 24; shift >= 0; shift -= 8)
+      key.push_back(static_cast<uint8_t>(type >> shift));
+    for (int shift = 24; shift >= 0; shift -= 8)
+      key.push_back(static_cast<uint8_t>(length >> shift));
+    key.insert(key.end(), it->value(), it->value() + it->value_size());
+  }
+  return key;
+}
+
+/**
+ * @brief decode a key produced by encodePrefixKey back into a Name
+ * @throw ndn::tlv::Error the key is malformed
+ */
+inline Name
+decodePrefixKey(const uint8_t* key, size_t keySize)
+{
+  Name name;
+  size_t offset = 0;
+  while (offset < keySize) {
+    if (keySize - offset < 8)
+      throw ndn::tlv::Error("Truncated prefix key component header");
+
+    uint32_t type = 0;
+    uint32_t length = 0;
+    for (size_t i = 0; i < 4; ++i)
+      type = (type << 8) | key[offset + i];
+    for (size_t i = 4; i < 8; ++i)
+      length = (length << 8) | key[offset + i];
+    offset += 8;
+
+    if (keySize - offset < length)
+      throw ndn::tlv::Error("Truncated prefix key component value");
+
+    ndn::EncodingBuffer encoder(length + 10, 0);
+    encoder.prependByteArray(key + offset, length);
+    encoder.prependVarNumber(length);
+    encoder.prependVarNumber(type);
+    name.append(Name::Component(encoder.block()));
+    offset += length;
+  }
+  return name;
+}
+
+/**
+ * @brief get the smallest key that is greater than every key starting with @p key
+ * @return empty Buffer if there is no upper bound (e.g. key of the root prefix)
+ */
+inline ndn::Buffer
+getPrefixKeySuccessor(const ndn::Buffer& key)
+{
+  ndn::Buffer successor(key);
+  while (!successor.empty() && successor.back() == 0xFF)
+    successor.pop_back();
+  if (!successor.empty())
+    ++successor.back();
+  return successor;
+}
+
+} // namespace repo
+
+#endif // REPO_STORAGE_PREFIX_KEY_HPP
@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_PREPARED_DATA_HPP
+#define REPO_STORAGE_PREPARED_DATA_HPP
+
+#include "../common.hpp"
+
+namespace repo {
+
+/**
+ * @brief everything about a Data that storing it needs, computed once
+ *
+ * The full name costs a SHA-256 over the whole packet, and the keyLocator hash
+ * another one unless it is memoized.  RepoStorage prepares each Data once and
+ * passes the result to both Index and Storage, which read these fields instead
+ * of encoding or hashing the Data again.
+ */
+class PreparedData
+{
+public:
+  explicit
+  PreparedData(const Data& data);
+
+public:
+  Block wire;                          ///< wire encoding of the Data
+  Name fullName;                       ///< name with implicit digest
+  Block fullNameWire;                  ///< wire encoding of fullName
+  ndn::ConstBufferPtr keyLocatorHash;  ///< null if the Data has no KeyLocator
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_PREPARED_DATA_HPP
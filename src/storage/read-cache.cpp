@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "read-cache.hpp"
+
+namespace repo {
+
+ReadCache::ReadCache(size_t capacity)
+  : m_capacity(capacity)
+  , m_size(0)
+{
+}
+
+shared_ptr<Data>
+ReadCache::find(int64_t id)
+{
+  std::map<int64_t, std::list<Entry>::iterator>::iterator it = m_entries.find(id);
+  if (it == m_entries.end()) {
+    ++m_counters.nMisses;
+    return shared_ptr<Data>();
+  }
+
+  ++m_counters.nHits;
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  return it->second->data;
+}
+
+void
+ReadCache::insert(int64_t id, const shared_ptr<Data>& data)
+{
+  size_t size = data->wireEncode().size();
+  if (size > m_capacity || contains(id))
+    return;
+
+  while (m_size + size > m_capacity) {
+    m_size -= m_lru.back().size;
+    m_entries.erase(m_lru.back().id);
+    m_lru.pop_back();
+    ++m_counters.nEvictions;
+  }
+
+  Entry entry;
+  entry.id = id;
+  entry.data = data;
+  entry.size = size;
+  m_lru.push_front(entry);
+  m_entries[id] = m_lru.begin();
+  m_size += size;
+  ++m_counters.nInsertions;
+}
+
+void
+ReadCache::erase(int64_t id)
+{
+  std::map<int64_t, std::list<Entry>::iterator>::iterator it = m_entries.find(id);
+  if (it == m_entries.end())
+    return;
+
+  m_size -= it->second->size;
+  m_lru.erase(it->second);
+  m_entries.erase(it);
+}
+
+void
+ReadCache::printStatistics(std::ostream& os) const
+{
+  uint64_t nLookups = m_counters.nHits + m_counters.nMisses;
+  os << "read cache hits: " << m_counters.nHits
+     << " misses: " << m_counters.nMisses
+     << " hit rate: " << (nLookups == 0 ? 0.0 :
+                          static_cast<double>(m_counters.nHits) / nLookups)
+     << " insertions: " << m_counters.nInsertions
+     << " evictions: " << m_counters.nEvictions
+     << " bytes: " << m_size << "/" << m_capacity;
+}
+
+} // namespace repo
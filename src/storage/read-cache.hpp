@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_READ_CACHE_HPP
+#define REPO_STORAGE_READ_CACHE_HPP
+
+#include "../common.hpp"
+
+#include <list>
+
+namespace repo {
+
+/**
+ * @brief least recently used cache of stored Data, by database record ID
+ *
+ * Record IDs are unique while a Data is stored, so an entry never becomes stale
+ * unless the Data is deleted; RepoStorage erases the entry whenever it deletes one.
+ * The capacity is the total size of the cached wire encodings.
+ */
+class ReadCache : noncopyable
+{
+public:
+  class Counters
+  {
+  public:
+    Counters()
+      : nHits(0)
+      , nMisses(0)
+      , nInsertions(0)
+      , nEvictions(0)
+    {
+    }
+
+  public:
+    uint64_t nHits;        ///< reads answered from the cache
+    uint64_t nMisses;      ///< reads that went to the database
+    uint64_t nInsertions;  ///< Data added, by reads or prefetching
+    uint64_t nEvictions;   ///< Data dropped to make room
+  };
+
+public:
+  /**
+   * @param capacity maximum number of cached bytes, 0 disables the cache
+   */
+  explicit
+  ReadCache(size_t capacity);
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief get the cached Data of a record, and mark it as recently used
+   * @return nullptr if the record is not cached
+   */
+  shared_ptr<Data>
+  find(int64_t id);
+
+  /**
+   * @brief determine whether a record is cached, without counting a lookup
+   */
+  bool
+  contains(int64_t id) const
+  {
+    return m_entries.count(id) > 0;
+  }
+
+  /**
+   * @brief cache the Data of a record, evicting least recently used records if needed
+   */
+  void
+  insert(int64_t id, const shared_ptr<Data>& data);
+
+  void
+  erase(int64_t id);
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /**
+   * @brief print counters, hit rate and size
+   */
+  void
+  printStatistics(std::ostream& os) const;
+
+private:
+  struct Entry
+  {
+    int64_t id;
+    shared_ptr<Data> data;
+    size_t size;
+  };
+
+  size_t m_capacity;
+  size_t m_size;
+  std::list<Entry> m_lru;  ///< most recently used first
+  std::map<int64_t, std::list<Entry>::iterator> m_entries;
+  Counters m_counters;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_READ_CACHE_HPP
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "read-coalescer.hpp"
+
+namespace repo {
+
+ReadCoalescer::ReadCoalescer(boost::asio::io_service& ioService, RepoStorage& storageHandle,
+                             size_t nThreads)
+  : m_storageHandle(storageHandle)
+  , m_readers(openReaders(storageHandle, nThreads))
+  , m_workerPool(ioService, m_readers.size())
+  , m_nStorageReads(0)
+  , m_nCoalesced(0)
+{
+}
+
+std::vector<shared_ptr<Storage::Reader> >
+ReadCoalescer::openReaders(RepoStorage& storageHandle, size_t nThreads)
+{
+  std::vector<shared_ptr<Storage::Reader> > readers;
+  for (size_t i = 0; i < nThreads; ++i) {
+    shared_ptr<Storage::Reader> reader = storageHandle.openReader();
+    if (!reader) {
+      std::cerr << "Storage cannot be read from worker threads, reading on the main loop"
+                << std::endl;
+      return std::vector<shared_ptr<Storage::Reader> >();
+    }
+    readers.push_back(reader);
+  }
+  return readers;
+}
+
+void
+ReadCoalescer::read(const Interest& interest, const ReadCallback& callback)
+{
+  int64_t id = m_storageHandle.findData(interest);
+  if (id == 0) {
+    callback(shared_ptr<Data>());
+    return;
+  }
+
+  shared_ptr<Data> data = m_storageHandle.readCachedData(id);
+  if (data) {
+    callback(data);
+    return;
+  }
+
+  std::map<int64_t, shared_ptr<InFlightRead> >::iterator it = m_inFlightReads.find(id);
+  if (it != m_inFlightReads.end()) {
+    it->second->callbacks.push_back(callback);
+    ++m_nCoalesced;
+    return;
+  }
+
+  shared_ptr<InFlightRead> read = make_shared<InFlightRead>();
+  read->callbacks.push_back(callback);
+  m_inFlightReads[id] = read;
+  ++m_nStorageReads;
+  m_workerPool.submit(id,
+                      bind(&ReadCoalescer::readStored, this, _1, id, read),
+                      bind(&ReadCoalescer::onStoredRead, this, id, read));
+}
+
+void
+ReadCoalescer::readStored(size_t worker, int64_t id, const shared_ptr<InFlightRead>& read)
+{
+  try {
+    // without workers, this runs on the main loop
+    if (m_readers.empty())
+      read->data = m_storageHandle.readStoredData(id);
+    else
+      read->data = m_readers[worker]->read(id);
+  }
+  catch (Storage::Error& e) {
+    std::cerr << "read of record " << id << " failed: " << e.what() << std::endl;
+  }
+  catch (ndn::tlv::Error& e) {
+    std::cerr << "record " << id << " cannot be decoded: " << e.what() << std::endl;
+  }
+}
+
+void
+ReadCoalescer::onStoredRead(int64_t id, const shared_ptr<InFlightRead>& read)
+{
+  m_inFlightReads.erase(id);
+  if (read->data)
+    m_storageHandle.cacheData(id, read->data);
+
+  for (size_t i = 0; i < read->callbacks.size(); ++i)
+    read->callbacks[i](read->data);
+}
+
+} // namespace repo
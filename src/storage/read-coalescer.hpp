@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_READ_COALESCER_HPP
+#define REPO_STORAGE_READ_COALESCER_HPP
+
+#include "repo-storage.hpp"
+#include "../util/worker-pool.hpp"
+
+namespace repo {
+
+/**
+ * @brief reads Data for Interests, sharing one storage read among Interests for the
+ *        same record
+ *
+ * Interests are matched on the main loop.  A record that is neither cached nor
+ * already being read is read and decoded on a worker thread, and is entered into an
+ * in-flight table until then.  Interests for a record in that table only add their
+ * callback, and all of them receive the same Data when the read completes.  Without
+ * worker threads a read completes before the next Interest arrives, so nothing is
+ * ever coalesced.
+ *
+ * Every worker reads through a Storage::Reader of its own, so that the connection of
+ * the main loop is never used by another thread.  If the storage has no readers,
+ * records are read on the main loop.
+ */
+class ReadCoalescer : noncopyable
+{
+public:
+  typedef std::function<void(const shared_ptr<Data>& data)> ReadCallback;
+
+public:
+  /**
+   * @param nThreads worker threads reading from storage, 0 reads on the main loop
+   * @throw Storage::Error a reader for a worker cannot be opened
+   */
+  ReadCoalescer(boost::asio::io_service& ioService, RepoStorage& storageHandle,
+                size_t nThreads = 0);
+
+  /**
+   * @brief pass the Data that best matches @p interest to @p callback, or null if
+   *        repo has no such Data
+   *
+   * The callback runs immediately if the Data is cached or there is none, and otherwise
+   * on the main loop once it has been read.
+   */
+  void
+  read(const Interest& interest, const ReadCallback& callback);
+
+  /**
+   * @brief get the number of records being read
+   */
+  size_t
+  getNInFlight() const
+  {
+    return m_inFlightReads.size();
+  }
+
+  /**
+   * @brief get the number of records read from storage
+   */
+  uint64_t
+  getNStorageReads() const
+  {
+    return m_nStorageReads;
+  }
+
+  /**
+   * @brief get the number of Interests that waited for a read of another Interest
+   */
+  uint64_t
+  getNCoalesced() const
+  {
+    return m_nCoalesced;
+  }
+
+private:
+  struct InFlightRead
+  {
+    std::vector<ReadCallback> callbacks;
+    shared_ptr<Data> data;  ///< set by the worker
+  };
+
+  /**
+   * @brief open a reader for each of @p nThreads workers
+   * @return no readers if the storage cannot be read from other threads
+   */
+  static std::vector<shared_ptr<Storage::Reader> >
+  openReaders(RepoStorage& storageHandle, size_t nThreads);
+
+  /**
+   * @brief read a record from storage, runs on a worker thread
+   */
+  void
+  readStored(size_t worker, int64_t id, const shared_ptr<InFlightRead>& read);
+
+  void
+  onStoredRead(int64_t id, const shared_ptr<InFlightRead>& read);
+
+private:
+  RepoStorage& m_storageHandle;
+  std::vector<shared_ptr<Storage::Reader> > m_readers;  ///< outlive the workers using them
+  WorkerPool m_workerPool;
+  std::map<int64_t, shared_ptr<InFlightRead> > m_inFlightReads;
+  uint64_t m_nStorageReads;
+  uint64_t m_nCoalesced;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_READ_COALESCER_HPP
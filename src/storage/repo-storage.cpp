@@ -29,9 +29,11 @@ insertItemToIndex(Index* index, const Storage::ItemMeta& item)
   index->insert(item.fullName, item.id, item.keyLocatorHash);
 }
 
-RepoStorage::RepoStorage(const int64_t& nMaxPackets, Storage& store)
+RepoStorage::RepoStorage(const int64_t& nMaxPackets, Storage& store, size_t readCacheBytes)
   : m_index(nMaxPackets)
   , m_storage(store)
+  , m_readCache(readCacheBytes)
+  , m_lastWriteTime(ndn::time::steady_clock::now())
 {
 }
 
@@ -44,13 +46,74 @@ RepoStorage::initialize()
 bool
 RepoStorage::insertData(const Data& data)
 {
-   bool isExist = m_index.hasData(data);
+   PreparedData prepared(data);
+   bool isExist = m_index.hasData(prepared);
    if (isExist)
      throw Error("The Entry Has Already In the Skiplist. Cannot be Inserted!");
-   int64_t id = m_storage.insert(data);
+   m_lastWriteTime = ndn::time::steady_clock::now();
+   int64_t id = m_storage.insert(prepared);
    if (id == -1)
      return false;
-   return m_index.insert(data, id);
+   return m_index.insert(prepared, id);
+}
+
+size_t
+RepoStorage::insertDataBatch(const std::vector<shared_ptr<const Data> >& data)
+{
+  std::vector<InsertResult> results;
+  return insertDataBatch(data, results);
+}
+
+size_t
+RepoStorage::insertDataBatch(const std::vector<shared_ptr<const Data> >& data,
+                             std::vector<InsertResult>& results)
+{
+  results.assign(data.size(), INSERT_DUPLICATE);
+
+  // Data that the index has no room for are not written to the database at all
+  size_t capacity = m_index.getRemainingCapacity();
+  std::vector<shared_ptr<const PreparedData> > newData;
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < data.size(); ++i) {
+    shared_ptr<const PreparedData> prepared = make_shared<PreparedData>(*data[i]);
+    if (m_index.hasData(*prepared))
+      continue;
+    if (newData.size() >= capacity) {
+      results[i] = INSERT_FULL;
+      continue;
+    }
+    newData.push_back(prepared);
+    positions.push_back(i);
+  }
+  if (newData.empty())
+    return 0;
+
+  m_lastWriteTime = ndn::time::steady_clock::now();
+  std::vector<int64_t> ids = m_storage.insertBatch(newData);
+
+  size_t nInserted = 0;
+  for (size_t i = 0; i < newData.size(); ++i) {
+    if (ids[i] == -1) {
+      results[positions[i]] = INSERT_FAILED;
+      continue;
+    }
+    try {
+      if (m_index.insert(*newData[i], ids[i])) {
+        results[positions[i]] = INSERT_OK;
+        ++nInserted;
+      }
+      else {
+        // the index rejected the entry because it already holds this full name,
+        // e.g. when the batch contains the same Data twice: keep the earlier copy
+        m_storage.erase(ids[i]);
+      }
+    }
+    catch (Index::Error&) {
+      results[positions[i]] = INSERT_FULL;
+      m_storage.erase(ids[i]);
+    }
+  }
+  return nInserted;
 }
 
 ssize_t
@@ -60,8 +123,10 @@ RepoStorage::deleteData(const Name& name)
   std::pair<int64_t,ndn::Name> idName = m_index.find(name);
   if (idName.first == 0)
     return false;
+  m_lastWriteTime = ndn::time::steady_clock::now();
   int64_t count = 0;
   while (idName.first != 0) {
+    m_readCache.erase(idName.first);
     bool resultDb = m_storage.erase(idName.first);
     bool resultIndex = m_index.erase(idName.second); //full name
     if (resultDb && resultIndex)
@@ -84,7 +149,10 @@ RepoStorage::deleteData(const Interest& interest)
   int64_t count = 0;
   bool hasError = false;
   std::pair<int64_t,ndn::Name> idName = m_index.find(interestDelete);
+  if (idName.first != 0)
+    m_lastWriteTime = ndn::time::steady_clock::now();
   while (idName.first != 0) {
+    m_readCache.erase(idName.first);
     bool resultDb = m_storage.erase(idName.first);
     bool resultIndex = m_index.erase(idName.second); //full name
     if (resultDb && resultIndex)
@@ -104,13 +172,129 @@ RepoStorage::readData(const Interest& interest) const
 {
   std::pair<int64_t,ndn::Name> idName = m_index.find(interest);
   if (idName.first != 0) {
-    shared_ptr<Data> data = m_storage.read(idName.first);
+    shared_ptr<Data> data;
+    if (m_readCache.getCapacity() > 0) {
+      data = m_readCache.find(idName.first);
+      if (data)
+        return data;
+    }
+    data = m_storage.read(idName.first);
     if (data) {
+      m_readCache.insert(idName.first, data);
       return data;
     }
   }
   return shared_ptr<Data>();
 }
 
+int64_t
+RepoStorage::findData(const Interest& interest) const
+{
+  return m_index.find(interest).first;
+}
+
+shared_ptr<Data>
+RepoStorage::readCachedData(int64_t id) const
+{
+  if (m_readCache.getCapacity() == 0)
+    return shared_ptr<Data>();
+  return m_readCache.find(id);
+}
+
+shared_ptr<Data>
+RepoStorage::readStoredData(int64_t id) const
+{
+  return m_storage.read(id);
+}
+
+shared_ptr<Storage::Reader>
+RepoStorage::openReader() const
+{
+  return m_storage.openReader();
+}
+
+void
+RepoStorage::cacheData(int64_t id, const shared_ptr<Data>& data) const
+{
+  m_readCache.insert(id, data);
+}
+
+std::vector<shared_ptr<Data> >
+RepoStorage::readDataBatch(const std::vector<Interest>& interests) const
+{
+  std::vector<std::pair<int64_t,ndn::Name> > idNames = m_index.find(interests);
+  std::vector<shared_ptr<Data> > data(interests.size());
+
+  std::vector<int64_t> missingIds;
+  std::vector<size_t> missingPositions;
+  for (size_t i = 0; i < idNames.size(); ++i) {
+    if (idNames[i].first == 0)
+      continue;
+    if (m_readCache.getCapacity() > 0)
+      data[i] = m_readCache.find(idNames[i].first);
+    if (!data[i]) {
+      missingIds.push_back(idNames[i].first);
+      missingPositions.push_back(i);
+    }
+  }
+  if (missingIds.empty())
+    return data;
+
+  std::vector<shared_ptr<Data> > storedData = m_storage.readBatch(missingIds);
+  for (size_t i = 0; i < missingIds.size(); ++i) {
+    data[missingPositions[i]] = storedData[i];
+    if (storedData[i])
+      m_readCache.insert(missingIds[i], storedData[i]);
+  }
+  return data;
+}
+
+bool
+RepoStorage::prefetchData(const Name& name) const
+{
+  std::pair<int64_t,ndn::Name> idName = m_index.find(name);
+  if (idName.first == 0)
+    return false;
+  if (m_readCache.contains(idName.first))
+    return true;
+
+  shared_ptr<Data> data = m_storage.read(idName.first);
+  if (!data)
+    return false;
+  m_readCache.insert(idName.first, data);
+  return true;
+}
+
+bool
+RepoStorage::hasData(const Data& data) const
+{
+  return m_index.hasData(data);
+}
+
+int64_t
+RepoStorage::reclaimSpace(int64_t nPages)
+{
+  return m_storage.reclaim(nPages);
+}
+
+int64_t
+RepoStorage::scanData(int64_t lastId, size_t maxBytes,
+                      const std::function<void(int64_t, const ndn::Buffer&,
+                                               const ndn::Buffer&)>& f)
+{
+  return m_storage.scan(lastId, maxBytes, f);
+}
+
+bool
+RepoStorage::quarantineData(int64_t id, const Name& fullName)
+{
+  if (!fullName.empty())
+    m_index.erase(fullName);
+  else
+    m_index.eraseById(id);
+  m_readCache.erase(id);
+  return m_storage.quarantine(id);
+}
+
 
 } // namespace repo
@@ -23,6 +23,7 @@
 #include "../common.hpp"
 #include "storage.hpp"
 #include "index.hpp"
+#include "read-cache.hpp"
 #include "../repo-command-parameter.hpp"
 
 #include <ndn-cxx/exclude.hpp>
@@ -48,8 +49,21 @@ public:
     }
   };
 
+  /**
+   *  @brief  outcome of inserting one data
+   */
+  enum InsertResult {
+    INSERT_OK,
+    INSERT_DUPLICATE,  ///< identical data is already in repo
+    INSERT_FULL,       ///< repo already holds the maximum number of packets
+    INSERT_FAILED      ///< the database refused the data
+  };
+
 public:
-  RepoStorage(const int64_t& nMaxPackets, Storage& store);
+  /**
+   *  @param  readCacheBytes  capacity of the read cache, 0 disables it
+   */
+  RepoStorage(const int64_t& nMaxPackets, Storage& store, size_t readCacheBytes = 0);
 
   /**
    *  @brief  rebuild index from database
@@ -63,6 +77,24 @@ public:
   bool
   insertData(const Data& data);
 
+  /**
+   *  @brief  insert several data into repo, committing them to the database together
+   *
+   *  Data that already exist in repo are skipped.
+   *  @return number of inserted data
+   */
+  size_t
+  insertDataBatch(const std::vector<shared_ptr<const Data> >& data);
+
+  /**
+   *  @brief  insert several data into repo, reporting the outcome of each
+   *  @param[out] results  outcome of every element of @p data, in the same order
+   *  @return number of inserted data
+   */
+  size_t
+  insertDataBatch(const std::vector<shared_ptr<const Data> >& data,
+                  std::vector<InsertResult>& results);
+
   /**
    *  @brief   delete data from repo
    *  @param   name     used to find entry needed to be erased in repo
@@ -89,9 +121,107 @@ public:
   std::shared_ptr<Data>
   readData(const Interest& interest) const;
 
+  /**
+   *  @brief  find the record of the data that best matches an Interest
+   *  @return record id, or 0 if repo has no matching data
+   */
+  int64_t
+  findData(const Interest& interest) const;
+
+  /**
+   *  @brief  get the data of a record from the read cache
+   *  @return null if the record is not cached
+   */
+  shared_ptr<Data>
+  readCachedData(int64_t id) const;
+
+  /**
+   *  @brief  get the data of a record from storage, without the read cache
+   *  @return null if the record does not exist
+   */
+  shared_ptr<Data>
+  readStoredData(int64_t id) const;
+
+  /**
+   *  @brief  open a reader of storage records for a worker thread
+   *  @return null if the storage can only be read through this RepoStorage
+   */
+  shared_ptr<Storage::Reader>
+  openReader() const;
+
+  /**
+   *  @brief  keep data of a record that was read with readStoredData in the read cache
+   */
+  void
+  cacheData(int64_t id, const shared_ptr<Data>& data) const;
+
+  /**
+   *  @brief  read data for several Interests at once
+   *
+   *  The Interests are matched with one walk over the index, and the data missing
+   *  from the read cache are fetched from storage together.
+   *  @return data for each Interest in the same order, null for unsatisfied Interests
+   */
+  std::vector<shared_ptr<Data> >
+  readDataBatch(const std::vector<Interest>& interests) const;
+
+  /**
+   *  @brief  load the first data under @p name into the read cache, unless it is cached
+   *  @return false if repo has no data under @p name
+   */
+  bool
+  prefetchData(const Name& name) const;
+
+  /**
+   *  @brief  determine whether identical Data is already in repo
+   */
+  bool
+  hasData(const Data& data) const;
+
+  /**
+   *  @brief  return up to @p nPages unused database pages to the file system
+   *  @return number of bytes released
+   */
+  int64_t
+  reclaimSpace(int64_t nPages);
+
+  /**
+   *  @brief  visit stored Data in ascending id order
+   *  @sa     Storage::scan
+   */
+  int64_t
+  scanData(int64_t lastId, size_t maxBytes,
+           const std::function<void(int64_t, const ndn::Buffer&, const ndn::Buffer&)>& f);
+
+  /**
+   *  @brief  stop serving a damaged entry and move it out of the database
+   *  @param  id        record ID from database
+   *  @param  fullName  full name of the entry, or empty Name if it cannot be decoded,
+   *                    in which case the Index entry is looked up by @p id
+   */
+  bool
+  quarantineData(int64_t id, const Name& fullName);
+
+  /**
+   *  @brief  get the time of the last insertion or deletion
+   */
+  const ndn::time::steady_clock::TimePoint&
+  getLastWriteTime() const
+  {
+    return m_lastWriteTime;
+  }
+
+  const ReadCache&
+  getReadCache() const
+  {
+    return m_readCache;
+  }
+
 private:
   Index m_index;
   Storage& m_storage;
+  mutable ReadCache m_readCache;
+  ndn::time::steady_clock::TimePoint m_lastWriteTime;
 };
 
 } // namespace repo
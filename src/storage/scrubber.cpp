@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scrubber.hpp"
+
+namespace repo {
+
+Scrubber::Scrubber(RepoStorage& storageHandle, Scheduler& scheduler)
+  : m_storageHandle(storageHandle)
+  , m_scheduler(scheduler)
+  , m_interval(0)
+  , m_nBytesPerInterval(0)
+  , m_lastId(0)
+{
+}
+
+void
+Scrubber::start(const ndn::time::milliseconds& interval, size_t nBytesPerInterval)
+{
+  m_interval = interval;
+  m_nBytesPerInterval = nBytesPerInterval;
+  m_scheduler.scheduleEvent(m_interval, bind(&Scrubber::onTimer, this));
+}
+
+void
+Scrubber::onTimer()
+{
+  try {
+    step(m_nBytesPerInterval);
+  }
+  catch (std::runtime_error& e) {
+    std::cerr << "Scrubber: " << e.what() << std::endl;
+  }
+  m_scheduler.scheduleEvent(m_interval, bind(&Scrubber::onTimer, this));
+}
+
+void
+Scrubber::step(size_t nMaxBytes)
+{
+  m_corrupted.clear();
+  int64_t lastId = m_storageHandle.scanData(m_lastId, nMaxBytes,
+                                            bind(&Scrubber::verify, this, _1, _2, _3));
+
+  // records are quarantined after the scan, so that the table is not modified
+  // under a running SELECT
+  for (size_t i = 0; i < m_corrupted.size(); ++i) {
+    m_storageHandle.quarantineData(m_corrupted[i].first, m_corrupted[i].second);
+  }
+  m_counters.nCorruptedItems += m_corrupted.size();
+  m_corrupted.clear();
+
+  if (lastId == m_lastId) {
+    if (m_lastId != 0)
+      ++m_counters.nPasses;
+    m_lastId = 0;
+  }
+  else {
+    m_lastId = lastId;
+  }
+}
+
+void
+Scrubber::verify(int64_t id, const ndn::Buffer& fullNameWire, const ndn::Buffer& dataWire)
+{
+  ++m_counters.nItems;
+  m_counters.nBytes += dataWire.size();
+
+  Name fullName;
+  try {
+    if (fullNameWire.empty())
+      throw ndn::tlv::Error("Empty name");
+    fullName.wireDecode(Block(fullNameWire.buf(), fullNameWire.size()));
+  }
+  catch (ndn::tlv::Error&) {
+    std::cerr << "Scrubber: entry " << id << " has a malformed name" << std::endl;
+    m_corrupted.push_back(std::make_pair(id, Name()));
+    return;
+  }
+
+  try {
+    if (dataWire.empty())
+      throw ndn::tlv::Error("Empty Data");
+    Data data(Block(dataWire.buf(), dataWire.size()));
+    if (data.getFullName() == fullName)
+      return;
+  }
+  catch (ndn::tlv::Error&) {
+  }
+
+  std::cerr << "Scrubber: entry " << id << " " << fullName << " is corrupted" << std::endl;
+  m_corrupted.push_back(std::make_pair(id, fullName));
+}
+
+void
+Scrubber::printStatistics(std::ostream& os) const
+{
+  os << "scrubbed items: " << m_counters.nItems
+     << " bytes: " << m_counters.nBytes
+     << " corrupted: " << m_counters.nCorruptedItems
+     << " passes: " << m_counters.nPasses
+     << " position: " << m_lastId;
+}
+
+} // namespace repo
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_SCRUBBER_HPP
+#define REPO_STORAGE_SCRUBBER_HPP
+
+#include "../common.hpp"
+#include "repo-storage.hpp"
+
+namespace repo {
+
+/**
+ *  @brief  Scrubber verifies stored Data in the background
+ *
+ *  Records are visited in id order, a bounded number of bytes at a time.  Each
+ *  Data is decoded again and its full name, including the implicit digest, is
+ *  compared with the full name it was stored under.  Records that fail are
+ *  quarantined, so that they are no longer served.  After the last record the
+ *  walk starts over from the first one.
+ */
+class Scrubber : noncopyable
+{
+public:
+  class Counters
+  {
+  public:
+    Counters()
+      : nItems(0)
+      , nBytes(0)
+      , nCorruptedItems(0)
+      , nPasses(0)
+    {
+    }
+
+  public:
+    uint64_t nItems;          ///< records verified
+    uint64_t nBytes;          ///< bytes of Data verified
+    uint64_t nCorruptedItems; ///< records found damaged and quarantined
+    uint64_t nPasses;         ///< completed walks over the whole storage
+  };
+
+public:
+  Scrubber(RepoStorage& storageHandle, Scheduler& scheduler);
+
+  /**
+   *  @brief  verify about @p nBytesPerInterval bytes of Data every @p interval
+   */
+  void
+  start(const ndn::time::milliseconds& interval, size_t nBytesPerInterval);
+
+  /**
+   *  @brief  verify records following the current position
+   *  @param  nMaxBytes  stop once this many bytes of Data were verified
+   */
+  void
+  step(size_t nMaxBytes);
+
+  const Counters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
+  /**
+   *  @brief  get the id of the last verified record in the current pass
+   */
+  int64_t
+  getPosition() const
+  {
+    return m_lastId;
+  }
+
+  void
+  printStatistics(std::ostream& os) const;
+
+private:
+  void
+  verify(int64_t id, const ndn::Buffer& fullNameWire, const ndn::Buffer& dataWire);
+
+  void
+  onTimer();
+
+private:
+  RepoStorage& m_storageHandle;
+  Scheduler& m_scheduler;
+  ndn::time::milliseconds m_interval;
+  size_t m_nBytesPerInterval;
+  int64_t m_lastId;
+  Counters m_counters;
+  std::vector<std::pair<int64_t, Name> > m_corrupted;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_SCRUBBER_HPP
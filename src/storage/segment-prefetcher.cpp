@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "segment-prefetcher.hpp"
+
+namespace repo {
+
+static const size_t MAX_STREAMS = 4096;
+static const ndn::time::seconds STREAM_IDLE_TIME(10);
+
+SegmentPrefetcher::SegmentPrefetcher(boost::asio::io_service& ioService,
+                                     RepoStorage& storageHandle,
+                                     size_t maxDepth)
+  : m_ioService(ioService)
+  , m_storageHandle(storageHandle)
+  , m_maxDepth(maxDepth)
+  , m_nPrefetched(0)
+{
+}
+
+void
+SegmentPrefetcher::onRead(const Data& data)
+{
+  const Name& dataName = data.getName();
+  if (m_maxDepth == 0 || dataName.empty() || !dataName.get(-1).isSegment())
+    return;
+
+  Name prefix = dataName.getPrefix(-1);
+  uint64_t segment = dataName.get(-1).toSegment();
+  TimePoint now = ndn::time::steady_clock::now();
+
+  std::map<Name, Stream>::iterator it = m_streams.find(prefix);
+  if (it == m_streams.end()) {
+    if (m_streams.size() >= MAX_STREAMS)
+      pruneStreams(now);
+
+    Stream stream;
+    stream.lastSegment = segment;
+    stream.prefetchedUntil = segment;
+    stream.depth = 0;
+    stream.lastRead = now;
+    m_streams[prefix] = stream;
+    return;
+  }
+
+  Stream& stream = it->second;
+  stream.lastRead = now;
+  if (segment == stream.lastSegment + 1) {
+    stream.depth = std::min(std::max<size_t>(stream.depth * 2, 1), m_maxDepth);
+  }
+  else if (segment != stream.lastSegment) {
+    stream.depth = 0;
+    stream.prefetchedUntil = segment;
+  }
+  stream.lastSegment = segment;
+
+  if (stream.depth == 0)
+    return;
+
+  uint64_t last = segment + stream.depth;
+  const Name::Component& finalBlockId = data.getFinalBlockId();
+  if (!finalBlockId.empty() && finalBlockId.isSegment())
+    last = std::min(last, finalBlockId.toSegment());
+
+  uint64_t first = std::max(segment, stream.prefetchedUntil) + 1;
+  if (first > last)
+    return;
+
+  stream.prefetchedUntil = last;
+  m_ioService.post(bind(&SegmentPrefetcher::prefetch, this, prefix, first, last));
+}
+
+void
+SegmentPrefetcher::prefetch(const Name& prefix, uint64_t first, uint64_t last)
+{
+  for (uint64_t segment = first; segment <= last; ++segment) {
+    // the object ends at the first missing segment
+    if (!m_storageHandle.prefetchData(Name(prefix).appendSegment(segment)))
+      break;
+    ++m_nPrefetched;
+  }
+}
+
+void
+SegmentPrefetcher::pruneStreams(const TimePoint& now)
+{
+  std::map<Name, Stream>::iterator it = m_streams.begin();
+  while (it != m_streams.end()) {
+    if (now - it->second.lastRead > STREAM_IDLE_TIME)
+      m_streams.erase(it++);
+    else
+      ++it;
+  }
+
+  // many objects read at once, start over rather than tracking them all
+  if (m_streams.size() >= MAX_STREAMS)
+    m_streams.clear();
+}
+
+} // namespace repo
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_STORAGE_SEGMENT_PREFETCHER_HPP
+#define REPO_STORAGE_SEGMENT_PREFETCHER_HPP
+
+#include "repo-storage.hpp"
+
+#include <boost/asio/io_service.hpp>
+
+namespace repo {
+
+/**
+ * @brief loads the segments a consumer will ask for next into the read cache
+ *
+ * Reads of segmented names are tracked per object, i.e. per name without the segment
+ * component.  Each read of the segment following the previous one doubles the
+ * prefetch depth of the object up to the maximum, any other jump resets it to zero.
+ * The segments up to the current one plus the depth, but not beyond FinalBlockId,
+ * are read from the database in a handler posted to the io_service, after the Data
+ * that triggered it was answered.
+ */
+class SegmentPrefetcher : noncopyable
+{
+public:
+  /**
+   * @param maxDepth maximum number of segments loaded ahead of a read, 0 disables
+   */
+  SegmentPrefetcher(boost::asio::io_service& ioService, RepoStorage& storageHandle,
+                    size_t maxDepth);
+
+  /**
+   * @brief note that @p data was read, and prefetch the segments expected next
+   */
+  void
+  onRead(const Data& data);
+
+  /**
+   * @brief get the number of Data loaded ahead of a read
+   */
+  uint64_t
+  getNPrefetched() const
+  {
+    return m_nPrefetched;
+  }
+
+private:
+  typedef ndn::time::steady_clock::TimePoint TimePoint;
+
+  struct Stream
+  {
+    uint64_t lastSegment;
+    uint64_t prefetchedUntil;  ///< last segment requested from the database
+    size_t depth;
+    TimePoint lastRead;
+  };
+
+  void
+  prefetch(const Name& prefix, uint64_t first, uint64_t last);
+
+  /**
+   * @brief forget objects that have not been read for a while
+   */
+  void
+  pruneStreams(const TimePoint& now);
+
+private:
+  boost::asio::io_service& m_ioService;
+  RepoStorage& m_storageHandle;
+  size_t m_maxDepth;
+  std::map<Name, Stream> m_streams;
+  uint64_t m_nPrefetched;
+};
+
+} // namespace repo
+
+#endif // REPO_STORAGE_SEGMENT_PREFETCHER_HPP
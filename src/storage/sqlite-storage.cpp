@@ -20,16 +20,32 @@
 #include "../../build/src/config.hpp"
 #include "sqlite-storage.hpp"
 #include "index.hpp"
+#include "prefix-key.hpp"
 #include <boost/filesystem.hpp>
 #include <istream>
+#include <set>
 
 namespace repo {
 
 using std::string;
 
-SqliteStorage::SqliteStorage(const string& dbPath)
-  : m_size(0)
+// well below SQLITE_MAX_VARIABLE_NUMBER, which is 999 by default
+static const size_t MAX_READ_BATCH = 256;
+
+// how long a connection retries a lock another connection holds, in milliseconds
+static const int BUSY_TIMEOUT = 1000;
+
+SqliteStorage::SqliteStorage(const string& dbPath, const Options& options)
+  : m_options(options)
+  , m_isWal(false)
+  , m_isStopping(false)
 {
+  if (m_options.synchronous != "off" &&
+      m_options.synchronous != "normal" &&
+      m_options.synchronous != "full") {
+    throw Error("Unrecognized synchronous mode '" + m_options.synchronous + "'");
+  }
+
   if (dbPath.empty()) {
     std::cerr << "Create db file in local location [" << dbPath << "]. " << std::endl
               << "You can assign the path using -d option" << std::endl;
@@ -47,42 +63,346 @@ SqliteStorage::SqliteStorage(const string& dbPath)
     m_dbPath = dbPath + "/ndn_repo.db";
   }
   initializeRepo();
-}
 
+  if (m_options.checkpointInterval > ndn::time::milliseconds::zero())
+    startCheckpoints();
+}
 
-void
-SqliteStorage::initializeRepo()
+sqlite3*
+SqliteStorage::openConnection(int flags)
 {
-  char* errMsg = 0;
-
-  int rc = sqlite3_open_v2(m_dbPath.c_str(), &m_db,
-                           SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE,
+  sqlite3* db = 0;
+  int rc = sqlite3_open_v2(m_dbPath.c_str(), &db, flags,
 #ifdef DISABLE_SQLITE3_FS_LOCKING
                            "unix-dotfile"
 #else
                            0
 #endif
                            );
-
-  if (rc == SQLITE_OK) {
-    sqlite3_exec(m_db, "CREATE TABLE NDN_REPO ("
-                      "id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, "
-                      "name BLOB, "
-                      "data BLOB, "
-                      "keylocatorHash BLOB);\n "
-                 , 0, 0, &errMsg);
-    // Ignore errors (when database already exists, errors are expected)
-  }
-  else {
+  if (rc != SQLITE_OK) {
+    sqlite3_close(db);
     std::cerr << "Database file open failure rc:" << rc << std::endl;
     throw Error("Database file open failure");
   }
-  sqlite3_exec(m_db, "PRAGMA synchronous = OFF", 0, 0, &errMsg);
-  sqlite3_exec(m_db, "PRAGMA journal_mode = WAL", 0, 0, &errMsg);
+  // without WAL every lock is exclusive, so wait for the locks of other connections
+  // instead of failing with SQLITE_BUSY
+  sqlite3_busy_timeout(db, BUSY_TIMEOUT);
+  return db;
+}
+
+
+void
+SqliteStorage::initializeRepo()
+{
+  char* errMsg = 0;
+
+  m_db = openConnection(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+
+  // page_size and auto_vacuum must be set before the first table is created
+  applyOptions();
+  sqlite3_exec(m_db, "CREATE TABLE NDN_REPO ("
+                    "id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, "
+                    "name BLOB, "
+                    "data BLOB, "
+                    "keylocatorHash BLOB, "
+                    "prefixKey BLOB);\n "
+               , 0, 0, &errMsg);
+  // Ignore errors (when database already exists, errors are expected)
+
+  sqlite3_exec(m_db, "CREATE TABLE IF NOT EXISTS NDN_REPO_QUARANTINE ("
+                    "id INTEGER NOT NULL PRIMARY KEY, "
+                    "name BLOB, "
+                    "data BLOB);"
+               , 0, 0, &errMsg);
+  initializeStatistics();
+  initializePrefixKeys();
+
+  // auto_vacuum of an existing database can only be changed by a full VACUUM,
+  // which is exactly the blocking operation incremental vacuum is meant to avoid
+  if (m_options.incrementalVacuum && readPragma("auto_vacuum") != 2) {
+    std::cerr << "Database " << m_dbPath << " was created without incremental auto_vacuum, "
+              << "free pages cannot be reclaimed until it is converted by an offline VACUUM"
+              << std::endl;
+  }
+}
+
+void
+SqliteStorage::initializePrefixKeys()
+{
+  char* errMsg = 0;
+
+  // Databases created before the prefixKey column existed need it added;
+  // for newer databases this fails with "duplicate column", which is expected
+  sqlite3_exec(m_db, "ALTER TABLE NDN_REPO ADD COLUMN prefixKey BLOB;", 0, 0, 0);
+
+  // (prefixKey, keylocatorHash) plus the implicit rowid covers everything
+  // prefixEnumerate() needs, so prefix queries never touch the table itself
+  int rc = sqlite3_exec(m_db, "CREATE INDEX IF NOT EXISTS NDN_REPO_PREFIX_KEY "
+                              "ON NDN_REPO (prefixKey, keylocatorHash);"
+                        , 0, 0, &errMsg);
+  if (rc != SQLITE_OK) {
+    std::cerr << "prefix key index creation failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    throw Error("prefix key index creation failed");
+  }
+
+  // collect keys first, so that rows are not updated under a running SELECT
+  std::vector<std::pair<int64_t, ndn::Buffer> > keys;
+  sqlite3_stmt* queryStmt = 0;
+  string querySql("SELECT id, name FROM NDN_REPO WHERE prefixKey IS NULL;");
+  if (sqlite3_prepare_v2(m_db, querySql.c_str(), -1, &queryStmt, 0) != SQLITE_OK) {
+    sqlite3_finalize(queryStmt);
+    throw Error("prefix key migration prepare error");
+  }
+  try {
+    while ((rc = sqlite3_step(queryStmt)) == SQLITE_ROW) {
+      Name fullName;
+      fullName.wireDecode(Block(sqlite3_column_blob(queryStmt, 1),
+                                sqlite3_column_bytes(queryStmt, 1)));
+      keys.push_back(std::make_pair(sqlite3_column_int64(queryStmt, 0),
+                                    encodePrefixKey(fullName)));
+    }
+  }
+  catch (...) {
+    sqlite3_finalize(queryStmt);
+    throw;
+  }
+  sqlite3_finalize(queryStmt);
+  if (rc != SQLITE_DONE)
+    throw Error("prefix key migration error");
+
+  if (keys.empty())
+    return;
+
+  std::cerr << "Computing prefix keys for " << keys.size() << " entries" << std::endl;
+
+  sqlite3_stmt* updateStmt = 0;
+  string updateSql("UPDATE NDN_REPO SET prefixKey = ? WHERE id = ?;");
+  if (sqlite3_prepare_v2(m_db, updateSql.c_str(), -1, &updateStmt, 0) != SQLITE_OK) {
+    sqlite3_finalize(updateStmt);
+    throw Error("prefix key migration prepare error");
+  }
+
+  if (sqlite3_exec(m_db, "BEGIN TRANSACTION;", 0, 0, 0) != SQLITE_OK) {
+    sqlite3_finalize(updateStmt);
+    throw Error("prefix key migration error");
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const ndn::Buffer& key = keys[i].second;
+    if (sqlite3_bind_blob(updateStmt, 1, key.buf(), key.size(), 0) != SQLITE_OK ||
+        sqlite3_bind_int64(updateStmt, 2, keys[i].first) != SQLITE_OK ||
+        sqlite3_step(updateStmt) != SQLITE_DONE) {
+      sqlite3_finalize(updateStmt);
+      sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+      throw Error("prefix key migration error");
+    }
+    sqlite3_reset(updateStmt);
+  }
+  sqlite3_finalize(updateStmt);
+
+  if (sqlite3_exec(m_db, "COMMIT;", 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "prefix key migration commit failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw Error("prefix key migration error");
+  }
+}
+
+void
+SqliteStorage::applyOptions()
+{
+  char* errMsg = 0;
+
+  if (m_options.pageSize > 0) {
+    string sql = "PRAGMA page_size = " + std::to_string(m_options.pageSize);
+    sqlite3_exec(m_db, sql.c_str(), 0, 0, &errMsg);
+  }
+
+  if (m_options.incrementalVacuum) {
+    sqlite3_exec(m_db, "PRAGMA auto_vacuum = INCREMENTAL", 0, 0, &errMsg);
+  }
+
+  string synchronous = "PRAGMA synchronous = " + m_options.synchronous;
+  sqlite3_exec(m_db, synchronous.c_str(), 0, 0, &errMsg);
+
+  // the pragma reports the journal mode in effect, which is not WAL where WAL is unavailable
+  sqlite3_stmt* journalStmt = 0;
+  if (sqlite3_prepare_v2(m_db, "PRAGMA journal_mode = WAL", -1, &journalStmt, 0) == SQLITE_OK &&
+      sqlite3_step(journalStmt) == SQLITE_ROW) {
+    const char* mode = reinterpret_cast<const char*>(sqlite3_column_text(journalStmt, 0));
+    m_isWal = mode != 0 && string(mode) == "wal";
+  }
+  sqlite3_finalize(journalStmt);
+  if (!m_isWal)
+    std::cerr << "WAL journal mode is unavailable, using the rollback journal" << std::endl;
+
+  if (m_options.mmapSize >= 0) {
+    string sql = "PRAGMA mmap_size = " + std::to_string(m_options.mmapSize);
+    sqlite3_exec(m_db, sql.c_str(), 0, 0, &errMsg);
+  }
+
+  if (m_options.cacheSize != 0) {
+    string sql = "PRAGMA cache_size = " + std::to_string(m_options.cacheSize);
+    sqlite3_exec(m_db, sql.c_str(), 0, 0, &errMsg);
+  }
+}
+
+void
+SqliteStorage::startCheckpoints()
+{
+  if (!m_isWal) {
+    std::cerr << "WAL checkpoints are disabled, the database is not in WAL mode" << std::endl;
+    return;
+  }
+
+  sqlite3* db = 0;
+  try {
+    db = openConnection(SQLITE_OPEN_READWRITE);
+  }
+  catch (Error&) {
+    // the write path keeps checkpointing, so that the WAL stays bounded
+    std::cerr << "WAL checkpoints are disabled" << std::endl;
+    return;
+  }
+
+  sqlite3_exec(m_db, "PRAGMA wal_autocheckpoint = 0", 0, 0, 0);
+  m_checkpointThread = boost::thread(bind(&SqliteStorage::runCheckpoints, this, db));
+}
+
+void
+SqliteStorage::runCheckpoints(sqlite3* db)
+{
+  boost::posix_time::milliseconds interval(m_options.checkpointInterval.count());
+  boost::unique_lock<boost::mutex> lock(m_checkpointMutex);
+  while (!m_isStopping) {
+    m_checkpointCondition.timed_wait(lock, interval);
+    if (m_isStopping)
+      break;
+
+    lock.unlock();
+    int nLogFrames = 0;
+    int nCheckpointedFrames = 0;
+    int rc = sqlite3_wal_checkpoint_v2(db, 0, SQLITE_CHECKPOINT_PASSIVE,
+                                       &nLogFrames, &nCheckpointedFrames);
+    if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+      std::cerr << "WAL checkpoint failure rc:" << rc << std::endl;
+    }
+    lock.lock();
+  }
+  sqlite3_close(db);
+}
+
+int64_t
+SqliteStorage::reclaim(int64_t nPages)
+{
+  if (nPages <= 0)
+    return 0;
+
+  int64_t nFreePages = readPragma("freelist_count");
+  if (nFreePages == 0)
+    return 0;
+
+  char* errMsg = 0;
+  string sql = "PRAGMA incremental_vacuum(" + std::to_string(nPages) + ");";
+  if (sqlite3_exec(m_db, sql.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "incremental vacuum failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    throw Error("incremental vacuum failed");
+  }
+
+  return (nFreePages - readPragma("freelist_count")) * readPragma("page_size");
+}
+
+int64_t
+SqliteStorage::readPragma(const string& pragma)
+{
+  sqlite3_stmt* queryStmt = 0;
+  string sql("PRAGMA " + pragma + ";");
+  int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0);
+  if (rc != SQLITE_OK || sqlite3_step(queryStmt) != SQLITE_ROW) {
+    std::cerr << "PRAGMA " << pragma << " query failure rc:" << rc << std::endl;
+    sqlite3_finalize(queryStmt);
+    throw Error("PRAGMA query failure");
+  }
+
+  int64_t value = sqlite3_column_int64(queryStmt, 0);
+  sqlite3_finalize(queryStmt);
+  return value;
+}
+
+void
+SqliteStorage::initializeStatistics()
+{
+  char* errMsg = 0;
+
+  if (sqlite3_exec(m_db, "BEGIN TRANSACTION;", 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "statistics initialization failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    throw Error("statistics initialization failed");
+  }
+
+  // The triggers are executed as part of the INSERT or DELETE statement on NDN_REPO,
+  // so the counters can never diverge from the table content
+  int rc = sqlite3_exec(m_db, "CREATE TABLE IF NOT EXISTS NDN_REPO_STAT ("
+                              "id INTEGER NOT NULL PRIMARY KEY CHECK (id = 0), "
+                              "nItems INTEGER NOT NULL, "
+                              "nBytes INTEGER NOT NULL);\n"
+                              "CREATE TRIGGER IF NOT EXISTS NDN_REPO_STAT_INSERT "
+                              "AFTER INSERT ON NDN_REPO BEGIN "
+                              "UPDATE NDN_REPO_STAT SET nItems = nItems + 1, "
+                              "nBytes = nBytes + length(NEW.data) WHERE id = 0; "
+                              "END;\n"
+                              "CREATE TRIGGER IF NOT EXISTS NDN_REPO_STAT_DELETE "
+                              "AFTER DELETE ON NDN_REPO BEGIN "
+                              "UPDATE NDN_REPO_STAT SET nItems = nItems - 1, "
+                              "nBytes = nBytes - length(OLD.data) WHERE id = 0; "
+                              "END;"
+                        , 0, 0, &errMsg);
+  if (rc != SQLITE_OK) {
+    std::cerr << "statistics initialization failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw Error("statistics initialization failed");
+  }
+
+  sqlite3_stmt* queryStmt = 0;
+  string sql("SELECT count(*) FROM NDN_REPO_STAT;");
+  rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0);
+  if (rc != SQLITE_OK || sqlite3_step(queryStmt) != SQLITE_ROW) {
+    std::cerr << "Database query failure rc:" << rc << std::endl;
+    sqlite3_finalize(queryStmt);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw Error("Database query failure");
+  }
+  bool hasStatistics = sqlite3_column_int64(queryStmt, 0) > 0;
+  sqlite3_finalize(queryStmt);
+
+  if (!hasStatistics) {
+    // database created before NDN_REPO_STAT existed, or a brand new one
+    rc = sqlite3_exec(m_db, "INSERT INTO NDN_REPO_STAT (id, nItems, nBytes) "
+                            "SELECT 0, count(*), ifnull(sum(length(data)), 0) FROM NDN_REPO;"
+                      , 0, 0, &errMsg);
+    if (rc != SQLITE_OK) {
+      std::cerr << "statistics initialization failed: " << errMsg << std::endl;
+      sqlite3_free(errMsg);
+      sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+      throw Error("statistics initialization failed");
+    }
+  }
+
+  sqlite3_exec(m_db, "COMMIT;", 0, 0, &errMsg);
 }
 
 SqliteStorage::~SqliteStorage()
 {
+  {
+    boost::lock_guard<boost::mutex> lock(m_checkpointMutex);
+    m_isStopping = true;
+  }
+  m_checkpointCondition.notify_all();
+  if (m_checkpointThread.joinable())
+    m_checkpointThread.join();
+
   sqlite3_close(m_db);
 }
 
@@ -96,7 +416,6 @@ SqliteStorage::fullEnumerate(const ndn::function
   rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &m_stmt, 0);
   if (rc != SQLITE_OK)
     throw Error("Initiation Read Entries from Database Prepare error");
-  int entryNumber = 0;
   while (true) {
     rc = sqlite3_step(m_stmt);
     if (rc == SQLITE_ROW) {
@@ -104,9 +423,10 @@ SqliteStorage::fullEnumerate(const ndn::function
       ItemMeta item;
       item.fullName.wireDecode(Block(sqlite3_column_blob(m_stmt, 1),
                                      sqlite3_column_bytes(m_stmt, 1)));
-      item.id = sqlite3_column_int(m_stmt, 0);
-      item.keyLocatorHash = make_shared<const ndn::Buffer>
-        (ndn::Buffer(sqlite3_column_blob(m_stmt, 3), sqlite3_column_bytes(m_stmt, 3)));
+      item.id = sqlite3_column_int64(m_stmt, 0);
+      if (sqlite3_column_type(m_stmt, 2) != SQLITE_NULL)
+        item.keyLocatorHash = make_shared<const ndn::Buffer>
+          (ndn::Buffer(sqlite3_column_blob(m_stmt, 2), sqlite3_column_bytes(m_stmt, 2)));
 
       try {
         f(item);
@@ -115,7 +435,6 @@ SqliteStorage::fullEnumerate(const ndn::function
         sqlite3_finalize(m_stmt);
         throw;
       }
-      entryNumber++;
     }
     else if (rc == SQLITE_DONE) {
       sqlite3_finalize(m_stmt);
@@ -127,58 +446,121 @@ SqliteStorage::fullEnumerate(const ndn::function
       throw Error("Initiation Read Entries error");
     }
   }
-  m_size = entryNumber;
 }
 
 int64_t
-SqliteStorage::insert(const Data& data)
+SqliteStorage::insert(const PreparedData& data)
 {
-  Name name = data.getName();
-
-  Index::Entry entry(data, 0); //the id is not used
+  sqlite3_stmt* insertStmt = prepareInsert();
   int64_t id = -1;
-  if (name.empty()) {
-    std::cerr << "name is empty" << std::endl;
-    return -1;
+  try {
+    id = executeInsert(insertStmt, data);
+  }
+  catch (...) {
+    sqlite3_finalize(insertStmt);
+    throw;
+  }
+  sqlite3_finalize(insertStmt);
+  return id;
+}
+
+std::vector<int64_t>
+SqliteStorage::insertBatch(const std::vector<shared_ptr<const PreparedData> >& data)
+{
+  std::vector<int64_t> ids;
+  if (data.empty())
+    return ids;
+
+  sqlite3_stmt* insertStmt = prepareInsert();
+  char* errMsg = 0;
+  if (sqlite3_exec(m_db, "BEGIN TRANSACTION;", 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "batch insert cannot begin a transaction: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    sqlite3_finalize(insertStmt);
+    throw Error("batch insert cannot begin a transaction");
+  }
+  try {
+    for (size_t i = 0; i < data.size(); ++i) {
+      ids.push_back(executeInsert(insertStmt, *data[i]));
+    }
+  }
+  catch (...) {
+    sqlite3_finalize(insertStmt);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw;
   }
+  sqlite3_finalize(insertStmt);
 
-  int rc = 0;
+  if (sqlite3_exec(m_db, "COMMIT;", 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "batch insert commit failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw Error("batch insert commit failed");
+  }
+  return ids;
+}
 
+sqlite3_stmt*
+SqliteStorage::prepareInsert()
+{
   sqlite3_stmt* insertStmt = 0;
 
-  string insertSql = string("INSERT INTO NDN_REPO (id, name, data, keylocatorHash) "
-                            "VALUES (?, ?, ?, ?)");
+  string insertSql = string("INSERT INTO NDN_REPO (id, name, data, keylocatorHash, prefixKey) "
+                            "VALUES (?, ?, ?, ?, ?)");
 
   if (sqlite3_prepare_v2(m_db, insertSql.c_str(), -1, &insertStmt, 0) != SQLITE_OK) {
     sqlite3_finalize(insertStmt);
     std::cerr << "insert sql not prepared" << std::endl;
+    throw Error("insert sql not prepared");
   }
+  return insertStmt;
+}
+
+int64_t
+SqliteStorage::executeInsert(sqlite3_stmt* insertStmt, const PreparedData& data)
+{
+  int64_t id = -1;
+  // the full name of a Data with empty name has only the implicit digest
+  if (data.fullName.size() <= 1) {
+    std::cerr << "name is empty" << std::endl;
+    return -1;
+  }
+
+  const ndn::ConstBufferPtr& keyLocatorHash = data.keyLocatorHash;
+  ndn::Buffer prefixKey = encodePrefixKey(data.fullName);
+
+  // Data without KeyLocator are stored with NULL keylocatorHash
+  int rc = keyLocatorHash == 0 ?
+       sqlite3_bind_null(insertStmt, 4) :
+       sqlite3_bind_blob(insertStmt, 4, keyLocatorHash->buf(), keyLocatorHash->size(), 0);
+
   //Insert
-  if (sqlite3_bind_null(insertStmt, 1) == SQLITE_OK &&
+  if (rc == SQLITE_OK &&
+      sqlite3_bind_null(insertStmt, 1) == SQLITE_OK &&
       sqlite3_bind_blob(insertStmt, 2,
-                        entry.getName().wireEncode().wire(),
-                        entry.getName().wireEncode().size(), 0) == SQLITE_OK &&
+                        data.fullNameWire.wire(),
+                        data.fullNameWire.size(), 0) == SQLITE_OK &&
       sqlite3_bind_blob(insertStmt, 3,
-                        data.wireEncode().wire(),
-                        data.wireEncode().size(),0 ) == SQLITE_OK &&
-      sqlite3_bind_blob(insertStmt, 4,
-                        (const void*)&(*entry.getKeyLocatorHash()),
-                        ndn::crypto::SHA256_DIGEST_SIZE,0) == SQLITE_OK) {
+                        data.wire.wire(),
+                        data.wire.size(),0 ) == SQLITE_OK &&
+      sqlite3_bind_blob(insertStmt, 5, prefixKey.buf(), prefixKey.size(), 0) == SQLITE_OK) {
     rc = sqlite3_step(insertStmt);
     if (rc == SQLITE_CONSTRAINT) {
       std::cerr << "Insert  failed" << std::endl;
-      sqlite3_finalize(insertStmt);
       throw Error("Insert failed");
      }
     sqlite3_reset(insertStmt);
-     m_size++;
-     id = sqlite3_last_insert_rowid(m_db);
+    // on SQLITE_BUSY and the like, last_insert_rowid is that of an earlier insert
+    if (rc != SQLITE_DONE) {
+      std::cerr << "Insert failed rc:" << rc << std::endl;
+      return -1;
+    }
+    id = sqlite3_last_insert_rowid(m_db);
   }
   else {
     throw Error("Some error with insert");
   }
 
-  sqlite3_finalize(insertStmt);
   return id;
 }
 
@@ -205,7 +587,6 @@ SqliteStorage::erase(const int64_t id)
     }
     if (sqlite3_changes(m_db) != 1)
       return false;
-    m_size--;
   }
   else {
     std::cerr << "delete bind error" << std::endl;
@@ -217,12 +598,223 @@ SqliteStorage::erase(const int64_t id)
 }
 
 
+void
+SqliteStorage::prefixEnumerate(const Name& prefix,
+                               const std::function<void(const Storage::ItemMeta)>& f)
+{
+  ndn::Buffer lowerKey = encodePrefixKey(prefix);
+  ndn::Buffer upperKey = getPrefixKeySuccessor(lowerKey);
+
+  sqlite3_stmt* queryStmt = 0;
+  string sql = upperKey.empty() ?
+    "SELECT id, prefixKey, keylocatorHash FROM NDN_REPO "
+    "WHERE prefixKey >= ? ORDER BY prefixKey;" :
+    "SELECT id, prefixKey, keylocatorHash FROM NDN_REPO "
+    "WHERE prefixKey >= ? AND prefixKey < ? ORDER BY prefixKey;";
+  int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0);
+  if (rc != SQLITE_OK) {
+    sqlite3_finalize(queryStmt);
+    throw Error("Prefix enumeration prepare error");
+  }
+
+  if (sqlite3_bind_blob(queryStmt, 1, lowerKey.buf(), lowerKey.size(), 0) != SQLITE_OK ||
+      (!upperKey.empty() &&
+       sqlite3_bind_blob(queryStmt, 2, upperKey.buf(), upperKey.size(), 0) != SQLITE_OK)) {
+    sqlite3_finalize(queryStmt);
+    throw Error("Prefix enumeration bind error");
+  }
+
+  while (true) {
+    rc = sqlite3_step(queryStmt);
+    if (rc == SQLITE_ROW) {
+      ItemMeta item;
+      item.id = sqlite3_column_int64(queryStmt, 0);
+      const uint8_t* key = static_cast<const uint8_t*>(sqlite3_column_blob(queryStmt, 1));
+      item.fullName = decodePrefixKey(key, sqlite3_column_bytes(queryStmt, 1));
+      if (sqlite3_column_type(queryStmt, 2) != SQLITE_NULL)
+        item.keyLocatorHash = make_shared<const ndn::Buffer>
+          (ndn::Buffer(sqlite3_column_blob(queryStmt, 2), sqlite3_column_bytes(queryStmt, 2)));
+
+      try {
+        f(item);
+      }
+      catch (...) {
+        sqlite3_finalize(queryStmt);
+        throw;
+      }
+    }
+    else if (rc == SQLITE_DONE) {
+      sqlite3_finalize(queryStmt);
+      break;
+    }
+    else {
+      std::cerr << "Prefix enumeration rc:" << rc << std::endl;
+      sqlite3_finalize(queryStmt);
+      throw Error("Prefix enumeration error");
+    }
+  }
+}
+
+int64_t
+SqliteStorage::erase(const Name& prefix)
+{
+  ndn::Buffer lowerKey = encodePrefixKey(prefix);
+  ndn::Buffer upperKey = getPrefixKeySuccessor(lowerKey);
+
+  sqlite3_stmt* deleteStmt = 0;
+  string sql = upperKey.empty() ?
+    "DELETE FROM NDN_REPO WHERE prefixKey >= ?;" :
+    "DELETE FROM NDN_REPO WHERE prefixKey >= ? AND prefixKey < ?;";
+  if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &deleteStmt, 0) != SQLITE_OK) {
+    sqlite3_finalize(deleteStmt);
+    std::cerr << "range delete statement prepared failed" << std::endl;
+    throw Error("range delete statement prepared failed");
+  }
+
+  if (sqlite3_bind_blob(deleteStmt, 1, lowerKey.buf(), lowerKey.size(), 0) != SQLITE_OK ||
+      (!upperKey.empty() &&
+       sqlite3_bind_blob(deleteStmt, 2, upperKey.buf(), upperKey.size(), 0) != SQLITE_OK)) {
+    sqlite3_finalize(deleteStmt);
+    std::cerr << "range delete bind error" << std::endl;
+    throw Error("range delete bind error");
+  }
+
+  int rc = sqlite3_step(deleteStmt);
+  if (rc != SQLITE_DONE) {
+    std::cerr << "range delete error rc:" << rc << std::endl;
+    sqlite3_finalize(deleteStmt);
+    throw Error("range delete error");
+  }
+  sqlite3_finalize(deleteStmt);
+  return sqlite3_changes(m_db);
+}
+
+int64_t
+SqliteStorage::scan(int64_t lastId, size_t maxBytes,
+                    const std::function<void(int64_t, const ndn::Buffer&,
+                                             const ndn::Buffer&)>& f)
+{
+  sqlite3_stmt* queryStmt = 0;
+  string sql("SELECT id, name, data FROM NDN_REPO WHERE id > ? ORDER BY id;");
+  if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0) != SQLITE_OK) {
+    sqlite3_finalize(queryStmt);
+    throw Error("Scan prepare error");
+  }
+  if (sqlite3_bind_int64(queryStmt, 1, lastId) != SQLITE_OK) {
+    sqlite3_finalize(queryStmt);
+    throw Error("Scan bind error");
+  }
+
+  size_t nBytes = 0;
+  while (nBytes < maxBytes) {
+    int rc = sqlite3_step(queryStmt);
+    if (rc == SQLITE_ROW) {
+      lastId = sqlite3_column_int64(queryStmt, 0);
+      ndn::Buffer name(sqlite3_column_blob(queryStmt, 1), sqlite3_column_bytes(queryStmt, 1));
+      ndn::Buffer data(sqlite3_column_blob(queryStmt, 2), sqlite3_column_bytes(queryStmt, 2));
+      nBytes += data.size();
+
+      try {
+        f(lastId, name, data);
+      }
+      catch (...) {
+        sqlite3_finalize(queryStmt);
+        throw;
+      }
+    }
+    else if (rc == SQLITE_DONE) {
+      break;
+    }
+    else {
+      std::cerr << "Scan rc:" << rc << std::endl;
+      sqlite3_finalize(queryStmt);
+      throw Error("Scan error");
+    }
+  }
+  sqlite3_finalize(queryStmt);
+  return lastId;
+}
+
+bool
+SqliteStorage::quarantine(const int64_t id)
+{
+  char* errMsg = 0;
+  string idString = std::to_string(id);
+  string sql = "BEGIN TRANSACTION;\n"
+               "INSERT OR REPLACE INTO NDN_REPO_QUARANTINE (id, name, data) "
+               "SELECT id, name, data FROM NDN_REPO WHERE id = " + idString + ";\n"
+               "DELETE FROM NDN_REPO WHERE id = " + idString + ";\n"
+               "COMMIT;";
+  if (sqlite3_exec(m_db, sql.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+    std::cerr << "quarantine failed: " << errMsg << std::endl;
+    sqlite3_free(errMsg);
+    sqlite3_exec(m_db, "ROLLBACK;", 0, 0, 0);
+    throw Error("quarantine failed");
+  }
+  return sqlite3_changes(m_db) == 1;
+}
+
 shared_ptr<Data>
 SqliteStorage::read(const int64_t id)
+{
+  return readRecord(m_db, id);
+}
+
+/**
+ * @brief reads records through a read-only connection, which no other thread uses
+ */
+class SqliteStorage::ConnectionReader : public Storage::Reader
+{
+public:
+  explicit
+  ConnectionReader(sqlite3* db)
+    : m_db(db)
+  {
+  }
+
+  virtual
+  ~ConnectionReader()
+  {
+    sqlite3_close(m_db);
+  }
+
+  virtual shared_ptr<Data>
+  read(int64_t id)
+  {
+    return readRecord(m_db, id);
+  }
+
+private:
+  sqlite3* m_db;
+};
+
+shared_ptr<Storage::Reader>
+SqliteStorage::openReader()
+{
+  // a reader next to the writer needs WAL; with a rollback journal it would hold
+  // locks the writer has to wait for
+  if (!m_isWal)
+    return shared_ptr<Storage::Reader>();
+
+  // the connection is never shared between threads, so it needs no mutex
+  sqlite3* db = openConnection(SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+  if (m_options.mmapSize >= 0) {
+    string sql = "PRAGMA mmap_size = " + std::to_string(m_options.mmapSize);
+    sqlite3_exec(db, sql.c_str(), 0, 0, 0);
+  }
+  if (m_options.cacheSize != 0) {
+    string sql = "PRAGMA cache_size = " + std::to_string(m_options.cacheSize);
+    sqlite3_exec(db, sql.c_str(), 0, 0, 0);
+  }
+  return make_shared<ConnectionReader>(db);
+}
+
+shared_ptr<Data>
+SqliteStorage::readRecord(sqlite3* db, const int64_t id)
 {
   sqlite3_stmt* queryStmt = 0;
   string sql = string("SELECT * FROM NDN_REPO WHERE id = ? ;");
-  int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0);
+  int rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &queryStmt, 0);
   if (rc == SQLITE_OK) {
     if (sqlite3_bind_int64(queryStmt, 1, id) == SQLITE_OK) {
       rc = sqlite3_step(queryStmt);
@@ -234,6 +826,7 @@ SqliteStorage::read(const int64_t id)
         return data;
       }
       else if (rc == SQLITE_DONE) {
+        sqlite3_finalize(queryStmt);
         return shared_ptr<Data>();
       }
       else {
@@ -257,11 +850,84 @@ SqliteStorage::read(const int64_t id)
   return shared_ptr<Data>();
 }
 
+std::vector<shared_ptr<Data> >
+SqliteStorage::readBatch(const std::vector<int64_t>& ids)
+{
+  std::map<int64_t, shared_ptr<Data> > found;
+  std::set<int64_t> uniqueIds(ids.begin(), ids.end());
+  std::set<int64_t>::const_iterator next = uniqueIds.begin();
+  while (next != uniqueIds.end()) {
+    std::vector<int64_t> chunk;
+    for (; next != uniqueIds.end() && chunk.size() < MAX_READ_BATCH; ++next)
+      chunk.push_back(*next);
+
+    string sql("SELECT id, data FROM NDN_REPO WHERE id IN (?");
+    for (size_t i = 1; i < chunk.size(); ++i)
+      sql += ", ?";
+    sql += ");";
+
+    sqlite3_stmt* queryStmt = 0;
+    if (sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0) != SQLITE_OK) {
+      sqlite3_finalize(queryStmt);
+      std::cerr << "select statement prepared failed" << std::endl;
+      throw Error("select statement prepared failed");
+    }
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      if (sqlite3_bind_int64(queryStmt, i + 1, chunk[i]) != SQLITE_OK) {
+        std::cerr << "select bind error" << std::endl;
+        sqlite3_finalize(queryStmt);
+        throw Error("select bind error");
+      }
+    }
+
+    int rc = 0;
+    while ((rc = sqlite3_step(queryStmt)) == SQLITE_ROW) {
+      int64_t id = sqlite3_column_int64(queryStmt, 0);
+      shared_ptr<Data> data(new Data());
+      try {
+        data->wireDecode(Block(sqlite3_column_blob(queryStmt, 1),
+                               sqlite3_column_bytes(queryStmt, 1)));
+      }
+      catch (ndn::tlv::Error& e) {
+        // a damaged record is not found, the scrubber will quarantine it
+        std::cerr << "Record " << id << " cannot be decoded: " << e.what() << std::endl;
+        continue;
+      }
+      found[id] = data;
+    }
+    sqlite3_finalize(queryStmt);
+    if (rc != SQLITE_DONE) {
+      std::cerr << "Database query failure rc:" << rc << std::endl;
+      throw Error("Database query failure");
+    }
+  }
+
+  std::vector<shared_ptr<Data> > data;
+  data.reserve(ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    std::map<int64_t, shared_ptr<Data> >::const_iterator it = found.find(ids[i]);
+    data.push_back(it == found.end() ? shared_ptr<Data>() : it->second);
+  }
+  return data;
+}
+
 int64_t
 SqliteStorage::size()
+{
+  return readStatistics("nItems");
+}
+
+int64_t
+SqliteStorage::byteSize()
+{
+  return readStatistics("nBytes");
+}
+
+int64_t
+SqliteStorage::readStatistics(const string& column)
 {
   sqlite3_stmt* queryStmt = 0;
-  string sql("SELECT count(*) FROM NDN_REPO ");
+  string sql("SELECT " + column + " FROM NDN_REPO_STAT WHERE id = 0;");
   int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &queryStmt, 0);
   if (rc != SQLITE_OK)
     {
@@ -278,11 +944,9 @@ SqliteStorage::size()
       throw Error("Database query failure");
     }
 
-  int64_t nDatas = sqlite3_column_int64(queryStmt, 0);
-  if (m_size != nDatas) {
-    std::cerr << "The size of database is not correct! " << std::endl;
-  }
-  return nDatas;
+  int64_t value = sqlite3_column_int64(queryStmt, 0);
+  sqlite3_finalize(queryStmt);
+  return value;
 }
 
 } //namespace repo
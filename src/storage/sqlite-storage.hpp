@@ -30,6 +30,10 @@
 #include <queue>
 #include <algorithm>
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
 namespace repo {
 
 using std::queue;
@@ -37,29 +41,79 @@ using std::queue;
 class SqliteStorage : public Storage
 {
 public:
-  class Error : public std::runtime_error
+  class Error : public Storage::Error
   {
   public:
     explicit
     Error(const std::string& what)
-      : std::runtime_error(what)
+      : Storage::Error(what)
     {
     }
   };
 
+  /**
+   * @brief tunables applied when the database is opened
+   */
+  class Options
+  {
+  public:
+    Options()
+      : synchronous("off")
+      , mmapSize(-1)
+      , cacheSize(0)
+      , pageSize(0)
+      , checkpointInterval(0)
+      , incrementalVacuum(false)
+    {
+    }
+
+  public:
+    std::string synchronous; ///< durability level: "off", "normal" or "full"
+    int64_t mmapSize;        ///< PRAGMA mmap_size in bytes, negative keeps SQLite default
+    int64_t cacheSize;       ///< PRAGMA cache_size, 0 keeps SQLite default
+    int64_t pageSize;        ///< PRAGMA page_size, takes effect only for a new database
+    /// period of passive WAL checkpoints on a background thread,
+    /// 0 leaves checkpoints to SQLite on the write path
+    ndn::time::milliseconds checkpointInterval;
+    bool incrementalVacuum;  ///< create new database with auto_vacuum = INCREMENTAL
+  };
+
   explicit
-  SqliteStorage(const std::string& dbPath);
+  SqliteStorage(const std::string& dbPath, const Options& options = Options());
 
   virtual
   ~SqliteStorage();
 
+  /**
+   *  @brief  whether the database is in WAL journal mode
+   *
+   *  WAL needs shared memory, which the unix-dotfile VFS of builds without SQLite file
+   *  locking does not have.  Background checkpoints run only in WAL mode.
+   */
+  bool
+  isWal() const
+  {
+    return m_isWal;
+  }
+
   /**
    *  @brief  put the data into database
    *  @param  data     the data should be inserted into databse
    *  @return int64_t  the id number of each entry in the database
    */
   virtual int64_t
-  insert(const Data& data);
+  insert(const PreparedData& data);
+
+  using Storage::insert;
+
+  /**
+   *  @brief  put several data into database in a single transaction
+   *
+   *  Either all data are inserted or, if any insertion fails, none is.
+   *  @throw  Error  insertion failed, the transaction is rolled back
+   */
+  virtual std::vector<int64_t>
+  insertBatch(const std::vector<shared_ptr<const PreparedData> >& data);
 
   /**
    *  @brief  remove the entry in the database by using id
@@ -68,6 +122,15 @@ public:
   virtual bool
   erase(const int64_t id);
 
+  /**
+   *  @brief  remove all entries whose full name is under a prefix
+   *
+   *  Executed as a single range DELETE over the prefixKey index.
+   *  @return number of removed entries
+   */
+  virtual int64_t
+  erase(const Name& prefix);
+
   /**
    *  @brief  get the data from database
    *  @para   id   id number of each entry in the database, used to find the data
@@ -75,12 +138,39 @@ public:
   virtual std::shared_ptr<Data>
   read(const int64_t id);
 
+  /**
+   *  @brief  open a read-only connection to the database for another thread
+   *  @return null if the database is not in WAL mode, see isWal()
+   */
+  virtual shared_ptr<Storage::Reader>
+  openReader();
+
+  /**
+   *  @brief  get several data with one SELECT ... WHERE id IN (...) per
+   *          MAX_READ_BATCH ids, rather than one query per id
+   *
+   *  Each id is decoded once even if it is requested several times.  A record that
+   *  cannot be decoded is returned as null, so that it does not fail the whole batch.
+   *  @throw Error the query failed
+   */
+  virtual std::vector<shared_ptr<Data> >
+  readBatch(const std::vector<int64_t>& ids);
+
   /**
    *  @brief  return the size of database
+   *
+   *  The value is read from the NDN_REPO_STAT table, which is kept in step with
+   *  NDN_REPO by triggers, so no table scan is needed.
    */
   virtual int64_t
   size();
 
+  /**
+   *  @brief  return the total size in bytes of all Data stored in database
+   */
+  virtual int64_t
+  byteSize();
+
   /**
    *  @brief enumerate each entry in database and call the function
    *         insertItemToIndex to reubuild index from database
@@ -88,14 +178,127 @@ public:
   void
   fullEnumerate(const std::function<void(const Storage::ItemMeta)>& f);
 
+  /**
+   *  @brief enumerate entries whose full name is under a prefix in name order
+   *
+   *  Executed as a range scan over the covering prefixKey index, without reading
+   *  the table and without the in-memory Index.
+   */
+  virtual void
+  prefixEnumerate(const Name& prefix,
+                  const std::function<void(const Storage::ItemMeta)>& f);
+
+  /**
+   *  @brief release up to @p nPages pages from the freelist
+   *
+   *  Runs PRAGMA incremental_vacuum, which truncates the database file by moving
+   *  pages from its end into free slots.  Its cost is bounded by @p nPages, unlike
+   *  VACUUM which rewrites the whole database.  This has no effect unless the
+   *  database was created with auto_vacuum = INCREMENTAL.
+   *  @return number of bytes removed from the database file
+   */
+  virtual int64_t
+  reclaim(int64_t nPages);
+
+  virtual int64_t
+  scan(int64_t lastId, size_t maxBytes,
+       const std::function<void(int64_t, const ndn::Buffer&, const ndn::Buffer&)>& f);
+
+  /**
+   *  @brief  move a record from NDN_REPO into NDN_REPO_QUARANTINE
+   *
+   *  The record keeps its id, so it can be inspected or restored manually later.
+   */
+  virtual bool
+  quarantine(const int64_t id);
+
 private:
+  class ConnectionReader;
+
+  /**
+   *  @brief open another connection to the database file
+   */
+  sqlite3*
+  openConnection(int flags);
+
+  /**
+   *  @brief read a record through @p db
+   */
+  static shared_ptr<Data>
+  readRecord(sqlite3* db, const int64_t id);
+
   void
   initializeRepo();
 
+  /**
+   *  @brief create NDN_REPO_STAT table and its triggers if they do not exist yet
+   *
+   *  When the table is created for an existing database, it is seeded with a
+   *  single full count, so that later size queries are constant time.
+   */
+  void
+  initializeStatistics();
+
+  /**
+   *  @brief read one column of the single NDN_REPO_STAT row
+   */
+  int64_t
+  readStatistics(const std::string& column);
+
+  /**
+   *  @brief add prefixKey column and its index, and compute missing keys
+   *
+   *  prefixKey holds the order-preserving encoding of the full name produced by
+   *  encodePrefixKey(), so that prefix queries become SQL range scans.
+   */
+  void
+  initializePrefixKeys();
+
+  void
+  applyOptions();
+
+  /**
+   *  @brief take over WAL checkpoints from the write path, if a connection for them opens
+   */
+  void
+  startCheckpoints();
+
+  /**
+   *  @brief run a passive WAL checkpoint every checkpointInterval until stopped
+   *
+   *  Runs on m_checkpointThread with the connection @p db of its own, which it closes.
+   *  A passive checkpoint copies as many frames as it can without waiting for database
+   *  locks, so neither the main connection nor the checkpoint ever waits for the other.
+   */
+  void
+  runCheckpoints(sqlite3* db);
+
+  sqlite3_stmt*
+  prepareInsert();
+
+  /**
+   *  @brief  bind data to a prepared INSERT statement and execute it
+   *  @return the id number of the entry, or -1 if data was not inserted
+   */
+  int64_t
+  executeInsert(sqlite3_stmt* insertStmt, const PreparedData& data);
+
+  /**
+   *  @brief read the integer value of a PRAGMA
+   */
+  int64_t
+  readPragma(const std::string& pragma);
+
 private:
   sqlite3* m_db;
   std::string m_dbPath;
-  int64_t m_size;
+  Options m_options;
+  bool m_isWal;
+
+  boost::thread m_checkpointThread;
+  boost::mutex m_checkpointMutex;
+  boost::condition_variable m_checkpointCondition;
+  bool m_isStopping;
 };
 
 
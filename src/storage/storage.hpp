@@ -23,6 +23,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include "../common.hpp"
+#include "prepared-data.hpp"
 
 namespace repo {
 
@@ -51,6 +52,26 @@ public:
     ndn::ConstBufferPtr keyLocatorHash;
   };
 
+  /**
+   * @brief reads records on a thread other than the one using the Storage
+   *
+   * A Reader is used by one thread at a time.
+   */
+  class Reader : noncopyable
+  {
+  public:
+    virtual
+    ~Reader()
+    {
+    }
+
+    /**
+     * @return null if the record does not exist
+     */
+    virtual shared_ptr<Data>
+    read(int64_t id) = 0;
+  };
+
 public :
 
   virtual
@@ -63,7 +84,29 @@ public :
    *  @param  data   the data should be inserted into databse
    */
   virtual int64_t
-  insert(const Data& data) = 0;
+  insert(const PreparedData& data) = 0;
+
+  /**
+   *  @brief  put the data into database
+   */
+  int64_t
+  insert(const Data& data)
+  {
+    return insert(PreparedData(data));
+  }
+
+  /**
+   *  @brief  put several data into database as one unit of work
+   *  @return the id number of each entry, or -1 for data that were not inserted
+   */
+  virtual std::vector<int64_t>
+  insertBatch(const std::vector<shared_ptr<const PreparedData> >& data)
+  {
+    std::vector<int64_t> ids;
+    for (size_t i = 0; i < data.size(); ++i)
+      ids.push_back(insert(*data[i]));
+    return ids;
+  }
 
   /**
    *  @brief  remove the entry in the database by using id
@@ -72,6 +115,14 @@ public :
   virtual bool
   erase(const int64_t id) = 0;
 
+  /**
+   *  @brief  remove all entries whose full name is under a prefix
+   *  @param  prefix  name prefix of entries to be removed
+   *  @return number of removed entries
+   */
+  virtual int64_t
+  erase(const Name& prefix) = 0;
+
   /**
    *  @brief  get the data from database
    *  @param  id   id number of each entry in the database, used to find the data
@@ -79,12 +130,41 @@ public :
   virtual std::shared_ptr<Data>
   read(const int64_t id) = 0;
 
+  /**
+   *  @brief  open a Reader with a connection of its own to the database
+   *  @return null if records can only be read through this storage
+   */
+  virtual shared_ptr<Reader>
+  openReader()
+  {
+    return shared_ptr<Reader>();
+  }
+
+  /**
+   *  @brief  get several data from database at once
+   *  @return data of each id in the same order, or null for ids that are not stored
+   */
+  virtual std::vector<shared_ptr<Data> >
+  readBatch(const std::vector<int64_t>& ids)
+  {
+    std::vector<shared_ptr<Data> > data;
+    for (size_t i = 0; i < ids.size(); ++i)
+      data.push_back(read(ids[i]));
+    return data;
+  }
+
   /**
    *  @brief  return the size of database
    */
   virtual int64_t
   size() = 0;
 
+  /**
+   *  @brief  return the total size in bytes of all Data stored in database
+   */
+  virtual int64_t
+  byteSize() = 0;
+
   /**
    *  @brief enumerate each entry in database and call the function
    *         insertItemToIndex to reubuild index from database
@@ -92,6 +172,50 @@ public :
   virtual void
   fullEnumerate(const std::function<void(const Storage::ItemMeta)>& f) = 0;
 
+  /**
+   *  @brief enumerate entries whose full name is under a prefix in name order
+   */
+  virtual void
+  prefixEnumerate(const Name& prefix,
+                  const std::function<void(const Storage::ItemMeta)>& f) = 0;
+
+  /**
+   *  @brief return up to @p nPages unused pages to the file system
+   *
+   *  Storage engines that cannot shrink incrementally do not need to override this.
+   *  @return number of bytes released
+   */
+  virtual int64_t
+  reclaim(int64_t nPages)
+  {
+    return 0;
+  }
+
+  /**
+   *  @brief visit stored records in ascending id order
+   *
+   *  Records are passed as stored, without decoding, so that damaged ones can be
+   *  recognized by the caller.
+   *  @param  lastId   only records with id greater than this are visited
+   *  @param  maxBytes stop once the visited Data together are at least this large
+   *  @param  f        called with id, encoded full name and Data wire of each record
+   *  @return id of the last visited record, or @p lastId if there is none
+   */
+  virtual int64_t
+  scan(int64_t lastId, size_t maxBytes,
+       const std::function<void(int64_t, const ndn::Buffer&, const ndn::Buffer&)>& f) = 0;
+
+  /**
+   *  @brief  take a damaged record out of service
+   *
+   *  Storage engines without a place to keep such records simply erase them.
+   */
+  virtual bool
+  quarantine(const int64_t id)
+  {
+    return erase(id);
+  }
+
 };
 
 } // namespace repo
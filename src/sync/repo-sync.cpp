@@ -47,14 +47,15 @@ compareSnapshot(std::pair<Name, uint64_t> entry, std::pair<Name, uint64_t> info)
 }
 
 RepoSync::RepoSync(const Name& syncPrefix, const Name& creatorName, const std::string& dbPath,
-                   Face& face, KeyChain& keyChain, ValidatorConfig& validator, RepoStorage& storageHandle)
+                   Face& face, ResponseSigner& signer, ValidatorConfig& validator,
+                   RepoStorage& storageHandle)
   : m_syncPrefix(syncPrefix)
   , m_creatorName(creatorName)
   , m_seq(0)    // action sequence initiate as 0, the first action sequence is 1
   , m_isSynchronized(false)
   , m_isRunning(false)
   , m_face(face)
-  , m_keyChain(keyChain)
+  , m_signer(signer)
   , m_scheduler(face.getIoService())
   , m_validator(validator)
   , m_storageHandle(storageHandle)
@@ -210,8 +211,7 @@ RepoSync::reply(const Interest& commandInterest, const int statusCode)
   response.setStatusCode(statusCode);
   shared_ptr<Data> rdata = make_shared<Data>(commandInterest.getName());
   rdata->setContent(response.wireEncode());
-  m_keyChain.sign(*rdata);
-  m_face.put(*rdata);
+  m_signer.signAsync(rdata, bind(&RepoSync::onDataSigned, this, _1));
 }
 
 Action
@@ -580,14 +580,18 @@ RepoSync::sendData(const Name &name, Msg& ssm)
   data->setContent(reinterpret_cast<const uint8_t*>(wireData), size);
   data->setFreshnessPeriod(milliseconds(syncResponseFreshness));
 
-  m_keyChain.sign(*data);
-
-  m_face.put(*data);
+  m_signer.signAsync(data, bind(&RepoSync::onDataSigned, this, _1));
 
   delete []wireData;
 
 }
 
+void
+RepoSync::onDataSigned(const shared_ptr<Data>& data)
+{
+  m_face.put(*data);
+}
+
 void
 RepoSync::onData(const ndn::Interest& interest, Data& data)
 {
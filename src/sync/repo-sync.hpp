@@ -33,6 +33,7 @@
 #include "sync-interest-table.hpp"
 #include "repo-command-response.hpp"
 #include "repo-command-parameter.hpp"
+#include "util/response-signer.hpp"
 
 namespace repo {
 using namespace ndn::time;
@@ -60,8 +61,13 @@ public:
 
 public:
 
+  /**
+   * @param signer signs sync replies and command responses; other repos validate the
+   *        replies, so its policy should be ResponseSigner::POLICY_ECDSA or POLICY_IDENTITY
+   */
   RepoSync(const Name& syncPrefix, const Name& creatorName, const std::string& dbPath,
-           Face& face, KeyChain& keyChain, ValidatorConfig& validator, RepoStorage& storageHandle);
+           Face& face, ResponseSigner& signer, ValidatorConfig& validator,
+           RepoStorage& storageHandle);
 
   ~RepoSync();
 
@@ -249,6 +255,9 @@ private:  // process different kinds of interests
   void
   sendData(const Name &name, Msg& ssm);
 
+  void
+  onDataSigned(const shared_ptr<Data>& data);
+
 private:  // send different kinds of interests
 
   void
@@ -355,7 +364,7 @@ private:
   bool m_isRunning;
 
   Face& m_face;
-  KeyChain& m_keyChain;
+  ResponseSigner& m_signer;
   Scheduler m_scheduler;
   ValidatorConfig& m_validator;
   RepoStorage& m_storageHandle;
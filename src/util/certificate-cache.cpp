@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "certificate-cache.hpp"
+
+namespace repo {
+
+const ndn::time::milliseconds SharedCertificateCache::DEFAULT_TTL(3600000);
+const size_t SharedCertificateCache::DEFAULT_CAPACITY = 1000;
+
+SharedCertificateCache::SharedCertificateCache(const ndn::time::milliseconds& ttl,
+                                               size_t capacity)
+  : m_ttl(ttl)
+  , m_capacity(capacity)
+{
+}
+
+void
+SharedCertificateCache::insertCertificate(shared_ptr<const ndn::IdentityCertificate> certificate)
+{
+  ndn::time::system_clock::Duration validity =
+    certificate->getNotAfter() - ndn::time::system_clock::now();
+  if (validity <= ndn::time::system_clock::Duration::zero())
+    return;
+
+  Entry entry;
+  entry.certificate = certificate;
+  entry.expiry = ndn::time::steady_clock::now() +
+                 std::min<ndn::time::nanoseconds>(m_ttl, validity);
+
+  Name name = certificate->getName().getPrefix(-1);
+
+  boost::mutex::scoped_lock lock(m_mutex);
+  std::map<Name, Entry>::iterator it = m_entries.find(name);
+  if (it != m_entries.end())
+    eraseEntry(it);
+
+  // expired entries go first, and are not counted as evictions
+  TimePoint now = ndn::time::steady_clock::now();
+  while (!m_expiryIndex.empty() && m_expiryIndex.begin()->first <= now)
+    eraseEntry(m_entries.find(m_expiryIndex.begin()->second));
+
+  if (m_entries.size() >= m_capacity && !m_expiryIndex.empty()) {
+    eraseEntry(m_entries.find(m_expiryIndex.begin()->second));
+    ++m_counters.nEvictions;
+  }
+
+  m_entries[name] = entry;
+  m_expiryIndex.insert(std::make_pair(entry.expiry, name));
+  ++m_counters.nInsertions;
+}
+
+void
+SharedCertificateCache::eraseEntry(std::map<Name, Entry>::iterator it)
+{
+  m_expiryIndex.erase(std::make_pair(it->second.expiry, it->first));
+  m_entries.erase(it);
+}
+
+shared_ptr<const ndn::IdentityCertificate>
+SharedCertificateCache::getCertificate(const Name& certificateNameWithoutVersion)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  std::map<Name, Entry>::iterator it = m_entries.find(certificateNameWithoutVersion);
+  if (it == m_entries.end()) {
+    ++m_counters.nMisses;
+    return shared_ptr<const ndn::IdentityCertificate>();
+  }
+
+  if (it->second.expiry <= ndn::time::steady_clock::now()) {
+    eraseEntry(it);
+    ++m_counters.nMisses;
+    return shared_ptr<const ndn::IdentityCertificate>();
+  }
+
+  ++m_counters.nHits;
+  return it->second.certificate;
+}
+
+void
+SharedCertificateCache::reset()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  m_entries.clear();
+  m_expiryIndex.clear();
+}
+
+size_t
+SharedCertificateCache::getSize()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_entries.size();
+}
+
+SharedCertificateCache::Counters
+SharedCertificateCache::getCounters() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_counters;
+}
+
+void
+SharedCertificateCache::printStatistics(std::ostream& os) const
+{
+  Counters counters = getCounters();
+  uint64_t nLookups = counters.nHits + counters.nMisses;
+  os << "certificate cache hits: " << counters.nHits
+     << " misses: " << counters.nMisses
+     << " hit rate: " << (nLookups == 0 ? 0.0 :
+                          static_cast<double>(counters.nHits) / nLookups)
+     << " insertions: " << counters.nInsertions
+     << " evictions: " << counters.nEvictions;
+}
+
+} // namespace repo
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_CERTIFICATE_CACHE_HPP
+#define REPO_UTIL_CERTIFICATE_CACHE_HPP
+
+#include "../common.hpp"
+
+#include <ndn-cxx/security/certificate-cache.hpp>
+#include <ndn-cxx/security/identity-certificate.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+#include <set>
+
+namespace repo {
+
+/**
+ * @brief cache of validated certificates, shared by validators on any thread
+ *
+ * ValidatorConfig puts a certificate into its cache only after validating it, and
+ * verifies a packet signed by a cached certificate with just the signature check.
+ * Sharing one cache among the validator of the main loop, the validators of
+ * ValidationPool workers and RepoSync thus lets every one of them skip certificate
+ * fetching and chain validation for signers any of them has seen.
+ *
+ * An entry expires after @p ttl, or when the certificate expires if that is earlier.
+ * Entries are also indexed by expiry, so that expired entries are dropped and, when
+ * the cache is full, the entry closest to expiry is evicted in logarithmic time.
+ */
+class SharedCertificateCache : public ndn::CertificateCache
+{
+public:
+  class Counters
+  {
+  public:
+    Counters()
+      : nHits(0)
+      , nMisses(0)
+      , nInsertions(0)
+      , nEvictions(0)
+    {
+    }
+
+  public:
+    uint64_t nHits;        ///< lookups answered from the cache
+    uint64_t nMisses;      ///< lookups of absent or expired certificates
+    uint64_t nInsertions;  ///< certificates added or refreshed
+    uint64_t nEvictions;   ///< certificates dropped to make room
+  };
+
+  static const ndn::time::milliseconds DEFAULT_TTL;
+  static const size_t DEFAULT_CAPACITY;
+
+public:
+  explicit
+  SharedCertificateCache(const ndn::time::milliseconds& ttl = DEFAULT_TTL,
+                         size_t capacity = DEFAULT_CAPACITY);
+
+  virtual void
+  insertCertificate(shared_ptr<const ndn::IdentityCertificate> certificate);
+
+  virtual shared_ptr<const ndn::IdentityCertificate>
+  getCertificate(const Name& certificateNameWithoutVersion);
+
+  virtual void
+  reset();
+
+  virtual size_t
+  getSize();
+
+  Counters
+  getCounters() const;
+
+  /**
+   * @brief print counters and hit rate
+   */
+  void
+  printStatistics(std::ostream& os) const;
+
+private:
+  typedef ndn::time::steady_clock::TimePoint TimePoint;
+
+  struct Entry
+  {
+    shared_ptr<const ndn::IdentityCertificate> certificate;
+    TimePoint expiry;
+  };
+
+  typedef std::set<std::pair<TimePoint, Name> > ExpiryIndex;
+
+  /**
+   * @brief remove an entry from both indexes, m_mutex must be held
+   */
+  void
+  eraseEntry(std::map<Name, Entry>::iterator it);
+
+private:
+  mutable boost::mutex m_mutex;
+  ndn::time::milliseconds m_ttl;
+  size_t m_capacity;
+  std::map<Name, Entry> m_entries;  ///< by certificate name without version
+  ExpiryIndex m_expiryIndex;        ///< names of m_entries by expiry
+  Counters m_counters;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_CERTIFICATE_CACHE_HPP
@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "congestion-window.hpp"
+
+#include <limits>
+
+namespace repo {
+
+CongestionWindow::CongestionWindow(double initialWindow, double minWindow, double maxWindow)
+  : m_window(std::max(minWindow, std::min(initialWindow, maxWindow)))
+  , m_ssthresh(std::numeric_limits<double>::max())
+  , m_minWindow(minWindow)
+  , m_maxWindow(maxWindow)
+{
+}
+
+void
+CongestionWindow::increase()
+{
+  if (isInSlowStart())
+    m_window += 1.0;
+  else
+    m_window += 1.0 / m_window;
+
+  m_window = std::min(m_window, m_maxWindow);
+}
+
+void
+CongestionWindow::decrease()
+{
+  m_ssthresh = std::max(m_window / 2.0, m_minWindow);
+  m_window = m_ssthresh;
+}
+
+} // namespace repo
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_CONGESTION_WINDOW_HPP
+#define REPO_UTIL_CONGESTION_WINDOW_HPP
+
+#include "../common.hpp"
+
+namespace repo {
+
+/**
+ * @brief congestion window with slow start and additive increase, multiplicative decrease
+ *
+ * The window starts at @p initialWindow and grows by one for each acknowledged
+ * segment while below the slow start threshold, i.e. it doubles every round trip.
+ * Above the threshold it grows by 1/window per segment, i.e. by one every round
+ * trip.  A loss halves the window and sets the threshold to the halved value.
+ * Setting @p minWindow equal to @p maxWindow gives a fixed window.
+ */
+class CongestionWindow
+{
+public:
+  explicit
+  CongestionWindow(double initialWindow = 4.0,
+                   double minWindow = 1.0,
+                   double maxWindow = 1024.0);
+
+  /**
+   * @brief called when a segment is acknowledged
+   */
+  void
+  increase();
+
+  /**
+   * @brief called when a segment is considered lost
+   *
+   * Callers are expected to call this at most once per round trip, so that a
+   * burst of losses from the same window is treated as a single congestion event.
+   */
+  void
+  decrease();
+
+  double
+  getWindow() const
+  {
+    return m_window;
+  }
+
+  /**
+   * @brief get the number of segments that may be outstanding
+   */
+  size_t
+  getSize() const
+  {
+    return static_cast<size_t>(m_window);
+  }
+
+  double
+  getSlowStartThreshold() const
+  {
+    return m_ssthresh;
+  }
+
+  bool
+  isInSlowStart() const
+  {
+    return m_window < m_ssthresh;
+  }
+
+private:
+  double m_window;
+  double m_ssthresh;
+  double m_minWindow;
+  double m_maxWindow;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_CONGESTION_WINDOW_HPP
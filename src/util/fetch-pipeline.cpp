@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fetch-pipeline.hpp"
+
+namespace repo {
+
+const size_t FetchPipeline::DUPLICATE_THRESHOLD;
+
+FetchPipeline::FetchPipeline(const CongestionWindow& window, const RttEstimator& rttEstimator,
+                             int maxRetries)
+  : m_window(window)
+  , m_rttEstimator(rttEstimator)
+  , m_maxRetries(maxRetries)
+  , m_nextObject(0)
+  , m_nInFlight(0)
+  , m_nextSendSequence(0)
+  , m_recoveryPoint(0)
+  , m_backoffPoint(0)
+  , m_nRetransmissions(0)
+{
+}
+
+FetchPipeline::FetchPipeline(SegmentNo startBlockId, const CongestionWindow& window,
+                             const RttEstimator& rttEstimator, int maxRetries)
+  : m_window(window)
+  , m_rttEstimator(rttEstimator)
+  , m_maxRetries(maxRetries)
+  , m_nextObject(0)
+  , m_nInFlight(0)
+  , m_nextSendSequence(0)
+  , m_recoveryPoint(0)
+  , m_backoffPoint(0)
+  , m_nRetransmissions(0)
+{
+  addObject(startBlockId);
+}
+
+size_t
+FetchPipeline::addObject(SegmentNo startBlockId)
+{
+  ObjectInfo info;
+  info.startBlockId = startBlockId;
+  info.nextSegment = startBlockId;
+  info.hasEndBlockId = false;
+  info.endBlockId = 0;
+  m_objects.push_back(info);
+  return m_objects.size() - 1;
+}
+
+void
+FetchPipeline::setEndBlockId(size_t object, SegmentNo endBlockId)
+{
+  m_objects[object].hasEndBlockId = true;
+  m_objects[object].endBlockId = endBlockId;
+
+  if (endBlockId == std::numeric_limits<SegmentNo>::max())
+    return;
+
+  // segments requested speculatively beyond the end will never arrive
+  SegmentKey first(object, endBlockId + 1);
+  SegmentKey last(object + 1, 0);
+  std::map<SegmentKey, SegmentInfo>::iterator it = m_segments.lower_bound(first);
+  while (it != m_segments.end() && it->first < last) {
+    if (!it->second.isLost)
+      --m_nInFlight;
+    m_segments.erase(it++);
+  }
+  m_retxQueue.erase(m_retxQueue.lower_bound(first), m_retxQueue.lower_bound(last));
+}
+
+bool
+FetchPipeline::hasEndBlockId() const
+{
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    if (!m_objects[i].hasEndBlockId)
+      return false;
+  }
+  return true;
+}
+
+bool
+FetchPipeline::getSegmentCount(uint64_t& nSegments) const
+{
+  nSegments = 0;
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    const ObjectInfo& info = m_objects[i];
+    if (!info.hasEndBlockId)
+      return false;
+    if (info.endBlockId >= info.startBlockId)
+      nSegments += info.endBlockId - info.startBlockId + 1;
+  }
+  return true;
+}
+
+bool
+FetchPipeline::hasMoreSegments(size_t object) const
+{
+  const ObjectInfo& info = m_objects[object];
+  return !info.hasEndBlockId || info.nextSegment <= info.endBlockId;
+}
+
+bool
+FetchPipeline::getNextSegment(size_t& object, SegmentNo& segment)
+{
+  if (m_nInFlight >= std::max<size_t>(m_window.getSize(), 1))
+    return false;
+
+  if (!m_retxQueue.empty()) {
+    object = m_retxQueue.begin()->first;
+    segment = m_retxQueue.begin()->second;
+    m_retxQueue.erase(m_retxQueue.begin());
+    return true;
+  }
+
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    size_t candidate = (m_nextObject + i) % m_objects.size();
+    if (hasMoreSegments(candidate)) {
+      object = candidate;
+      segment = m_objects[candidate].nextSegment++;
+      m_nextObject = (candidate + 1) % m_objects.size();
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+FetchPipeline::onSent(size_t object, SegmentNo segment, uint32_t nonce, const TimePoint& now)
+{
+  SegmentKey key(object, segment);
+  std::map<SegmentKey, SegmentInfo>::iterator it = m_segments.find(key);
+  if (it == m_segments.end()) {
+    SegmentInfo info;
+    info.nRetries = 0;
+    it = m_segments.insert(std::make_pair(key, info)).first;
+    ++m_nInFlight;
+  }
+  else {
+    ++it->second.nRetries;
+    ++m_nRetransmissions;
+    if (it->second.isLost)
+      ++m_nInFlight;
+  }
+
+  it->second.nonce = nonce;
+  it->second.sendTime = now;
+  it->second.sendSequence = m_nextSendSequence++;
+  it->second.nSkipped = 0;
+  it->second.isLost = false;
+}
+
+bool
+FetchPipeline::onData(size_t object, SegmentNo segment, uint32_t nonce, const TimePoint& now)
+{
+  std::map<SegmentKey, SegmentInfo>::iterator it = m_segments.find(SegmentKey(object, segment));
+  if (it == m_segments.end())
+    return false;
+
+  const SegmentInfo& info = it->second;
+  if (info.nRetries == 0 && info.nonce == nonce)
+    m_rttEstimator.addMeasurement(now - info.sendTime);
+
+  // every segment sent before this one is now overtaken once more
+  for (std::map<SegmentKey, SegmentInfo>::iterator earlier = m_segments.begin();
+       earlier != m_segments.end(); ++earlier) {
+    if (earlier->second.isLost || earlier->second.sendSequence >= info.sendSequence)
+      continue;
+    if (++earlier->second.nSkipped >= DUPLICATE_THRESHOLD)
+      markLost(earlier->first);
+  }
+
+  if (!info.isLost)
+    --m_nInFlight;
+  m_retxQueue.erase(it->first);
+  m_segments.erase(it);
+
+  m_window.increase();
+  return true;
+}
+
+FetchPipeline::TimeoutResult
+FetchPipeline::onTimeout(size_t object, SegmentNo segment, uint32_t nonce)
+{
+  SegmentKey key(object, segment);
+  std::map<SegmentKey, SegmentInfo>::iterator it = m_segments.find(key);
+  if (it == m_segments.end() || it->second.nonce != nonce || it->second.isLost)
+    return TIMEOUT_IGNORED;
+
+  if (it->second.nRetries >= m_maxRetries)
+    return TIMEOUT_FAILED;
+
+  // the rest of the window timing out after a backoff is the same event
+  if (it->second.sendSequence >= m_backoffPoint) {
+    m_rttEstimator.backoff();
+    m_backoffPoint = m_nextSendSequence;
+  }
+  markLost(key);
+  return TIMEOUT_RETRY;
+}
+
+FetchPipeline::TimeoutResult
+FetchPipeline::onInvalidData(size_t object, SegmentNo segment, uint32_t nonce)
+{
+  SegmentKey key(object, segment);
+  std::map<SegmentKey, SegmentInfo>::iterator it = m_segments.find(key);
+  if (it == m_segments.end() || it->second.nonce != nonce || it->second.isLost)
+    return TIMEOUT_IGNORED;
+
+  if (it->second.nRetries >= m_maxRetries)
+    return TIMEOUT_FAILED;
+
+  queueRetransmission(key);
+  return TIMEOUT_RETRY;
+}
+
+void
+FetchPipeline::markLost(const SegmentKey& key)
+{
+  queueRetransmission(key);
+
+  const SegmentInfo& info = m_segments[key];
+  if (info.sendSequence >= m_recoveryPoint) {
+    m_window.decrease();
+    m_recoveryPoint = m_nextSendSequence;
+  }
+}
+
+void
+FetchPipeline::queueRetransmission(const SegmentKey& key)
+{
+  m_segments[key].isLost = true;
+  --m_nInFlight;
+  m_retxQueue.insert(key);
+}
+
+bool
+FetchPipeline::isComplete(size_t object) const
+{
+  if (hasMoreSegments(object))
+    return false;
+
+  std::map<SegmentKey, SegmentInfo>::const_iterator it =
+    m_segments.lower_bound(SegmentKey(object, 0));
+  return it == m_segments.end() || it->first.first != object;
+}
+
+bool
+FetchPipeline::isComplete() const
+{
+  for (size_t i = 0; i < m_objects.size(); ++i) {
+    if (hasMoreSegments(i))
+      return false;
+  }
+  return m_segments.empty();
+}
+
+} // namespace repo
@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_FETCH_PIPELINE_HPP
+#define REPO_UTIL_FETCH_PIPELINE_HPP
+
+#include "../common.hpp"
+#include "congestion-window.hpp"
+#include "rtt-estimator.hpp"
+
+#include <limits>
+#include <set>
+
+namespace repo {
+
+/**
+ * @brief bookkeeping of a segmented fetch under congestion control
+ *
+ * FetchPipeline decides which segment to request next and how to react to Data
+ * and timeouts, without touching a Face, so that it can be driven by WriteHandle
+ * as well as by a simulated link.  Each transmission is identified by the Interest
+ * nonce, so replies and timeouts of superseded transmissions are recognized.
+ *
+ * One pipeline can fetch several segmented objects, which then share its window
+ * and RTT estimate.  New segments are taken from the objects in turn, so that
+ * every object gets an equal share of the window.
+ *
+ * A segment is considered lost when its Interest times out, or when Data for
+ * @p DUPLICATE_THRESHOLD segments sent after it have arrived (fast retransmit).
+ * Lost segments are requested again before any new segment.  The window is
+ * decreased at most once per window of transmissions.  RTO is backed off once per
+ * timeout event: timeouts of transmissions sent before the last backoff are caused
+ * by the same event, and neither back off RTO nor cut the window again (RFC 6298 5.5).
+ */
+class FetchPipeline : noncopyable
+{
+public:
+  typedef ndn::time::steady_clock::TimePoint TimePoint;
+
+  enum TimeoutResult {
+    TIMEOUT_IGNORED, ///< the timed out transmission is no longer relevant
+    TIMEOUT_RETRY,   ///< the segment is queued for retransmission
+    TIMEOUT_FAILED   ///< the segment exceeded its retransmissions, fetch has failed
+  };
+
+  static const size_t DUPLICATE_THRESHOLD = 3;
+
+public:
+  /**
+   * @brief create a pipeline without objects, see addObject()
+   */
+  FetchPipeline(const CongestionWindow& window, const RttEstimator& rttEstimator,
+                int maxRetries);
+
+  /**
+   * @brief create a pipeline fetching a single object, whose index is 0
+   */
+  FetchPipeline(SegmentNo startBlockId, const CongestionWindow& window,
+                const RttEstimator& rttEstimator, int maxRetries);
+
+  /**
+   * @brief add an object to fetch starting with segment @p startBlockId
+   * @return index of the object
+   */
+  size_t
+  addObject(SegmentNo startBlockId);
+
+  size_t
+  getObjectCount() const
+  {
+    return m_objects.size();
+  }
+
+  /**
+   * @brief limit the fetch of @p object to segments up to and including @p endBlockId
+   */
+  void
+  setEndBlockId(size_t object, SegmentNo endBlockId);
+
+  void
+  setEndBlockId(SegmentNo endBlockId)
+  {
+    setEndBlockId(0, endBlockId);
+  }
+
+  bool
+  hasEndBlockId(size_t object) const
+  {
+    return m_objects[object].hasEndBlockId;
+  }
+
+  SegmentNo
+  getEndBlockId(size_t object) const
+  {
+    return m_objects[object].endBlockId;
+  }
+
+  /**
+   * @brief whether EndBlockId of every object is known
+   */
+  bool
+  hasEndBlockId() const;
+
+  /**
+   * @brief get the number of segments of all objects
+   * @return false if EndBlockId of some object is not known yet
+   */
+  bool
+  getSegmentCount(uint64_t& nSegments) const;
+
+  /**
+   * @brief get the next segment to request
+   * @return false if the window is full or no segment needs to be requested
+   */
+  bool
+  getNextSegment(size_t& object, SegmentNo& segment);
+
+  bool
+  getNextSegment(SegmentNo& segment)
+  {
+    size_t object = 0;
+    return getNextSegment(object, segment);
+  }
+
+  /**
+   * @brief record that an Interest for @p segment of @p object was expressed
+   */
+  void
+  onSent(size_t object, SegmentNo segment, uint32_t nonce, const TimePoint& now);
+
+  void
+  onSent(SegmentNo segment, uint32_t nonce, const TimePoint& now)
+  {
+    onSent(0, segment, nonce, now);
+  }
+
+  /**
+   * @brief record that Data for @p segment of @p object arrived
+   * @return true if the Data is new and should be stored, false for a duplicate
+   */
+  bool
+  onData(size_t object, SegmentNo segment, uint32_t nonce, const TimePoint& now);
+
+  bool
+  onData(SegmentNo segment, uint32_t nonce, const TimePoint& now)
+  {
+    return onData(0, segment, nonce, now);
+  }
+
+  TimeoutResult
+  onTimeout(size_t object, SegmentNo segment, uint32_t nonce);
+
+  TimeoutResult
+  onTimeout(SegmentNo segment, uint32_t nonce)
+  {
+    return onTimeout(0, segment, nonce);
+  }
+
+  /**
+   * @brief record that Data for @p segment of @p object arrived, but cannot be used
+   *
+   * The segment is queued for retransmission like a timed out one, and counts
+   * against its retransmissions, but RTO and the window are left alone, because
+   * the network delivered the Data in time.
+   */
+  TimeoutResult
+  onInvalidData(size_t object, SegmentNo segment, uint32_t nonce);
+
+  TimeoutResult
+  onInvalidData(SegmentNo segment, uint32_t nonce)
+  {
+    return onInvalidData(0, segment, nonce);
+  }
+
+  /**
+   * @brief whether every segment of @p object up to its EndBlockId has arrived
+   */
+  bool
+  isComplete(size_t object) const;
+
+  /**
+   * @brief whether every segment of every object has arrived
+   */
+  bool
+  isComplete() const;
+
+  /**
+   * @brief get the lifetime for the next Interest
+   */
+  ndn::time::milliseconds
+  getInterestLifetime() const
+  {
+    return m_rttEstimator.getRto();
+  }
+
+  const CongestionWindow&
+  getWindow() const
+  {
+    return m_window;
+  }
+
+  const RttEstimator&
+  getRttEstimator() const
+  {
+    return m_rttEstimator;
+  }
+
+  size_t
+  getInFlight() const
+  {
+    return m_nInFlight;
+  }
+
+  uint64_t
+  getRetransmissionCount() const
+  {
+    return m_nRetransmissions;
+  }
+
+private:
+  typedef std::pair<size_t, SegmentNo> SegmentKey;  ///< object index and segment number
+
+  /**
+   * @brief mark a segment lost, queue its retransmission, and react to the congestion
+   */
+  void
+  markLost(const SegmentKey& key);
+
+  /**
+   * @brief queue the retransmission of a segment that is no longer in flight
+   */
+  void
+  queueRetransmission(const SegmentKey& key);
+
+  bool
+  hasMoreSegments(size_t object) const;
+
+private:
+  struct ObjectInfo
+  {
+    SegmentNo startBlockId;
+    SegmentNo nextSegment;  ///< lowest segment never requested
+    bool hasEndBlockId;
+    SegmentNo endBlockId;
+  };
+
+  struct SegmentInfo
+  {
+    uint32_t nonce;
+    TimePoint sendTime;
+    uint64_t sendSequence;  ///< position of the last transmission among all transmissions
+    int nRetries;
+    size_t nSkipped;  ///< Data of later sent segments that arrived before this one
+    bool isLost;
+  };
+
+  CongestionWindow m_window;
+  RttEstimator m_rttEstimator;
+  int m_maxRetries;
+
+  std::vector<ObjectInfo> m_objects;
+  size_t m_nextObject;  ///< object to take the next new segment from
+
+  std::map<SegmentKey, SegmentInfo> m_segments;  ///< requested and not yet arrived
+  std::set<SegmentKey> m_retxQueue;
+  size_t m_nInFlight;
+  uint64_t m_nextSendSequence;
+  uint64_t m_recoveryPoint;  ///< losses of earlier transmissions belong to the last congestion event
+  uint64_t m_backoffPoint;   ///< timeouts of earlier transmissions belong to the last timeout event
+  uint64_t m_nRetransmissions;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_FETCH_PIPELINE_HPP
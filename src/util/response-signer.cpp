@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "response-signer.hpp"
+
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/security/identity-certificate.hpp>
+#include <ndn-cxx/security/cryptopp.hpp>
+#include <ndn-cxx/util/crypto.hpp>
+
+#include <cryptopp/hmac.h>
+
+namespace repo {
+
+ResponseSigner::ResponseSigner(boost::asio::io_service& ioService, KeyChain& keyChain,
+                               size_t nWorkers)
+  : m_keyChain(keyChain)
+  , m_pool(ioService, nWorkers)
+  , m_policy(POLICY_IDENTITY)
+  , m_nSubmitted(0)
+{
+}
+
+ResponseSigner::Policy
+ResponseSigner::parsePolicy(const std::string& policy)
+{
+  if (policy == "identity")
+    return POLICY_IDENTITY;
+  else if (policy == "digest")
+    return POLICY_DIGEST_SHA256;
+  else if (policy == "hmac")
+    return POLICY_HMAC_SHA256;
+  else if (policy == "ecdsa")
+    return POLICY_ECDSA;
+  else
+    throw Error("Unrecognized signing policy '" + policy + "'");
+}
+
+void
+ResponseSigner::setPolicy(Policy policy, const Name& identity)
+{
+  if (policy == POLICY_HMAC_SHA256 && !static_cast<bool>(m_hmacKey))
+    throw Error("HMAC signing policy requires a key");
+  if (policy == POLICY_ECDSA && identity.empty())
+    throw Error("ECDSA signing policy requires an identity");
+
+  boost::mutex::scoped_lock lock(m_keyChainMutex);
+  Name certificateName;
+  if (policy == POLICY_IDENTITY && !identity.empty()) {
+    certificateName = m_keyChain.getDefaultCertificateNameForIdentity(identity);
+  }
+  else if (policy == POLICY_ECDSA) {
+    // an existing identity keeps its default key, whatever its type
+    certificateName = m_keyChain.createIdentity(identity, ndn::EcdsaKeyParams());
+    shared_ptr<ndn::IdentityCertificate> certificate = m_keyChain.getCertificate(certificateName);
+    if (!static_cast<bool>(certificate) ||
+        certificate->getPublicKeyInfo().getKeyType() != ndn::KEY_TYPE_ECDSA)
+      throw Error("Default key of identity " + identity.toUri() + " is not an ECDSA key");
+  }
+  m_certificateName = certificateName;
+  m_policy = policy;
+}
+
+void
+ResponseSigner::setHmacKey(const Name& keyName, const ndn::ConstBufferPtr& key)
+{
+  m_hmacKeyName = keyName;
+  m_hmacKey = key;
+}
+
+void
+ResponseSigner::sign(Data& data)
+{
+  switch (m_policy) {
+  case POLICY_DIGEST_SHA256:
+    signWithDigest(data);
+    break;
+  case POLICY_HMAC_SHA256:
+    signWithHmac(data);
+    break;
+  default:
+    signWithKeyChain(data);
+    break;
+  }
+}
+
+void
+ResponseSigner::signAsync(const shared_ptr<Data>& data, const OnSigned& onSigned)
+{
+  // every response is independent, so each gets a key of its own and is not ordered
+  m_pool.submit(m_nSubmitted++, bind(&ResponseSigner::signShared, this, data),
+                bind(onSigned, data));
+}
+
+void
+ResponseSigner::signShared(const shared_ptr<Data>& data)
+{
+  sign(*data);
+}
+
+void
+ResponseSigner::signWithDigest(Data& data)
+{
+  data.setSignature(ndn::Signature(ndn::SignatureInfo(ndn::tlv::DigestSha256)));
+
+  ndn::EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+  data.wireEncode(encoder, Block(ndn::tlv::SignatureValue,
+                                 ndn::crypto::sha256(encoder.buf(), encoder.size())));
+}
+
+void
+ResponseSigner::signWithHmac(Data& data)
+{
+  ndn::SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(SIGNATURE_TYPE_HMAC_SHA256),
+                          ndn::KeyLocator(m_hmacKeyName));
+  data.setSignature(ndn::Signature(info));
+
+  ndn::EncodingBuffer encoder;
+  data.wireEncode(encoder, true);
+
+  CryptoPP::HMAC<CryptoPP::SHA256> hmac(m_hmacKey->buf(), m_hmacKey->size());
+  shared_ptr<ndn::Buffer> mac = make_shared<ndn::Buffer>(hmac.DigestSize());
+  hmac.CalculateDigest(mac->buf(), encoder.buf(), encoder.size());
+  data.wireEncode(encoder, Block(ndn::tlv::SignatureValue, mac));
+}
+
+void
+ResponseSigner::signWithKeyChain(Data& data)
+{
+  boost::mutex::scoped_lock lock(m_keyChainMutex);
+  if (m_certificateName.empty())
+    m_keyChain.sign(data);
+  else
+    m_keyChain.sign(data, m_certificateName);
+}
+
+} // namespace repo
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_RESPONSE_SIGNER_HPP
+#define REPO_UTIL_RESPONSE_SIGNER_HPP
+
+#include "../common.hpp"
+#include "worker-pool.hpp"
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+#include <boost/thread/mutex.hpp>
+
+namespace repo {
+
+/**
+ * @brief signs command responses and sync replies according to a configurable policy
+ *
+ * POLICY_IDENTITY signs with the default certificate of an identity, and is what the
+ * repo has always done.  Responses polled by a client (check commands of ndnputfile come
+ * once a second for every process) need much less than an RSA signature:
+ * POLICY_DIGEST_SHA256 only protects integrity, and POLICY_HMAC_SHA256 authenticates the
+ * repo to clients sharing a secret key.  POLICY_ECDSA signs with an ECDSA key of a
+ * dedicated identity, which is created when missing, and suits sync replies that other
+ * repos validate.
+ *
+ * With workers, signAsync() signs on a WorkerPool.  KeyChain is not thread safe, so
+ * signing with a key of the KeyChain is serialized, but no longer stalls the main loop.
+ */
+class ResponseSigner : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  enum Policy {
+    POLICY_IDENTITY,
+    POLICY_DIGEST_SHA256,
+    POLICY_HMAC_SHA256,
+    POLICY_ECDSA
+  };
+
+  /**
+   * @brief SignatureType of HMAC-SHA256 signatures, which ndn-cxx does not define yet
+   */
+  static const uint32_t SIGNATURE_TYPE_HMAC_SHA256 = 4;
+
+  typedef std::function<void(const shared_ptr<Data>& data)> OnSigned;
+
+public:
+  ResponseSigner(boost::asio::io_service& ioService, KeyChain& keyChain, size_t nWorkers = 0);
+
+  /**
+   * @brief parse a policy name: identity, digest, hmac or ecdsa
+   * @throw Error unknown name
+   */
+  static Policy
+  parsePolicy(const std::string& policy);
+
+  /**
+   * @brief select the signing policy
+   * @param identity identity whose key signs under POLICY_IDENTITY, empty for the
+   *        default identity, and under POLICY_ECDSA, which requires one
+   * @throw Error POLICY_HMAC_SHA256 is selected before setHmacKey(), or POLICY_ECDSA
+   *        without an identity or with an identity whose default key is not ECDSA
+   */
+  void
+  setPolicy(Policy policy, const Name& identity = Name());
+
+  Policy
+  getPolicy() const
+  {
+    return m_policy;
+  }
+
+  /**
+   * @brief set the secret key of POLICY_HMAC_SHA256 and the name put in KeyLocator
+   */
+  void
+  setHmacKey(const Name& keyName, const ndn::ConstBufferPtr& key);
+
+  void
+  sign(Data& data);
+
+  /**
+   * @brief sign @p data on a worker and pass it to @p onSigned on the main loop
+   *
+   * @p data must not be touched until @p onSigned is called.
+   */
+  void
+  signAsync(const shared_ptr<Data>& data, const OnSigned& onSigned);
+
+private:
+  void
+  signShared(const shared_ptr<Data>& data);
+
+  void
+  signWithDigest(Data& data);
+
+  void
+  signWithHmac(Data& data);
+
+  void
+  signWithKeyChain(Data& data);
+
+private:
+  KeyChain& m_keyChain;
+  boost::mutex m_keyChainMutex;
+  WorkerPool m_pool;
+  Policy m_policy;
+  Name m_certificateName;  ///< empty for the default certificate
+  Name m_hmacKeyName;
+  ndn::ConstBufferPtr m_hmacKey;
+  uint64_t m_nSubmitted;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_RESPONSE_SIGNER_HPP
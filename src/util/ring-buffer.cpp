@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ring-buffer.hpp"
+
+namespace repo {
+
+RingBuffer::RingBuffer(size_t capacity)
+  : m_buffer(capacity)
+  , m_begin(0)
+  , m_size(0)
+{
+}
+
+RingBuffer::MutableBuffers
+RingBuffer::prepare()
+{
+  size_t capacity = m_buffer.size();
+  size_t end = (m_begin + m_size) % capacity;
+  size_t freeSpace = capacity - m_size;
+
+  MutableBuffers buffers;
+  if (end + freeSpace <= capacity) {
+    buffers[0] = boost::asio::buffer(&m_buffer[0] + end, freeSpace);
+    buffers[1] = boost::asio::mutable_buffer();
+  }
+  else {
+    buffers[0] = boost::asio::buffer(&m_buffer[0] + end, capacity - end);
+    buffers[1] = boost::asio::buffer(&m_buffer[0], freeSpace - (capacity - end));
+  }
+  return buffers;
+}
+
+void
+RingBuffer::commit(size_t nBytes)
+{
+  BOOST_ASSERT(nBytes <= getFreeSpace());
+  m_size += nBytes;
+}
+
+void
+RingBuffer::write(const uint8_t* bytes, size_t nBytes)
+{
+  BOOST_ASSERT(nBytes <= getFreeSpace());
+  size_t capacity = m_buffer.size();
+  size_t end = (m_begin + m_size) % capacity;
+  size_t first = std::min(nBytes, capacity - end);
+  std::copy(bytes, bytes + first, m_buffer.begin() + end);
+  std::copy(bytes + first, bytes + nBytes, m_buffer.begin());
+  m_size += nBytes;
+}
+
+void
+RingBuffer::copy(size_t offset, size_t nBytes, uint8_t* destination) const
+{
+  BOOST_ASSERT(offset + nBytes <= m_size);
+  size_t capacity = m_buffer.size();
+  size_t start = (m_begin + offset) % capacity;
+  size_t first = std::min(nBytes, capacity - start);
+  std::copy(m_buffer.begin() + start, m_buffer.begin() + start + first, destination);
+  std::copy(m_buffer.begin(), m_buffer.begin() + (nBytes - first), destination + first);
+}
+
+void
+RingBuffer::consume(size_t nBytes)
+{
+  BOOST_ASSERT(nBytes <= m_size);
+  m_size -= nBytes;
+  m_begin = m_size == 0 ? 0 : (m_begin + nBytes) % m_buffer.size();
+}
+
+bool
+RingBuffer::readVarNumber(size_t& offset, uint64_t& number) const
+{
+  if (offset >= m_size)
+    return false;
+
+  uint8_t first = at(offset);
+  size_t length = 0;
+  if (first < 253) {
+    number = first;
+    ++offset;
+    return true;
+  }
+  else if (first == 253)
+    length = 2;
+  else if (first == 254)
+    length = 4;
+  else
+    length = 8;
+
+  if (offset + 1 + length > m_size)
+    return false;
+
+  number = 0;
+  for (size_t i = 1; i <= length; ++i)
+    number = (number << 8) | at(offset + i);
+  offset += 1 + length;
+  return true;
+}
+
+} // namespace repo
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_RING_BUFFER_HPP
+#define REPO_UTIL_RING_BUFFER_HPP
+
+#include "../common.hpp"
+
+#include <boost/array.hpp>
+#include <boost/asio/buffer.hpp>
+
+namespace repo {
+
+/**
+ * @brief fixed capacity byte queue that wraps around instead of compacting
+ *
+ * Bytes are received into the free space, which prepare() describes as at most two
+ * buffers for a scatter read, and are read in place at offsets from the oldest byte.
+ * readVarNumber() decodes TLV-TYPE and TLV-LENGTH across the wraparound point, so a
+ * reader can tell how long an element is before deciding to copy it out.
+ */
+class RingBuffer : noncopyable
+{
+public:
+  typedef boost::array<boost::asio::mutable_buffer, 2> MutableBuffers;
+
+public:
+  explicit
+  RingBuffer(size_t capacity);
+
+  size_t
+  getCapacity() const
+  {
+    return m_buffer.size();
+  }
+
+  /**
+   * @brief get the number of bytes stored
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  size_t
+  getFreeSpace() const
+  {
+    return m_buffer.size() - m_size;
+  }
+
+  /**
+   * @brief get the free space, the second buffer is empty unless it wraps around
+   */
+  MutableBuffers
+  prepare();
+
+  /**
+   * @brief append @p nBytes written into the buffers from prepare()
+   */
+  void
+  commit(size_t nBytes);
+
+  /**
+   * @brief append a copy of @p nBytes at @p bytes
+   * @pre nBytes <= getFreeSpace()
+   */
+  void
+  write(const uint8_t* bytes, size_t nBytes);
+
+  uint8_t
+  at(size_t offset) const
+  {
+    BOOST_ASSERT(offset < m_size);
+    return m_buffer[(m_begin + offset) % m_buffer.size()];
+  }
+
+  /**
+   * @brief copy @p nBytes starting at @p offset to @p destination
+   */
+  void
+  copy(size_t offset, size_t nBytes, uint8_t* destination) const;
+
+  /**
+   * @brief drop the oldest @p nBytes
+   */
+  void
+  consume(size_t nBytes);
+
+  /**
+   * @brief decode a TLV VarNumber starting at @p offset
+   * @param[in,out] offset advanced past the VarNumber on success
+   * @return false if the stored bytes end within the VarNumber
+   */
+  bool
+  readVarNumber(size_t& offset, uint64_t& number) const;
+
+private:
+  std::vector<uint8_t> m_buffer;
+  size_t m_begin;  ///< position of the oldest byte
+  size_t m_size;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_RING_BUFFER_HPP
@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtt-estimator.hpp"
+
+#include <cmath>
+
+namespace repo {
+
+static const double RTT_ALPHA = 0.125;
+static const double RTT_BETA = 0.25;
+static const double RTTVAR_FACTOR = 4.0;
+
+RttEstimator::RttEstimator(const ndn::time::milliseconds& initialRto,
+                           const ndn::time::milliseconds& minRto,
+                           const ndn::time::milliseconds& maxRto)
+  : m_hasSamples(false)
+  , m_srtt(0.0)
+  , m_rttVar(0.0)
+  , m_rto(0.0)
+  , m_minRto(static_cast<double>(minRto.count()))
+  , m_maxRto(static_cast<double>(maxRto.count()))
+{
+  m_rto = std::min(std::max(static_cast<double>(initialRto.count()), m_minRto), m_maxRto);
+}
+
+void
+RttEstimator::addMeasurement(const ndn::time::nanoseconds& rtt)
+{
+  double sample = static_cast<double>(rtt.count()) / 1000000.0;
+
+  if (!m_hasSamples) {
+    m_srtt = sample;
+    m_rttVar = sample / 2.0;
+    m_hasSamples = true;
+  }
+  else {
+    m_rttVar = (1.0 - RTT_BETA) * m_rttVar + RTT_BETA * std::abs(m_srtt - sample);
+    m_srtt = (1.0 - RTT_ALPHA) * m_srtt + RTT_ALPHA * sample;
+  }
+
+  m_rto = std::min(std::max(m_srtt + RTTVAR_FACTOR * m_rttVar, m_minRto), m_maxRto);
+}
+
+void
+RttEstimator::backoff()
+{
+  m_rto = std::min(m_rto * 2.0, m_maxRto);
+}
+
+ndn::time::milliseconds
+RttEstimator::getRto() const
+{
+  return ndn::time::milliseconds(static_cast<int64_t>(std::ceil(m_rto)));
+}
+
+} // namespace repo
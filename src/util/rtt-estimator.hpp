@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_RTT_ESTIMATOR_HPP
+#define REPO_UTIL_RTT_ESTIMATOR_HPP
+
+#include "../common.hpp"
+
+namespace repo {
+
+/**
+ * @brief retransmission timeout estimator
+ *
+ * Keeps the smoothed round trip time (SRTT) and its variation (RTTVAR) as in
+ * RFC 6298, and computes RTO = SRTT + 4 * RTTVAR, bounded by [minRto, maxRto].
+ * Until the first measurement RTO is @p initialRto.  If the bounds conflict,
+ * @p maxRto wins, so RTO never exceeds the longest lifetime a caller allows.
+ */
+class RttEstimator
+{
+public:
+  explicit
+  RttEstimator(const ndn::time::milliseconds& initialRto = ndn::time::milliseconds(1000),
+               const ndn::time::milliseconds& minRto = ndn::time::milliseconds(200),
+               const ndn::time::milliseconds& maxRto = ndn::time::milliseconds(60000));
+
+  /**
+   * @brief add a round trip time sample
+   *
+   * Samples must only be taken from segments that were not retransmitted
+   * (Karn's algorithm), because the reply cannot be matched to a transmission.
+   */
+  void
+  addMeasurement(const ndn::time::nanoseconds& rtt);
+
+  /**
+   * @brief double RTO after a timeout
+   */
+  void
+  backoff();
+
+  ndn::time::milliseconds
+  getRto() const;
+
+  bool
+  hasSamples() const
+  {
+    return m_hasSamples;
+  }
+
+  /**
+   * @brief get smoothed round trip time in milliseconds
+   */
+  double
+  getSmoothedRtt() const
+  {
+    return m_srtt;
+  }
+
+  /**
+   * @brief get round trip time variation in milliseconds
+   */
+  double
+  getRttVariation() const
+  {
+    return m_rttVar;
+  }
+
+private:
+  bool m_hasSamples;
+  double m_srtt;
+  double m_rttVar;
+  double m_rto;
+  double m_minRto;
+  double m_maxRto;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_RTT_ESTIMATOR_HPP
@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shared-memory-ring.hpp"
+
+#include <ndn-cxx/encoding/tlv.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace repo {
+
+static const uint32_t RING_MAGIC = 0x524e444e; // "NDNR" in little endian
+static const uint32_t RING_VERSION = 1;
+
+/**
+ * @brief layout of the beginning of a ring file
+ *
+ * The positions are on cache lines of their own, so that the producer and the consumer
+ * do not invalidate each other's line on every update.
+ */
+struct SharedMemoryRing::Header
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t capacity;
+  uint8_t padding1[48];
+  std::atomic<uint64_t> writePosition;
+  uint8_t padding2[56];
+  std::atomic<uint64_t> readPosition;
+  uint8_t padding3[56];
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && ATOMIC_LLONG_LOCK_FREE == 2,
+              "ring positions must be lock-free to be shared between processes");
+
+SharedMemoryRing::SharedMemoryRing(const std::string& path, const Owner& owner)
+  : m_fd(-1)
+  , m_mapping(nullptr)
+{
+  // neither follow a link nor block on a FIFO the producer put in place of the ring
+  map(path, O_RDWR | O_NOFOLLOW | O_NONBLOCK, 0, owner.uid);
+}
+
+SharedMemoryRing::SharedMemoryRing(const std::string& path, size_t capacity)
+  : m_fd(-1)
+  , m_mapping(nullptr)
+{
+  if (capacity == 0)
+    throw Error("Shared memory ring must have a data area");
+
+  map(path, O_RDWR | O_CREAT | O_TRUNC, capacity, ::geteuid());
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+  if (m_mapping != nullptr)
+    ::munmap(m_mapping, m_mappingSize);
+  if (m_fd >= 0)
+    ::close(m_fd);
+}
+
+void
+SharedMemoryRing::map(const std::string& path, int flags, size_t capacity, uid_t owner)
+{
+  bool isCreating = (flags & O_CREAT) != 0;
+
+  m_fd = ::open(path.c_str(), flags, 0600);
+  if (m_fd < 0)
+    throw Error("Cannot open shared memory ring " + path + ": " + std::strerror(errno));
+
+  if (isCreating) {
+    m_mappingSize = sizeof(Header) + capacity;
+    // an existing file keeps its mode, which the consumer may not accept
+    if (::fchmod(m_fd, 0600) != 0 || ::ftruncate(m_fd, m_mappingSize) != 0) {
+      ::close(m_fd);
+      m_fd = -1;
+      throw Error("Cannot size shared memory ring " + path + ": " + std::strerror(errno));
+    }
+  }
+  else {
+    struct stat status;
+    if (::fstat(m_fd, &status) != 0 || !S_ISREG(status.st_mode) ||
+        static_cast<size_t>(status.st_size) <= sizeof(Header)) {
+      ::close(m_fd);
+      m_fd = -1;
+      throw Error(path + " is not a shared memory ring");
+    }
+    if (status.st_uid != owner || (status.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+      ::close(m_fd);
+      m_fd = -1;
+      throw Error("Shared memory ring " + path +
+                  " is not owned by the producer, or is writable by others");
+    }
+    m_mappingSize = status.st_size;
+  }
+
+  void* mapping = ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (mapping == MAP_FAILED) {
+    ::close(m_fd);
+    m_fd = -1;
+    throw Error("Cannot map shared memory ring " + path + ": " + std::strerror(errno));
+  }
+  m_mapping = static_cast<uint8_t*>(mapping);
+
+  Header* header = reinterpret_cast<Header*>(m_mapping);
+  if (isCreating) {
+    header->magic = RING_MAGIC;
+    header->version = RING_VERSION;
+    header->capacity = capacity;
+    header->writePosition.store(0);
+    header->readPosition.store(0);
+  }
+  else if (header->magic != RING_MAGIC || header->version != RING_VERSION ||
+           header->capacity != m_mappingSize - sizeof(Header)) {
+    // the destructor does not run for a constructor that throws
+    ::munmap(m_mapping, m_mappingSize);
+    m_mapping = nullptr;
+    ::close(m_fd);
+    m_fd = -1;
+    throw Error(path + " is not a shared memory ring of version " +
+                std::to_string(RING_VERSION));
+  }
+
+  m_capacity = m_mappingSize - sizeof(Header);
+  m_writePosition = &header->writePosition;
+  m_readPosition = &header->readPosition;
+  m_data = m_mapping + sizeof(Header);
+}
+
+void
+SharedMemoryRing::checkFileSize() const
+{
+  struct stat status;
+  if (::fstat(m_fd, &status) != 0 || static_cast<size_t>(status.st_size) < m_mappingSize)
+    throw Error("Shared memory ring was truncated");
+}
+
+size_t
+SharedMemoryRing::size() const
+{
+  return m_writePosition->load(std::memory_order_acquire) -
+         m_readPosition->load(std::memory_order_acquire);
+}
+
+bool
+SharedMemoryRing::write(const uint8_t* element, size_t elementSize)
+{
+  BOOST_ASSERT(elementSize > 0 && element[0] != 0);
+  if (elementSize > m_capacity)
+    throw Error("Element does not fit into the shared memory ring");
+
+  uint64_t writePosition = m_writePosition->load(std::memory_order_relaxed);
+  uint64_t readPosition = m_readPosition->load(std::memory_order_acquire);
+
+  size_t offset = writePosition % m_capacity;
+  size_t tail = m_capacity - offset;
+  size_t needed = elementSize <= tail ? elementSize : tail + elementSize;
+  if (m_capacity - (writePosition - readPosition) < needed)
+    return false;
+
+  if (elementSize > tail) {
+    m_data[offset] = 0;
+    writePosition += tail;
+    offset = 0;
+  }
+
+  std::memcpy(m_data + offset, element, elementSize);
+  m_writePosition->store(writePosition + elementSize, std::memory_order_release);
+  return true;
+}
+
+bool
+SharedMemoryRing::front(const uint8_t*& element, size_t& elementSize)
+{
+  // the producer is another process, so nothing it wrote is trusted, and the pages
+  // it has cut off the file must not be touched
+  checkFileSize();
+
+  uint64_t readPosition = m_readPosition->load(std::memory_order_relaxed);
+  uint64_t writePosition = m_writePosition->load(std::memory_order_acquire);
+
+  while (readPosition != writePosition) {
+    uint64_t available = writePosition - readPosition;
+    if (available > m_capacity)
+      throw Error("Write position of the shared memory ring is out of range");
+
+    size_t offset = readPosition % m_capacity;
+    size_t contiguous = std::min<uint64_t>(available, m_capacity - offset);
+
+    if (m_data[offset] == 0) {
+      // padding up to the end of the data area
+      if (contiguous < m_capacity - offset)
+        throw Error("Shared memory ring holds incomplete padding");
+      readPosition += contiguous;
+      m_readPosition->store(readPosition, std::memory_order_release);
+      continue;
+    }
+
+    const uint8_t* begin = m_data + offset;
+    const uint8_t* end = begin + contiguous;
+    try {
+      ndn::tlv::readType(begin, end);
+      uint64_t length = ndn::tlv::readVarNumber(begin, end);
+      if (length > static_cast<uint64_t>(end - begin))
+        throw Error("Shared memory ring holds an incomplete element");
+      element = m_data + offset;
+      elementSize = (begin - element) + static_cast<size_t>(length);
+      return true;
+    }
+    catch (ndn::tlv::Error&) {
+      throw Error("Shared memory ring holds an incomplete element");
+    }
+  }
+  return false;
+}
+
+void
+SharedMemoryRing::pop(size_t elementSize)
+{
+  uint64_t readPosition = m_readPosition->load(std::memory_order_relaxed);
+  m_readPosition->store(readPosition + elementSize, std::memory_order_release);
+}
+
+} // namespace repo
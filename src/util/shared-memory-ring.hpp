@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_SHARED_MEMORY_RING_HPP
+#define REPO_UTIL_SHARED_MEMORY_RING_HPP
+
+#include "../common.hpp"
+
+#include <atomic>
+
+#include <sys/types.h>
+
+namespace repo {
+
+/**
+ * @brief single producer, single consumer queue of TLV elements in a shared file mapping
+ *
+ * A producer on the same host creates the ring file (normally under /dev/shm), writes
+ * complete elements into it and publishes them by advancing the write position.  The
+ * repo maps the same file and reads the elements in place, advancing the read position
+ * once it no longer needs them.  Positions count bytes since the ring was created.
+ *
+ * An element is never split at the end of the data area.  If it does not fit, the
+ * producer writes a single zero byte, which no TLV-TYPE starts with, and continues at
+ * the beginning; the consumer skips everything from a zero byte to the end.
+ *
+ *     offset 0    magic "NDNR", version 1, capacity of the data area (uint64)
+ *     offset 64   write position (uint64, only changed by the producer)
+ *     offset 128  read position (uint64, only changed by the consumer)
+ *     offset 192  data area
+ *
+ * Integers are in host byte order, both sides run on the same machine.
+ *
+ * The consumer only maps a regular file of the user it expects, which no one else can
+ * write to, so that a producer cannot make the repo write into a file it controls.
+ * The producer can still shrink the file, and touching a truncated page of the mapping
+ * raises SIGBUS.  front() therefore checks that the file still has the mapped size
+ * before reading, and the consumer copies the element out right away.  This leaves one
+ * assumption about the producer: it does not truncate the ring between that check and
+ * the copy.  A producer that does so only brings down a repo its user was allowed to
+ * feed; closing this window needs a memfd sealed against shrinking.
+ */
+class SharedMemoryRing : noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    explicit
+    Error(const std::string& what)
+      : std::runtime_error(what)
+    {
+    }
+  };
+
+  /**
+   * @brief the user that must own the ring file
+   */
+  struct Owner
+  {
+    explicit
+    Owner(uid_t uid)
+      : uid(uid)
+    {
+    }
+
+    uid_t uid;
+  };
+
+public:
+  /**
+   * @brief map an existing ring as its consumer
+   * @throw Error the file cannot be mapped, is not a ring, is not a regular file owned
+   *              by @p owner, or is writable by its group or others
+   */
+  SharedMemoryRing(const std::string& path, const Owner& owner);
+
+  /**
+   * @brief create a ring file with a data area of @p capacity bytes, as its producer
+   * @throw Error the file cannot be created
+   */
+  SharedMemoryRing(const std::string& path, size_t capacity);
+
+  ~SharedMemoryRing();
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  /**
+   * @brief get the number of bytes written but not yet consumed, including padding
+   */
+  size_t
+  size() const;
+
+  /**
+   * @brief append a complete TLV element (producer)
+   * @return false if the ring has no room for it now
+   * @throw Error the element is larger than the ring
+   */
+  bool
+  write(const uint8_t* element, size_t elementSize);
+
+  /**
+   * @brief get the oldest element in place (consumer)
+   *
+   * The element should be copied before anything else is done with the ring.
+   * @return false if the ring is empty
+   * @throw Error the ring does not hold complete TLV elements, or the file was truncated
+   */
+  bool
+  front(const uint8_t*& element, size_t& elementSize);
+
+  /**
+   * @brief release the oldest element to the producer (consumer)
+   * @pre front() returned an element of @p elementSize bytes
+   */
+  void
+  pop(size_t elementSize);
+
+private:
+  void
+  map(const std::string& path, int flags, size_t capacity, uid_t owner);
+
+  /**
+   * @throw Error the file is smaller than the mapping
+   */
+  void
+  checkFileSize() const;
+
+private:
+  struct Header;
+
+  int m_fd;
+  uint8_t* m_mapping;
+  size_t m_mappingSize;
+  size_t m_capacity;
+  std::atomic<uint64_t>* m_writePosition;
+  std::atomic<uint64_t>* m_readPosition;
+  uint8_t* m_data;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_SHARED_MEMORY_RING_HPP
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validation-pool.hpp"
+
+namespace repo {
+
+/**
+ * @brief reason given by ndn::Validator when a certificate would have to be fetched,
+ *        which a validator without a Face cannot do
+ */
+static const std::string CERTIFICATE_NEEDED_REASON =
+  "Require more information to validate the packet!";
+
+ValidationPool::ValidationPool(boost::asio::io_service& ioService, ValidatorConfig& validator,
+                               const shared_ptr<ndn::CertificateCache>& certificateCache,
+                               size_t nWorkers)
+  : m_validator(validator)
+  , m_pool(ioService, nWorkers)
+{
+  for (size_t i = 0; i < nWorkers; ++i) {
+    // without a Face, a worker never fetches certificates
+    m_workerValidators.push_back(make_shared<ValidatorConfig>(nullptr, certificateCache));
+  }
+}
+
+void
+ValidationPool::load(const boost::property_tree::ptree& section, const std::string& filename)
+{
+  for (size_t i = 0; i < m_workerValidators.size(); ++i) {
+    m_workerValidators[i]->load(section, filename);
+  }
+}
+
+void
+ValidationPool::validate(uint64_t key, const Data& data,
+                         const ndn::OnDataValidated& onValidated,
+                         const ndn::OnDataValidationFailed& onValidationFailed)
+{
+  if (m_workerValidators.empty()) {
+    m_validator.validate(data, onValidated, onValidationFailed);
+    return;
+  }
+
+  // the worker gets its own copy, whose lazily decoded fields it may fill in
+  shared_ptr<Data> copy = make_shared<Data>(data);
+  shared_ptr<Result> result = make_shared<Result>();
+  m_pool.submit(key,
+                bind(&ValidationPool::validateOnWorker, this, _1, copy, result),
+                bind(&ValidationPool::onWorkerResult, this, copy, result,
+                     onValidated, onValidationFailed));
+}
+
+void
+ValidationPool::deliver(uint64_t key, const Data& data, const ndn::OnDataValidated& onValidated)
+{
+  m_pool.submit(key, bind(onValidated, make_shared<Data>(data)));
+}
+
+void
+ValidationPool::validateOnWorker(size_t worker, const shared_ptr<Data>& data,
+                                 const shared_ptr<Result>& result)
+{
+  // without a Face, validation finishes before validate() returns
+  m_workerValidators[worker]->validate(*data,
+                                       bind(&ValidationPool::onWorkerValidated, result),
+                                       bind(&ValidationPool::onWorkerValidationFailed,
+                                            result, _2));
+}
+
+void
+ValidationPool::onWorkerValidationFailed(const shared_ptr<Result>& result,
+                                         const std::string& reason)
+{
+  result->needsCertificate = reason == CERTIFICATE_NEEDED_REASON;
+  result->reason = reason;
+}
+
+void
+ValidationPool::onWorkerResult(const shared_ptr<Data>& data, const shared_ptr<Result>& result,
+                               const ndn::OnDataValidated& onValidated,
+                               const ndn::OnDataValidationFailed& onValidationFailed)
+{
+  if (result->isValid) {
+    onValidated(data);
+    return;
+  }
+
+  if (result->needsCertificate) {
+    m_validator.validate(*data, onValidated, onValidationFailed);
+    return;
+  }
+
+  onValidationFailed(data, result->reason);
+}
+
+} // namespace repo
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_VALIDATION_POOL_HPP
+#define REPO_UTIL_VALIDATION_POOL_HPP
+
+#include "worker-pool.hpp"
+#include "certificate-cache.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace repo {
+
+/**
+ * @brief validates Data on worker threads
+ *
+ * Every worker has its own ValidatorConfig, loaded with the same configuration as the
+ * validator of the main loop but without a Face, so that it can check policy and
+ * signature of Data whose certificates need not be fetched.  A Data that fails on a
+ * worker because a certificate has to be fetched is validated again by the validator
+ * of the main loop, which has the Face to fetch it.  Any other failure on a worker is
+ * final.
+ *
+ * All the workers look up signers in @p certificateCache, which should be the cache of
+ * the validator of the main loop, so that certificates it fetched and validated are
+ * available to the workers.
+ *
+ * Validation results of Data submitted with the same key are delivered in the order
+ * of submission, as long as they are decided on the workers.  Data that needs no
+ * validation can be passed through the same order with deliver().  Without workers,
+ * Data is validated inline by the validator of the main loop.
+ */
+class ValidationPool : noncopyable
+{
+public:
+  ValidationPool(boost::asio::io_service& ioService, ValidatorConfig& validator,
+                 const shared_ptr<ndn::CertificateCache>& certificateCache, size_t nWorkers);
+
+  /**
+   * @brief load the validator configuration into every worker
+   *
+   * The validator of the main loop is loaded separately by its owner.
+   */
+  void
+  load(const boost::property_tree::ptree& section, const std::string& filename);
+
+  void
+  validate(uint64_t key, const Data& data,
+           const ndn::OnDataValidated& onValidated,
+           const ndn::OnDataValidationFailed& onValidationFailed);
+
+  /**
+   * @brief pass Data that is already trusted to @p onValidated, after the results of
+   *        Data submitted before with the same key
+   *
+   * This is for Data authenticated otherwise, e.g. by a digest listed in a validated
+   * manifest.
+   */
+  void
+  deliver(uint64_t key, const Data& data, const ndn::OnDataValidated& onValidated);
+
+  size_t
+  getWorkerCount() const
+  {
+    return m_pool.getWorkerCount();
+  }
+
+private:
+  struct Result
+  {
+    Result()
+      : isValid(false)
+      , needsCertificate(false)
+    {
+    }
+
+    bool isValid;
+    bool needsCertificate;  ///< the worker failed only because it cannot fetch a certificate
+    std::string reason;
+  };
+
+  void
+  validateOnWorker(size_t worker, const shared_ptr<Data>& data,
+                   const shared_ptr<Result>& result);
+
+  static void
+  onWorkerValidated(const shared_ptr<Result>& result)
+  {
+    result->isValid = true;
+  }
+
+  static void
+  onWorkerValidationFailed(const shared_ptr<Result>& result, const std::string& reason);
+
+  void
+  onWorkerResult(const shared_ptr<Data>& data, const shared_ptr<Result>& result,
+                 const ndn::OnDataValidated& onValidated,
+                 const ndn::OnDataValidationFailed& onValidationFailed);
+
+private:
+  ValidatorConfig& m_validator;
+  std::vector<shared_ptr<ValidatorConfig> > m_workerValidators;
+  WorkerPool m_pool;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_VALIDATION_POOL_HPP
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "worker-pool.hpp"
+
+namespace repo {
+
+static void
+runWorker(boost::asio::io_service* ioService)
+{
+  ioService->run();
+}
+
+WorkerPool::WorkerPool(boost::asio::io_service& ioService, size_t nWorkers)
+  : m_ioService(ioService)
+  , m_self(make_shared<WorkerPool*>(this))
+  , m_nextWorker(0)
+{
+  for (size_t i = 0; i < nWorkers; ++i) {
+    shared_ptr<Worker> worker = make_shared<Worker>();
+    worker->work = make_shared<boost::asio::io_service::work>(boost::ref(worker->ioService));
+    worker->thread = boost::thread(bind(&runWorker, &worker->ioService));
+    m_workers.push_back(worker);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  m_self.reset();
+  for (size_t i = 0; i < m_workers.size(); ++i) {
+    m_workers[i]->work.reset();
+    m_workers[i]->ioService.stop();
+  }
+  for (size_t i = 0; i < m_workers.size(); ++i) {
+    m_workers[i]->thread.join();
+  }
+}
+
+void
+WorkerPool::submit(uint64_t key, const Work& work, const Completion& completion)
+{
+  if (m_workers.empty()) {
+    work(0);
+    completion();
+    return;
+  }
+
+  uint64_t sequence = m_keys[key].nSubmitted++;
+
+  size_t worker = m_nextWorker;
+  m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+  m_workers[worker]->ioService.post(bind(&WorkerPool::runWork, this, Token(m_self),
+                                         worker, key, sequence, work, completion));
+}
+
+void
+WorkerPool::submit(uint64_t key, const Completion& completion)
+{
+  if (m_workers.empty()) {
+    completion();
+    return;
+  }
+
+  uint64_t sequence = m_keys[key].nSubmitted++;
+  m_ioService.post(bind(&WorkerPool::completeIfAlive, Token(m_self), key, sequence, completion));
+}
+
+void
+WorkerPool::runWork(const Token& token, size_t worker, uint64_t key, uint64_t sequence,
+                    const Work& work, const Completion& completion)
+{
+  work(worker);
+  // the token was taken on the main loop, since m_self is reset there
+  m_ioService.post(bind(&WorkerPool::completeIfAlive, token, key, sequence, completion));
+}
+
+void
+WorkerPool::completeIfAlive(const Token& token, uint64_t key, uint64_t sequence,
+                            const Completion& completion)
+{
+  shared_ptr<WorkerPool*> pool = token.lock();
+  if (pool)
+    (*pool)->complete(key, sequence, completion);
+}
+
+void
+WorkerPool::complete(uint64_t key, uint64_t sequence, const Completion& completion)
+{
+  m_keys[key].pending[sequence] = completion;
+
+  while (true) {
+    // a completion may submit more work, so the state is looked up every time
+    std::map<uint64_t, KeyState>::iterator it = m_keys.find(key);
+    if (it == m_keys.end())
+      return;
+    KeyState& state = it->second;
+    if (state.pending.empty() || state.pending.begin()->first != state.nCompleted) {
+      return;
+    }
+
+    Completion next = state.pending.begin()->second;
+    state.pending.erase(state.pending.begin());
+    ++state.nCompleted;
+    if (state.nCompleted == state.nSubmitted)
+      m_keys.erase(it);
+
+    next();
+  }
+}
+
+} // namespace repo
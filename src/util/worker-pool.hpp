@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_UTIL_WORKER_POOL_HPP
+#define REPO_UTIL_WORKER_POOL_HPP
+
+#include "../common.hpp"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace repo {
+
+/**
+ * @brief runs CPU bound work on worker threads, and its completion on the main loop
+ *
+ * Work is handed to the workers in turn, each of which runs its own io_service.
+ * When a piece of work is done, its completion is posted to the io_service of the
+ * main loop.  Completions of work submitted with the same key run in the order the
+ * work was submitted, even though the work itself may run in parallel.
+ *
+ * submit() must be called from the main loop.  Destroying the pool waits for the
+ * work that is running, and drops the completions that were not run yet, including
+ * those already posted to the main loop.  A pool without workers runs work and
+ * completion immediately.
+ */
+class WorkerPool : noncopyable
+{
+public:
+  /**
+   * @brief work to run on the worker with the given index
+   */
+  typedef std::function<void(size_t worker)> Work;
+  typedef std::function<void()> Completion;
+
+public:
+  WorkerPool(boost::asio::io_service& ioService, size_t nWorkers);
+
+  ~WorkerPool();
+
+  size_t
+  getWorkerCount() const
+  {
+    return m_workers.size();
+  }
+
+  void
+  submit(uint64_t key, const Work& work, const Completion& completion);
+
+  /**
+   * @brief run @p completion on the main loop after the completions of work submitted
+   *        before with the same key, without any work on a worker
+   */
+  void
+  submit(uint64_t key, const Completion& completion);
+
+private:
+  typedef std::weak_ptr<WorkerPool*> Token;
+
+  void
+  runWork(const Token& token, size_t worker, uint64_t key, uint64_t sequence, const Work& work,
+          const Completion& completion);
+
+  /**
+   * @brief call complete(), unless the pool has been destroyed
+   */
+  static void
+  completeIfAlive(const Token& token, uint64_t key, uint64_t sequence,
+                  const Completion& completion);
+
+  /**
+   * @brief run completions of @p key that are next in submission order
+   */
+  void
+  complete(uint64_t key, uint64_t sequence, const Completion& completion);
+
+private:
+  struct Worker
+  {
+    boost::asio::io_service ioService;
+    shared_ptr<boost::asio::io_service::work> work;
+    boost::thread thread;
+  };
+
+  struct KeyState
+  {
+    KeyState()
+      : nSubmitted(0)
+      , nCompleted(0)
+    {
+    }
+
+    uint64_t nSubmitted;
+    uint64_t nCompleted;
+    std::map<uint64_t, Completion> pending;  ///< completions waiting for earlier ones
+  };
+
+  boost::asio::io_service& m_ioService;
+  shared_ptr<WorkerPool*> m_self;  ///< expires when the pool is destroyed
+  std::vector<shared_ptr<Worker> > m_workers;
+  size_t m_nextWorker;
+  std::map<uint64_t, KeyState> m_keys;
+};
+
+} // namespace repo
+
+#endif // REPO_UTIL_WORKER_POOL_HPP
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * Drives a FetchPipeline over a bottleneck link simulated in discrete time, and
+ * reports the goodput of a segmented fetch for a grid of loss rates and round trip
+ * times, with AIMD congestion control and with the former fixed window of 12.
+ * Losses are drawn from a generator seeded on the command line, so a run with the
+ * same arguments always gives the same numbers.
+ *
+ * Usage: fetch-goodput-benchmark [number of segments] [seed]
+ */
+
+#include "util/fetch-pipeline.hpp"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+
+namespace repo {
+namespace tests {
+
+static const SegmentNo DEFAULT_N_SEGMENTS = 3000;
+static const uint32_t DEFAULT_SEED = 1;
+static const int MAX_RETRIES = 10;
+
+static const double LOSS_RATES[] = { 0.0, 0.001, 0.01, 0.05 };
+static const int64_t RTTS[] = { 10, 50, 100, 200 }; // milliseconds
+
+/**
+ * @brief a bottleneck link between repo and producer
+ *
+ * Interests and Data are each lost with probability lossRate.  Data leave the
+ * producer at most rate segments per millisecond, and Data that would wait in a
+ * queue longer than queueLimit segments are dropped.
+ */
+struct LinkSettings
+{
+  int64_t delay;      ///< one way delay in microseconds
+  double lossRate;
+  double rate;        ///< segments per millisecond
+  size_t queueLimit;
+};
+
+struct FetchResult
+{
+  bool isComplete;
+  double goodput;     ///< segments per second
+  uint64_t nRetransmissions;
+};
+
+static FetchResult
+simulateFetch(const LinkSettings& link, SegmentNo nSegments,
+              const CongestionWindow& window, uint32_t seed)
+{
+  typedef FetchPipeline::TimePoint TimePoint;
+  enum EventType { DATA, TIMEOUT };
+  struct Event
+  {
+    EventType type;
+    SegmentNo segment;
+    uint32_t nonce;
+  };
+
+  boost::random::mt19937 random(seed);
+  boost::random::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  FetchPipeline pipeline(0, window, RttEstimator(), MAX_RETRIES);
+  pipeline.setEndBlockId(nSegments - 1);
+
+  std::multimap<int64_t, Event> events;
+  std::set<uint32_t> pendingNonces;
+  uint32_t lastNonce = 0;
+  int64_t now = 0;
+  int64_t linkFreeTime = 0;
+  const int64_t transmissionTime = static_cast<int64_t>(1000.0 / link.rate);
+
+  FetchResult result = { false, 0.0, 0 };
+  while (true) {
+    SegmentNo segment = 0;
+    while (pipeline.getNextSegment(segment)) {
+      Event event = { TIMEOUT, segment, ++lastNonce };
+      pipeline.onSent(segment, event.nonce, TimePoint(ndn::time::microseconds(now)));
+      pendingNonces.insert(event.nonce);
+      int64_t lifetime = ndn::time::microseconds(pipeline.getInterestLifetime()).count();
+      events.insert(std::make_pair(now + lifetime, event));
+
+      if (uniform(random) < link.lossRate)
+        continue;
+      int64_t arrivalTime = now + link.delay;
+      int64_t departureTime = std::max(arrivalTime, linkFreeTime) + transmissionTime;
+      if (departureTime - arrivalTime > static_cast<int64_t>(link.queueLimit) * transmissionTime)
+        continue;
+      linkFreeTime = departureTime;
+      if (uniform(random) < link.lossRate)
+        continue;
+      event.type = DATA;
+      events.insert(std::make_pair(departureTime + link.delay, event));
+    }
+
+    if (events.empty())
+      break;
+
+    now = events.begin()->first;
+    Event event = events.begin()->second;
+    events.erase(events.begin());
+
+    // like a Face, a transmission is answered by either its Data or its timeout
+    if (pendingNonces.erase(event.nonce) == 0)
+      continue;
+
+    if (event.type == DATA) {
+      pipeline.onData(event.segment, event.nonce, TimePoint(ndn::time::microseconds(now)));
+      if (pipeline.isComplete()) {
+        result.isComplete = true;
+        break;
+      }
+    }
+    else if (pipeline.onTimeout(event.segment, event.nonce) == FetchPipeline::TIMEOUT_FAILED) {
+      break;
+    }
+  }
+
+  result.goodput = static_cast<double>(nSegments) * 1000000.0 / static_cast<double>(now);
+  result.nRetransmissions = pipeline.getRetransmissionCount();
+  return result;
+}
+
+static void
+printResult(const FetchResult& result)
+{
+  std::cout << std::setw(10) << static_cast<int64_t>(result.goodput)
+            << std::setw(8) << result.nRetransmissions
+            << (result.isComplete ? "  " : " !");
+}
+
+static int
+main(int argc, char** argv)
+{
+  SegmentNo nSegments = DEFAULT_N_SEGMENTS;
+  uint32_t seed = DEFAULT_SEED;
+  try {
+    if (argc > 1)
+      nSegments = boost::lexical_cast<SegmentNo>(argv[1]);
+    if (argc > 2)
+      seed = boost::lexical_cast<uint32_t>(argv[2]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of segments] [seed]" << std::endl;
+    return 2;
+  }
+
+  if (nSegments == 0)
+    return 0;
+
+  std::cout << nSegments << " segments over a link of 10000 segments/s with a queue of 50,"
+            << " seed " << seed << std::endl
+            << "goodput in segments/s and retransmissions, ! marks a failed fetch" << std::endl
+            << "   loss  RTT ms" << "      AIMD window" << "     fixed window" << std::endl;
+
+  for (size_t i = 0; i < sizeof(LOSS_RATES) / sizeof(LOSS_RATES[0]); ++i) {
+    for (size_t j = 0; j < sizeof(RTTS) / sizeof(RTTS[0]); ++j) {
+      LinkSettings link = { RTTS[j] * 1000 / 2, LOSS_RATES[i], 10.0, 50 };
+      FetchResult aimd = simulateFetch(link, nSegments, CongestionWindow(), seed);
+      FetchResult fixed = simulateFetch(link, nSegments,
+                                        CongestionWindow(12.0, 12.0, 12.0), seed);
+
+      std::cout << std::setw(7) << LOSS_RATES[i] << std::setw(8) << RTTS[j];
+      printResult(aimd);
+      printResult(fixed);
+      std::cout << std::endl;
+    }
+  }
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
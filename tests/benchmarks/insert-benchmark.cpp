@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * Measures the processor time spent per Data on the insert path.  Packets are
+ * decoded from their wire encoding right before each run, as they would be when
+ * received, so that no full name is cached in them yet.  The first run only
+ * prepares each Data (full name, name wire and keyLocator hash), the other runs
+ * insert them into a RepoStorage one by one and in batches.  Every insert run uses
+ * a new database in a temporary directory, which is removed afterwards.
+ *
+ * Usage: insert-benchmark [number of packets] [packet size] [batch size]
+ */
+
+#include "storage/repo-storage.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <ctime>
+#include <iostream>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_PACKETS = 20000;
+static const size_t DEFAULT_PACKET_SIZE = 1000;
+static const size_t DEFAULT_BATCH_SIZE = 256;
+
+static std::vector<shared_ptr<const Data> >
+decode(const std::vector<Block>& wires)
+{
+  std::vector<shared_ptr<const Data> > data;
+  for (size_t i = 0; i < wires.size(); ++i)
+    data.push_back(make_shared<Data>(wires[i]));
+  return data;
+}
+
+static void
+report(const std::string& title, size_t nPackets, std::clock_t start)
+{
+  double seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+  std::cout << title << ": " << nPackets << " packets, " << seconds << " s processor time, "
+            << seconds * 1e6 / nPackets << " us per packet" << std::endl;
+}
+
+static void
+runPrepare(const std::vector<Block>& wires)
+{
+  std::vector<shared_ptr<const Data> > data = decode(wires);
+  std::clock_t start = std::clock();
+  for (size_t i = 0; i < data.size(); ++i)
+    PreparedData prepared(*data[i]);
+  report("prepare", data.size(), start);
+}
+
+static void
+runInsert(const std::vector<Block>& wires, size_t batchSize)
+{
+  boost::filesystem::path dbPath = boost::filesystem::temp_directory_path() /
+                                   boost::filesystem::unique_path();
+  {
+    SqliteStorage store(dbPath.string());
+    RepoStorage storage(static_cast<int64_t>(wires.size()) * 2, store);
+    std::vector<shared_ptr<const Data> > data = decode(wires);
+
+    std::clock_t start = std::clock();
+    if (batchSize <= 1) {
+      for (size_t i = 0; i < data.size(); ++i)
+        storage.insertData(*data[i]);
+      report("insert", data.size(), start);
+    }
+    else {
+      for (size_t first = 0; first < data.size(); first += batchSize) {
+        size_t last = std::min(first + batchSize, data.size());
+        storage.insertDataBatch(std::vector<shared_ptr<const Data> >(data.begin() + first,
+                                                                     data.begin() + last));
+      }
+      report("insert in batches of " + boost::lexical_cast<std::string>(batchSize),
+             data.size(), start);
+    }
+  }
+  boost::filesystem::remove_all(dbPath);
+}
+
+static int
+main(int argc, char** argv)
+{
+  size_t nPackets = DEFAULT_N_PACKETS;
+  size_t packetSize = DEFAULT_PACKET_SIZE;
+  size_t batchSize = DEFAULT_BATCH_SIZE;
+  try {
+    if (argc > 1)
+      nPackets = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      packetSize = boost::lexical_cast<size_t>(argv[2]);
+    if (argc > 3)
+      batchSize = boost::lexical_cast<size_t>(argv[3]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of packets] [packet size] [batch size]"
+              << std::endl;
+    return 2;
+  }
+
+  if (nPackets == 0)
+    return 0;
+
+  ndn::KeyChain keyChain;
+  std::vector<uint8_t> content(packetSize, 0x55);
+  std::vector<Block> wires;
+  for (size_t i = 0; i < nPackets; ++i) {
+    Data data(Name("/benchmark/insert").appendNumber(i));
+    data.setContent(content.data(), content.size());
+    keyChain.sign(data);
+    wires.push_back(data.wireEncode());
+  }
+
+  runPrepare(wires);
+  runInsert(wires, 1);
+  runInsert(wires, batchSize);
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * Answers Interests for random Data of a RepoStorage, one at a time and in batches
+ * of growing size, and reports the throughput in Interests/s together with the
+ * latency percentiles of an Interest.  Every Interest of a batch is counted as
+ * arriving when the batch starts, so the latency includes the time it waits for
+ * the others; comparing runs at the same p99 latency shows what batching gains.
+ * The read cache is disabled, so that every Interest reaches the database.
+ *
+ * Usage: read-batch-benchmark [number of packets] [packet size] [number of Interests]
+ */
+
+#include "storage/repo-storage.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/random.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_PACKETS = 20000;
+static const size_t DEFAULT_PACKET_SIZE = 1000;
+static const size_t DEFAULT_N_INTERESTS = 50000;
+static const size_t MAX_BATCH_SIZE = 128;
+
+static void
+runBenchmark(RepoStorage& storage, const std::vector<Interest>& interests, size_t batchSize)
+{
+  std::vector<double> latencies;
+  latencies.reserve(interests.size());
+  ndn::time::steady_clock::TimePoint start = ndn::time::steady_clock::now();
+  for (size_t first = 0; first < interests.size(); first += batchSize) {
+    size_t last = std::min(first + batchSize, interests.size());
+    ndn::time::steady_clock::TimePoint batchStart = ndn::time::steady_clock::now();
+    if (batchSize == 1) {
+      if (!static_cast<bool>(storage.readData(interests[first])))
+        throw std::runtime_error("Interest " + interests[first].getName().toUri() +
+                                 " is not satisfied");
+      latencies.push_back(ndn::time::duration_cast<ndn::time::nanoseconds>(
+                            ndn::time::steady_clock::now() - batchStart).count() / 1e3);
+      continue;
+    }
+
+    std::vector<Interest> batch(interests.begin() + first, interests.begin() + last);
+    std::vector<shared_ptr<Data> > data = storage.readDataBatch(batch);
+    double latency = ndn::time::duration_cast<ndn::time::nanoseconds>(
+                       ndn::time::steady_clock::now() - batchStart).count() / 1e3;
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (!static_cast<bool>(data[i]))
+        throw std::runtime_error("Interest " + batch[i].getName().toUri() + " is not satisfied");
+      latencies.push_back(latency);
+    }
+  }
+  double seconds = ndn::time::duration_cast<ndn::time::microseconds>(
+                     ndn::time::steady_clock::now() - start).count() / 1e6;
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "batch size " << batchSize << ": " << interests.size() << " Interests in "
+            << seconds << " s: " << interests.size() / seconds << " Interests/s, latency median "
+            << latencies[latencies.size() / 2] << " us, p99 "
+            << latencies[latencies.size() * 99 / 100] << " us" << std::endl;
+}
+
+static int
+main(int argc, char** argv)
+{
+  size_t nPackets = DEFAULT_N_PACKETS;
+  size_t packetSize = DEFAULT_PACKET_SIZE;
+  size_t nInterests = DEFAULT_N_INTERESTS;
+  try {
+    if (argc > 1)
+      nPackets = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      packetSize = boost::lexical_cast<size_t>(argv[2]);
+    if (argc > 3)
+      nInterests = boost::lexical_cast<size_t>(argv[3]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of packets] [packet size]"
+              << " [number of Interests]" << std::endl;
+    return 2;
+  }
+
+  if (nPackets == 0 || nInterests == 0)
+    return 0;
+
+  boost::filesystem::path dbPath = boost::filesystem::temp_directory_path() /
+                                   boost::filesystem::unique_path();
+  {
+    SqliteStorage store(dbPath.string());
+    RepoStorage storage(static_cast<int64_t>(nPackets) * 2, store);
+
+    ndn::KeyChain keyChain;
+    std::vector<uint8_t> content(packetSize, 0x55);
+    std::vector<shared_ptr<const Data> > batch;
+    for (size_t i = 0; i < nPackets; ++i) {
+      shared_ptr<Data> data = make_shared<Data>(Name("/benchmark/read-batch").appendNumber(i));
+      data->setContent(content.data(), content.size());
+      keyChain.signWithSha256(*data);
+      batch.push_back(data);
+      if (batch.size() == 1000 || i + 1 == nPackets) {
+        storage.insertDataBatch(batch);
+        batch.clear();
+      }
+    }
+
+    std::vector<Interest> interests;
+    for (size_t i = 0; i < nInterests; ++i) {
+      uint64_t number = ndn::random::generateWord64() % nPackets;
+      interests.push_back(Interest(Name("/benchmark/read-batch").appendNumber(number)));
+    }
+
+    for (size_t batchSize = 1; batchSize <= MAX_BATCH_SIZE; batchSize *= 2)
+      runBenchmark(storage, interests, batchSize);
+  }
+  boost::filesystem::remove_all(dbPath);
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
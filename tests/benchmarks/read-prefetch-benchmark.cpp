@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ * Reads a segmented object back from a RepoStorage in segment order, the way a
+ * consumer fetching it one Interest at a time would, and reports how long each
+ * read takes.  The object is read without a read cache, with a read cache only,
+ * and with a read cache that the SegmentPrefetcher fills ahead of the reader.
+ * Prefetching happens between two reads, as it does in the repo while the next
+ * Interest is on its way, so it counts toward the total time but not toward the
+ * latency of a read.
+ *
+ * Usage: read-prefetch-benchmark [number of segments] [segment size] [prefetch depth]
+ */
+
+#include "storage/segment-prefetcher.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_SEGMENTS = 20000;
+static const size_t DEFAULT_SEGMENT_SIZE = 8000;
+static const size_t DEFAULT_PREFETCH_DEPTH = 16;
+
+static void
+runBenchmark(Storage& store, const std::vector<Name>& names, size_t nBytes,
+             size_t readCacheBytes, size_t prefetchDepth, const std::string& title)
+{
+  boost::asio::io_service ioService;
+  RepoStorage storage(static_cast<int64_t>(names.size()) * 2, store, readCacheBytes);
+  SegmentPrefetcher prefetcher(ioService, storage, prefetchDepth);
+
+  std::vector<double> latencies;
+  latencies.reserve(names.size());
+  ndn::time::steady_clock::TimePoint start = ndn::time::steady_clock::now();
+  for (size_t i = 0; i < names.size(); ++i) {
+    ndn::time::steady_clock::TimePoint readStart = ndn::time::steady_clock::now();
+    shared_ptr<Data> data = storage.readData(Interest(names[i]));
+    ndn::time::steady_clock::TimePoint readEnd = ndn::time::steady_clock::now();
+    if (!static_cast<bool>(data))
+      throw std::runtime_error("Segment " + names[i].toUri() + " is missing");
+    latencies.push_back(ndn::time::duration_cast<ndn::time::nanoseconds>(readEnd -
+                                                                         readStart).count() / 1e3);
+
+    prefetcher.onRead(*data);
+    ioService.poll();
+    ioService.reset();
+  }
+  double seconds = ndn::time::duration_cast<ndn::time::microseconds>(
+                     ndn::time::steady_clock::now() - start).count() / 1e6;
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0;
+  for (size_t i = 0; i < latencies.size(); ++i)
+    sum += latencies[i];
+
+  std::cout << title << ": " << names.size() << " segments in " << seconds << " s: "
+            << nBytes / seconds / 1000000 << " MB/s, read latency mean "
+            << sum / latencies.size() << " us, median "
+            << latencies[latencies.size() / 2] << " us, p99 "
+            << latencies[latencies.size() * 99 / 100] << " us" << std::endl;
+  storage.getReadCache().printStatistics(std::cout);
+}
+
+static int
+main(int argc, char** argv)
+{
+  size_t nSegments = DEFAULT_N_SEGMENTS;
+  size_t segmentSize = DEFAULT_SEGMENT_SIZE;
+  size_t prefetchDepth = DEFAULT_PREFETCH_DEPTH;
+  try {
+    if (argc > 1)
+      nSegments = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      segmentSize = boost::lexical_cast<size_t>(argv[2]);
+    if (argc > 3)
+      prefetchDepth = boost::lexical_cast<size_t>(argv[3]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of segments] [segment size]"
+              << " [prefetch depth]" << std::endl;
+    return 2;
+  }
+
+  if (nSegments == 0)
+    return 0;
+
+  boost::filesystem::path dbPath = boost::filesystem::temp_directory_path() /
+                                   boost::filesystem::unique_path();
+  {
+    SqliteStorage store(dbPath.string());
+    RepoStorage loader(static_cast<int64_t>(nSegments) * 2, store);
+
+    ndn::KeyChain keyChain;
+    std::vector<uint8_t> content(segmentSize, 0x55);
+    std::vector<Name> names;
+    size_t nBytes = 0;
+    for (size_t i = 0; i < nSegments; ++i) {
+      Data data(Name("/benchmark/read-prefetch").appendSegment(i));
+      data.setContent(content.data(), content.size());
+      data.setFinalBlockId(Name::Component::fromSegment(nSegments - 1));
+      keyChain.signWithSha256(data);
+      loader.insertData(data);
+      names.push_back(data.getName());
+      nBytes += data.wireEncode().size();
+    }
+
+    // enough room for the prefetch window, far less than the object
+    size_t readCacheBytes = (prefetchDepth + 1) * 4 * (segmentSize + 512);
+
+    runBenchmark(store, names, nBytes, 0, 0, "no read cache");
+    runBenchmark(store, names, nBytes, readCacheBytes, 0, "read cache");
+    runBenchmark(store, names, nBytes, readCacheBytes, prefetchDepth,
+                 "read cache, prefetch depth " + boost::lexical_cast<std::string>(prefetchDepth));
+  }
+  boost::filesystem::remove_all(dbPath);
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
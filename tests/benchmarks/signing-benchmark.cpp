@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Compares how many command responses per second ResponseSigner signs under each
+ * policy, inline and on worker threads.  The ecdsa policy uses a temporary identity,
+ * which is deleted from the KeyChain afterwards.
+ *
+ * Usage: signing-benchmark [number of responses] [max threads]
+ */
+
+#include "repo-command-response.hpp"
+#include "util/response-signer.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_RESPONSES = 2000;
+static const char* BENCHMARK_IDENTITY = "/localhost/repo-ng/signing-benchmark";
+
+class SigningBenchmark : noncopyable
+{
+public:
+  SigningBenchmark(ndn::KeyChain& keyChain, size_t nResponses)
+    : m_keyChain(keyChain)
+    , m_nResponses(nResponses)
+    , m_nSigned(0)
+  {
+    RepoCommandResponse response;
+    response.setStatusCode(300);
+    response.setProcessId(1);
+    response.setInsertNum(100);
+    m_content = response.wireEncode();
+  }
+
+  /**
+   * @return signed responses per second
+   */
+  double
+  run(ResponseSigner::Policy policy, size_t nThreads)
+  {
+    boost::asio::io_service ioService;
+    m_work.reset(new boost::asio::io_service::work(ioService));
+    m_nSigned = 0;
+    ResponseSigner signer(ioService, m_keyChain, nThreads);
+    static const uint8_t key[32] = {0};
+    signer.setHmacKey(Name(BENCHMARK_IDENTITY).append("hmac"),
+                      make_shared<ndn::Buffer>(key, sizeof(key)));
+    signer.setPolicy(policy, policy == ResponseSigner::POLICY_ECDSA ?
+                             Name(BENCHMARK_IDENTITY) : Name());
+
+    ndn::time::steady_clock::TimePoint start = ndn::time::steady_clock::now();
+    for (size_t i = 0; i < m_nResponses; ++i) {
+      shared_ptr<Data> data =
+        make_shared<Data>(Name("/repo/command/insert").appendNumber(i));
+      data->setContent(m_content);
+      signer.signAsync(data, bind(&SigningBenchmark::onSigned, this));
+    }
+    ioService.run();
+    ndn::time::nanoseconds duration = ndn::time::steady_clock::now() - start;
+    return static_cast<double>(m_nResponses) * 1000000000.0 / duration.count();
+  }
+
+private:
+  void
+  onSigned()
+  {
+    if (++m_nSigned == m_nResponses)
+      m_work.reset();
+  }
+
+private:
+  ndn::KeyChain& m_keyChain;
+  size_t m_nResponses;
+  Block m_content;
+  std::unique_ptr<boost::asio::io_service::work> m_work;
+  size_t m_nSigned;
+};
+
+static int
+main(int argc, char** argv)
+{
+  size_t nResponses = DEFAULT_N_RESPONSES;
+  size_t maxThreads = std::max<size_t>(boost::thread::hardware_concurrency(), 1);
+  try {
+    if (argc > 1)
+      nResponses = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      maxThreads = boost::lexical_cast<size_t>(argv[2]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of responses] [max threads]" << std::endl;
+    return 2;
+  }
+
+  static const char* names[] = {"identity", "digest", "hmac", "ecdsa"};
+
+  ndn::KeyChain keyChain;
+  SigningBenchmark benchmark(keyChain, nResponses);
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    ResponseSigner::Policy policy = ResponseSigner::parsePolicy(names[i]);
+    std::cout << names[i] << " inline: " << benchmark.run(policy, 0)
+              << " responses/s" << std::endl;
+    for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+      std::cout << names[i] << " on " << nThreads << " worker threads: "
+                << benchmark.run(policy, nThreads) << " responses/s" << std::endl;
+    }
+  }
+
+  keyChain.deleteIdentity(Name(BENCHMARK_IDENTITY));
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
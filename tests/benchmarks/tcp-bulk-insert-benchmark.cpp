@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Streams Data packets to a TcpBulkInsertHandle over loopback TCP connections, as
+ * fast as the handle accepts them, and reports how quickly they are stored.  The
+ * packets are spread evenly over the connections.  Unless the number of connections
+ * is given, it is varied from 1 to 8, each time without worker threads and with one
+ * worker thread per connection.  Every run uses a new database in a temporary
+ * directory, which is removed afterwards.
+ *
+ * Usage: tcp-bulk-insert-benchmark [number of packets] [packet size] [port]
+ *                                  [connections] [threads]
+ */
+
+#include "handles/tcp-bulk-insert-handle.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_PACKETS = 20000;
+static const size_t DEFAULT_PACKET_SIZE = 8000;
+static const char* DEFAULT_PORT = "17377";
+static const size_t MAX_CONNECTIONS = 8;
+
+class LoadGenerator : noncopyable
+{
+public:
+  LoadGenerator(RepoStorage& storage, const std::vector<ndn::Block>& wires,
+                const std::string& port, size_t nConnections, size_t nThreads)
+    : m_storage(storage)
+    , m_wires(wires)
+    , m_port(port)
+    , m_scheduler(m_ioService)
+    , m_handle(m_ioService, storage, nThreads)
+    , m_nSent(nConnections, 0)
+  {
+    for (size_t i = 0; i < nConnections; ++i)
+      m_sockets.push_back(make_shared<boost::asio::ip::tcp::socket>(boost::ref(m_ioService)));
+  }
+
+  /**
+   * @return seconds from connecting until the last packet is stored
+   */
+  double
+  run()
+  {
+    m_handle.listen("localhost", m_port);
+
+    boost::asio::ip::tcp::resolver resolver(m_ioService);
+    boost::asio::ip::tcp::resolver::query query("localhost", m_port);
+    boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
+    for (size_t i = 0; i < m_sockets.size(); ++i)
+      m_sockets[i]->connect(endpoint);
+
+    m_start = ndn::time::steady_clock::now();
+    for (size_t i = 0; i < m_sockets.size(); ++i)
+      send(i);
+    checkStored();
+    m_ioService.run();
+    return ndn::time::duration_cast<ndn::time::microseconds>(m_end - m_start).count() / 1e6;
+  }
+
+private:
+  /**
+   * @brief send the next packet of a connection, which sends every nConnections-th packet
+   */
+  void
+  send(size_t connection)
+  {
+    size_t packet = m_nSent[connection] * m_sockets.size() + connection;
+    if (packet >= m_wires.size())
+      return;
+
+    ++m_nSent[connection];
+    const ndn::Block& wire = m_wires[packet];
+    boost::asio::async_write(*m_sockets[connection],
+                             boost::asio::buffer(wire.wire(), wire.size()),
+                             bind(&LoadGenerator::onSent, this, _1, connection));
+  }
+
+  void
+  onSent(const boost::system::error_code& error, size_t connection)
+  {
+    if (error)
+      throw std::runtime_error("Send failed: " + error.message());
+    send(connection);
+  }
+
+  /**
+   * @return whether the last packet of every connection is stored
+   */
+  bool
+  isStored()
+  {
+    for (size_t i = 0; i < m_sockets.size() && i < m_wires.size(); ++i) {
+      size_t last = (m_wires.size() - 1 - i) / m_sockets.size() * m_sockets.size() + i;
+      if (!static_cast<bool>(m_storage.readData(ndn::Interest(ndn::Data(m_wires[last]).getName()))))
+        return false;
+    }
+    return true;
+  }
+
+  void
+  checkStored()
+  {
+    if (isStored()) {
+      m_end = ndn::time::steady_clock::now();
+      for (size_t i = 0; i < m_sockets.size(); ++i)
+        m_sockets[i]->close();
+      m_handle.stop();
+      m_ioService.stop();
+      return;
+    }
+    m_scheduler.scheduleEvent(ndn::time::milliseconds(1), bind(&LoadGenerator::checkStored, this));
+  }
+
+private:
+  RepoStorage& m_storage;
+  const std::vector<ndn::Block>& m_wires;
+  std::string m_port;
+  boost::asio::io_service m_ioService;
+  ndn::Scheduler m_scheduler;
+  std::vector<shared_ptr<boost::asio::ip::tcp::socket> > m_sockets;
+  TcpBulkInsertHandle m_handle;
+  std::vector<size_t> m_nSent;
+  ndn::time::steady_clock::TimePoint m_start;
+  ndn::time::steady_clock::TimePoint m_end;
+};
+
+static void
+runBenchmark(const std::vector<ndn::Block>& wires, size_t nBytes, const std::string& port,
+             size_t nConnections, size_t nThreads)
+{
+  boost::filesystem::path dbPath = boost::filesystem::temp_directory_path() /
+                                   boost::filesystem::unique_path();
+  double seconds = 0;
+  {
+    SqliteStorage store(dbPath.string());
+    RepoStorage storage(static_cast<int64_t>(wires.size()) * 2, store);
+    LoadGenerator generator(storage, wires, port, nConnections, nThreads);
+    seconds = generator.run();
+  }
+  boost::filesystem::remove_all(dbPath);
+
+  std::cout << nConnections << " connections, " << nThreads << " threads: "
+            << wires.size() << " packets, " << nBytes << " octets in " << seconds << " s: "
+            << nBytes / seconds / 1000000 << " MB/s, "
+            << wires.size() / seconds << " packets/s" << std::endl;
+}
+
+static int
+main(int argc, char** argv)
+{
+  size_t nPackets = DEFAULT_N_PACKETS;
+  size_t packetSize = DEFAULT_PACKET_SIZE;
+  std::string port = DEFAULT_PORT;
+  size_t nConnections = 0;
+  size_t nThreads = 0;
+  try {
+    if (argc > 1)
+      nPackets = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      packetSize = boost::lexical_cast<size_t>(argv[2]);
+    if (argc > 3)
+      port = argv[3];
+    if (argc > 4)
+      nConnections = boost::lexical_cast<size_t>(argv[4]);
+    if (argc > 5)
+      nThreads = boost::lexical_cast<size_t>(argv[5]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0] << " [number of packets] [packet size] [port]"
+              << " [connections] [threads]" << std::endl;
+    return 2;
+  }
+
+  ndn::KeyChain keyChain;
+  std::vector<uint8_t> content(packetSize, 0x55);
+  std::vector<ndn::Block> wires;
+  size_t nBytes = 0;
+  for (size_t i = 0; i < nPackets; ++i) {
+    ndn::Data data(ndn::Name("/benchmark/tcp-bulk-insert").appendSegment(i));
+    data.setContent(content.data(), content.size());
+    keyChain.signWithSha256(data);
+    wires.push_back(data.wireEncode());
+    nBytes += data.wireEncode().size();
+  }
+
+  if (nPackets == 0)
+    return 0;
+
+  if (nConnections > 0) {
+    runBenchmark(wires, nBytes, port, nConnections, nThreads);
+    return 0;
+  }
+
+  for (size_t connections = 1; connections <= MAX_CONNECTIONS; connections *= 2) {
+    runBenchmark(wires, nBytes, port, connections, 0);
+    runBenchmark(wires, nBytes, port, connections, connections);
+  }
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Compares how many received segments per second WriteHandle can authenticate
+ * by verifying each signature, and by checking each digest against a full name
+ * listed in a validated manifest, and how signature verification scales with the
+ * number of worker threads of a WorkerPool.
+ *
+ * Usage: validation-benchmark [number of segments] [segment size] [max threads]
+ */
+
+#include "repo-manifest.hpp"
+#include "util/worker-pool.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <vector>
+
+namespace repo {
+namespace tests {
+
+static const size_t DEFAULT_N_SEGMENTS = 2000;
+static const size_t DEFAULT_SEGMENT_SIZE = 8192;
+
+typedef bool (*VerifySegment)(const ndn::Data& segment, const ndn::PublicKey& publicKey,
+                              const ndn::Name& fullName);
+
+static bool
+verifySignature(const ndn::Data& segment, const ndn::PublicKey& publicKey,
+                const ndn::Name& fullName)
+{
+  return ndn::Validator::verifySignature(segment, publicKey);
+}
+
+static bool
+verifyDigest(const ndn::Data& segment, const ndn::PublicKey& publicKey,
+             const ndn::Name& fullName)
+{
+  return segment.getFullName() == fullName;
+}
+
+/**
+ * @return verified segments per second
+ */
+static double
+measure(const std::vector<ndn::Block>& wires, const std::vector<ndn::Name>& fullNames,
+        const ndn::PublicKey& publicKey, VerifySegment verify)
+{
+  ndn::time::steady_clock::TimePoint start = ndn::time::steady_clock::now();
+  for (size_t i = 0; i < wires.size(); ++i) {
+    // decode every segment afresh, like a received one, whose full name is not cached
+    ndn::Data segment(wires[i]);
+    if (!verify(segment, publicKey, fullNames[i]))
+      throw std::runtime_error("Segment " + segment.getName().toUri() + " failed verification");
+  }
+  ndn::time::nanoseconds duration = ndn::time::steady_clock::now() - start;
+  return static_cast<double>(wires.size()) * 1000000000.0 / duration.count();
+}
+
+/**
+ * @brief verifies segments submitted to a WorkerPool under one key, like one insert process
+ */
+class ParallelVerification : noncopyable
+{
+public:
+  ParallelVerification(const std::vector<ndn::Block>& wires, const ndn::PublicKey& publicKey)
+    : m_wires(wires)
+    , m_publicKey(publicKey)
+    , m_nCompleted(0)
+  {
+  }
+
+  /**
+   * @return verified segments per second
+   */
+  double
+  run(size_t nThreads)
+  {
+    boost::asio::io_service ioService;
+    m_work.reset(new boost::asio::io_service::work(ioService));
+    m_nCompleted = 0;
+    WorkerPool pool(ioService, nThreads);
+
+    ndn::time::steady_clock::TimePoint start = ndn::time::steady_clock::now();
+    for (size_t i = 0; i < m_wires.size(); ++i) {
+      pool.submit(0, bind(&ParallelVerification::verify, this, i),
+                  bind(&ParallelVerification::onVerified, this));
+    }
+    ioService.run();
+    ndn::time::nanoseconds duration = ndn::time::steady_clock::now() - start;
+    return static_cast<double>(m_wires.size()) * 1000000000.0 / duration.count();
+  }
+
+private:
+  void
+  verify(size_t index)
+  {
+    ndn::Data segment(m_wires[index]);
+    if (!ndn::Validator::verifySignature(segment, m_publicKey))
+      throw std::runtime_error("Segment " + segment.getName().toUri() + " failed verification");
+  }
+
+  void
+  onVerified()
+  {
+    if (++m_nCompleted == m_wires.size())
+      m_work.reset();
+  }
+
+private:
+  const std::vector<ndn::Block>& m_wires;
+  const ndn::PublicKey& m_publicKey;
+  std::unique_ptr<boost::asio::io_service::work> m_work;
+  size_t m_nCompleted;
+};
+
+static int
+main(int argc, char** argv)
+{
+  size_t nSegments = DEFAULT_N_SEGMENTS;
+  size_t segmentSize = DEFAULT_SEGMENT_SIZE;
+  size_t maxThreads = std::max<size_t>(boost::thread::hardware_concurrency(), 1);
+  try {
+    if (argc > 1)
+      nSegments = boost::lexical_cast<size_t>(argv[1]);
+    if (argc > 2)
+      segmentSize = boost::lexical_cast<size_t>(argv[2]);
+    if (argc > 3)
+      maxThreads = boost::lexical_cast<size_t>(argv[3]);
+  }
+  catch (boost::bad_lexical_cast&) {
+    std::cerr << "Usage: " << argv[0]
+              << " [number of segments] [segment size] [max threads]" << std::endl;
+    return 2;
+  }
+
+  ndn::KeyChain keyChain;
+  ndn::shared_ptr<ndn::IdentityCertificate> certificate =
+    keyChain.getCertificate(keyChain.getDefaultCertificateName());
+  const ndn::PublicKey& publicKey = certificate->getPublicKeyInfo();
+
+  std::vector<uint8_t> content(segmentSize, 0x55);
+  std::vector<ndn::Block> wires;
+  std::vector<ndn::Name> fullNames;
+  RepoManifest manifest;
+  for (size_t i = 0; i < nSegments; ++i) {
+    ndn::Data segment(ndn::Name("/benchmark/object").appendSegment(i));
+    segment.setContent(content.data(), content.size());
+    keyChain.sign(segment);
+    wires.push_back(segment.wireEncode());
+    fullNames.push_back(segment.getFullName());
+    manifest.addEntry(segment.getFullName());
+  }
+
+  std::cout << nSegments << " segments of " << segmentSize << " octets, manifest of "
+            << manifest.wireEncode().size() << " octets" << std::endl;
+  std::cout << "signature verification: "
+            << measure(wires, fullNames, publicKey, &verifySignature)
+            << " segments/s" << std::endl;
+  std::cout << "digest check:           "
+            << measure(wires, fullNames, publicKey, &verifyDigest)
+            << " segments/s" << std::endl;
+
+  ParallelVerification parallel(wires, publicKey);
+  double singleThreadRate = 0.0;
+  for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+    double rate = parallel.run(nThreads);
+    if (nThreads == 1)
+      singleThreadRate = rate;
+    std::cout << "signature verification on " << nThreads << " worker threads: "
+              << rate << " segments/s, speedup " << rate / singleThreadRate << std::endl;
+  }
+  return 0;
+}
+
+} // namespace tests
+} // namespace repo
+
+int
+main(int argc, char** argv)
+{
+  return repo::tests::main(argc, argv);
+}
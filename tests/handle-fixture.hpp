@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPO_TESTS_HANDLE_FIXTURE_HPP
+#define REPO_TESTS_HANDLE_FIXTURE_HPP
+
+#include "repo-command-parameter.hpp"
+#include "repo-command-response.hpp"
+#include "util/response-signer.hpp"
+#include "util/validation-pool.hpp"
+
+#include "repo-storage-fixture.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+/**
+ * @brief everything a handle needs, on a DummyClientFace, accepting every command and Data
+ *
+ * Time is not simulated: advance() runs the event loop for the given wall clock time.
+ * Tests that count what happened at an Interest timeout check half a lifetime away
+ * from it, so that a slow machine does not move the timeout across the check.
+ */
+class HandleFixture : public RepoStorageFixture
+{
+public:
+  HandleFixture()
+    : face(ndn::util::makeDummyClientFace(io, makeFaceOptions()))
+    , scheduler(io)
+    , validator(*face)
+    , validationPool(io, validator, nullptr, 0)
+    , signer(io, keyChain)
+  {
+    validator.load("trust-anchor\n{\n  type any\n}\n", "handle-fixture");
+    signer.setPolicy(ResponseSigner::POLICY_DIGEST_SHA256);
+  }
+
+  static ndn::util::DummyClientFace::Options
+  makeFaceOptions()
+  {
+    // prefix registrations succeed
+    ndn::util::DummyClientFace::Options options = { true, true };
+    return options;
+  }
+
+  /**
+   * @brief run the event loop for @p duration
+   */
+  void
+  advance(const ndn::time::milliseconds& duration)
+  {
+    scheduler.scheduleEvent(duration, bind(&boost::asio::io_service::stop, &io));
+    io.run();
+    io.reset();
+  }
+
+  shared_ptr<Data>
+  makeData(const Name& name, const std::string& content)
+  {
+    shared_ptr<Data> data = make_shared<Data>(name);
+    data->setContent(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    keyChain.sign(*data);
+    return data;
+  }
+
+  /**
+   * @brief send a command Interest under @p commandPrefix, and return its response
+   */
+  RepoCommandResponse
+  sendCommand(const Name& commandPrefix, const RepoCommandParameter& parameter)
+  {
+    Name commandName(commandPrefix);
+    commandName.append(parameter.wireEncode());
+    face->receive(Interest(commandName));
+    advance(ndn::time::milliseconds(10));
+    return getResponse(commandName);
+  }
+
+  RepoCommandResponse
+  getResponse(const Name& commandName)
+  {
+    for (std::vector<Data>::reverse_iterator i = face->sentDatas.rbegin();
+         i != face->sentDatas.rend(); ++i) {
+      if (i->getName() == commandName)
+        return RepoCommandResponse(i->getContent().blockFromValue());
+    }
+    BOOST_FAIL("no response to " << commandName);
+    return RepoCommandResponse();
+  }
+
+  /**
+   * @brief get the number of Interests the handle expressed for @p name
+   */
+  size_t
+  countInterests(const Name& name) const
+  {
+    size_t nInterests = 0;
+    for (std::vector<Interest>::const_iterator i = face->sentInterests.begin();
+         i != face->sentInterests.end(); ++i) {
+      if (i->getName() == name)
+        ++nInterests;
+    }
+    return nInterests;
+  }
+
+public:
+  boost::asio::io_service io;
+  shared_ptr<ndn::util::DummyClientFace> face;
+  Scheduler scheduler;
+  ValidatorConfig validator;
+  ValidationPool validationPool;
+  KeyChain keyChain;
+  ResponseSigner signer;
+};
+
+} // namespace tests
+} // namespace repo
+
+#endif // REPO_TESTS_HANDLE_FIXTURE_HPP
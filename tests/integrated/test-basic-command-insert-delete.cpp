@@ -52,8 +52,10 @@ public:
   Fixture()
     : scheduler(repoFace.getIoService())
     , validator(repoFace)
-    , writeHandle(repoFace, *handle, keyChain, scheduler, validator)
-    , deleteHandle(repoFace, *handle, keyChain, scheduler, validator)
+    , validationPool(repoFace.getIoService(), validator, nullptr, 0)
+    , signer(repoFace.getIoService(), keyChain)
+    , writeHandle(repoFace, *handle, signer, scheduler, validator, validationPool)
+    , deleteHandle(repoFace, *handle, signer, scheduler, validator)
     , insertFace(repoFace.getIoService())
     , deleteFace(repoFace.getIoService())
   {
@@ -116,7 +118,9 @@ public:
   Face repoFace;
   Scheduler scheduler;
   ValidatorConfig validator;
+  ValidationPool validationPool;
   KeyChain keyChain;
+  ResponseSigner signer;
   WriteHandle writeHandle;
   DeleteHandle deleteHandle;
   Face insertFace;
@@ -42,6 +42,7 @@ namespace random=ndn::random;
 BOOST_AUTO_TEST_SUITE(TestBasicCommandWatchDelete)
 
 const static uint8_t content[8] = {3, 1, 4, 1, 5, 9, 2, 6};
+const static size_t N_CONCURRENT_WATCHES = 1000;
 
 template<class Dataset>
 class Fixture : public RepoStorageFixture, public Dataset
@@ -50,7 +51,9 @@ public:
   Fixture()
     : scheduler(repoFace.getIoService())
     , validator(repoFace)
-    , watchHandle(repoFace, *handle, keyChain, scheduler, validator)
+    , validationPool(repoFace.getIoService(), validator, nullptr, 0)
+    , signer(repoFace.getIoService(), keyChain)
+    , watchHandle(repoFace, *handle, signer, scheduler, validator, validationPool)
     , watchFace(repoFace.getIoService())
   {
     watchHandle.listen(Name("/repo/command"));
@@ -97,11 +100,22 @@ public:
   void
   checkWatchOk(const Interest& interest);
 
+  void
+  scheduleConcurrentWatchEvents();
+
+  void
+  onConcurrentWatchInterest(const Interest& interest);
+
+  void
+  checkConcurrentWatchesOk();
+
 public:
   Face repoFace;
   Scheduler scheduler;
   ValidatorConfig validator;
+  ValidationPool validationPool;
   KeyChain keyChain;
+  ResponseSigner signer;
   WatchHandle watchHandle;
   Face watchFace;
   std::map<Name, EventId> watchEvents;
@@ -244,6 +258,59 @@ Fixture<T>::scheduleWatchEvent()
                               bind(&Fixture<T>::onRegisterFailed, this, _2));
 }
 
+template<class T> void
+Fixture<T>::scheduleConcurrentWatchEvents()
+{
+  // every watch fetches one Data, and then stops on its own limit of two Interests
+  for (size_t i = 0; i < N_CONCURRENT_WATCHES; ++i) {
+    Name watchCommandName("/repo/command/watch/start");
+    RepoCommandParameter watchParameter;
+    watchParameter.setName(Name("/concurrent").appendNumber(i));
+    watchParameter.setMaxInterestNum(2);
+    watchParameter.setInterestLifetime(milliseconds(2000));
+    watchCommandName.append(watchParameter.wireEncode());
+    Interest watchInterest(watchCommandName);
+    keyChain.signByIdentity(watchInterest, keyChain.getDefaultIdentity());
+    scheduler.scheduleEvent(milliseconds(1000 + i),
+                            bind(&Fixture<T>::sendWatchStartInterest, this, watchInterest));
+  }
+
+  watchFace.setInterestFilter("/concurrent",
+                              bind(&Fixture<T>::onConcurrentWatchInterest, this, _2),
+                              ndn::RegisterPrefixSuccessCallback(),
+                              bind(&Fixture<T>::onRegisterFailed, this, _2));
+
+  scheduler.scheduleEvent(seconds(20),
+                          bind(&Fixture<T>::checkConcurrentWatchesOk, this));
+}
+
+template<class T> void
+Fixture<T>::onConcurrentWatchInterest(const Interest& interest)
+{
+  // only the first Interest of a watch, which excludes nothing, is answered
+  if (!interest.getExclude().empty() || interest.getMinSuffixComponents() > 1)
+    return;
+
+  shared_ptr<Data> data = make_shared<Data>(Name(interest.getName()).appendNumber(0));
+  data->setContent(content, sizeof(content));
+  data->setFreshnessPeriod(milliseconds(0));
+  keyChain.signByIdentity(*data, keyChain.getDefaultIdentity());
+  watchFace.put(*data);
+}
+
+template<class T> void
+Fixture<T>::checkConcurrentWatchesOk()
+{
+  // a watch starting must not have disturbed any other one
+  for (size_t i = 0; i < N_CONCURRENT_WATCHES; ++i) {
+    Name name = Name("/concurrent").appendNumber(i).appendNumber(0);
+    shared_ptr<Data> data = handle->readData(Interest(name));
+    BOOST_REQUIRE_MESSAGE(static_cast<bool>(data), "Missing " << name);
+    BOOST_CHECK_EQUAL(memcmp(data->getContent().value(), content, sizeof(content)), 0);
+  }
+  stopFaceProcess();
+}
+
 typedef boost::mpl::vector< BasicDataset > Dataset;
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(WatchDelete, T, Dataset, Fixture<T>)
@@ -261,6 +328,20 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(WatchDelete, T, Dataset, Fixture<T>)
   this->repoFace.getIoService().run();
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(ConcurrentWatches, T, Dataset, Fixture<T>)
+{
+  this->generateDefaultCertificateFile();
+  this->validator.load("tests/integrated/insert-delete-validator-config.conf");
+
+  this->scheduler.scheduleEvent(seconds(0),
+                                bind(&Fixture<T>::scheduleConcurrentWatchEvents, this));
+
+  // checkConcurrentWatchesOk terminates IO earlier unless something is stuck
+  this->scheduler.scheduleEvent(seconds(60),
+                                bind(&Fixture<T>::stopFaceProcess, this));
+  this->repoFace.getIoService().run();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } //namespace tests
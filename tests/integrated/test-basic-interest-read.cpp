@@ -42,7 +42,8 @@ class BasicInterestReadFixture : public RepoStorageFixture, public Dataset
 public:
   BasicInterestReadFixture()
     : scheduler(repoFace.getIoService())
-    , readHandle(repoFace, *handle, keyChain, scheduler)
+    , signer(repoFace.getIoService(), keyChain)
+    , readHandle(repoFace, *handle, signer, scheduler)
     , readFace(repoFace.getIoService())
   {
   }
@@ -111,6 +112,7 @@ public:
   ndn::Face repoFace;
   ndn::KeyChain keyChain;
   ndn::Scheduler scheduler;
+  ResponseSigner signer;
   ReadHandle readHandle;
   ndn::Face readFace;
 };
@@ -46,7 +46,8 @@ class Node : public RepoStorageFixture, public Actionset
 public:
   Node(ndn::Face& face, const Name& creatorName, KeyChain& keyChain, std::string path)
     : validator(face)
-    , sync("/ndn/broadcast", creatorName, path, face, keyChain, validator, *handle)
+    , signer(face.getIoService(), keyChain)
+    , sync("/ndn/broadcast", creatorName, path, face, signer, validator, *handle)
     , creator(creatorName)
     , dbPath(path)
   {
@@ -101,6 +102,7 @@ public:
 
 private:
   ValidatorConfig validator;
+  ResponseSigner signer;
   RepoSync sync;
   Name creator;
   std::string dbPath;
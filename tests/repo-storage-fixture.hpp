@@ -37,6 +37,16 @@ public:
   {
   }
 
+  /**
+   * @brief use @p storage in place of a SqliteStorage in unittestdb
+   */
+  explicit
+  RepoStorageFixture(const shared_ptr<Storage>& storage)
+    : store(storage)
+    , handle(new RepoStorage(static_cast<int64_t>(65535), *store))
+  {
+  }
+
   ~RepoStorageFixture()
   {
     boost::filesystem::remove_all(boost::filesystem::path("unittestdb"));
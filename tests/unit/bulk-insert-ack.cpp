@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bulk-insert-ack.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(BulkInsertAck)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  repo::BulkInsertAck ack;
+  ack.setStatusCode(507)
+    .setInsertNum(3)
+    .setDuplicateNum(1)
+    .setFailedNum(2)
+    .setLastName("/a");
+
+  ndn::Block wire = ack.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xdc, 0x12, 0xd0, 0x02, 0x01, 0xfb, 0xd1, 0x01, 0x03, 0xdd, 0x01, 0x01,
+    0xde, 0x01, 0x02, 0x07, 0x03, 0x08, 0x01, 0x61
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::BulkInsertAck decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.getStatusCode(), 507);
+  BOOST_CHECK_EQUAL(decoded.getInsertNum(), 3);
+  BOOST_CHECK_EQUAL(decoded.getDuplicateNum(), 1);
+  BOOST_CHECK_EQUAL(decoded.getFailedNum(), 2);
+  BOOST_CHECK_EQUAL(decoded.getProcessedNum(), 6);
+  BOOST_CHECK_EQUAL(decoded.getLastName(), Name("/a"));
+}
+
+BOOST_AUTO_TEST_CASE(WithoutLastName)
+{
+  repo::BulkInsertAck ack;
+  ack.setFailedNum(1);
+
+  repo::BulkInsertAck decoded(ack.wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getStatusCode(), 200);
+  BOOST_CHECK_EQUAL(decoded.getProcessedNum(), 1);
+  BOOST_CHECK(decoded.getLastName().empty());
+
+  // BulkInsertAck missing FailedNum
+  static const uint8_t wire[] = {
+    0xdc, 0x09, 0xd0, 0x01, 0xc8, 0xd1, 0x01, 0x00, 0xdd, 0x01, 0x00
+  };
+  BOOST_CHECK_THROW(decoded.wireDecode(ndn::Block(wire, sizeof(wire))),
+                    repo::BulkInsertAck::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/certificate-cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(CertificateCache)
+
+static shared_ptr<ndn::IdentityCertificate>
+makeCertificate(const std::string& keyName, const ndn::time::milliseconds& validity)
+{
+  shared_ptr<ndn::IdentityCertificate> certificate = make_shared<ndn::IdentityCertificate>();
+  certificate->setName(Name(keyName).append("ID-CERT").appendVersion(1));
+  certificate->setNotBefore(ndn::time::system_clock::now() - ndn::time::seconds(1));
+  certificate->setNotAfter(ndn::time::system_clock::now() + validity);
+  return certificate;
+}
+
+BOOST_AUTO_TEST_CASE(HitsAndMisses)
+{
+  repo::SharedCertificateCache cache;
+  shared_ptr<ndn::IdentityCertificate> certificate =
+    makeCertificate("/test/KEY/ksk-1", ndn::time::seconds(3600));
+  Name nameWithoutVersion = certificate->getName().getPrefix(-1);
+
+  BOOST_CHECK(!static_cast<bool>(cache.getCertificate(nameWithoutVersion)));
+  cache.insertCertificate(certificate);
+  BOOST_CHECK_EQUAL(cache.getSize(), 1);
+  BOOST_CHECK(cache.getCertificate(nameWithoutVersion) == certificate);
+
+  repo::SharedCertificateCache::Counters counters = cache.getCounters();
+  BOOST_CHECK_EQUAL(counters.nHits, 1);
+  BOOST_CHECK_EQUAL(counters.nMisses, 1);
+  BOOST_CHECK_EQUAL(counters.nInsertions, 1);
+
+  cache.reset();
+  BOOST_CHECK_EQUAL(cache.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  repo::SharedCertificateCache cache(ndn::time::milliseconds(0));
+  shared_ptr<ndn::IdentityCertificate> certificate =
+    makeCertificate("/test/KEY/ksk-1", ndn::time::seconds(3600));
+  cache.insertCertificate(certificate);
+  BOOST_CHECK(!static_cast<bool>(cache.getCertificate(certificate->getName().getPrefix(-1))));
+  BOOST_CHECK_EQUAL(cache.getSize(), 0);
+
+  repo::SharedCertificateCache longCache;
+  shared_ptr<ndn::IdentityCertificate> expired =
+    makeCertificate("/test/KEY/ksk-2", ndn::time::seconds(-1));
+  longCache.insertCertificate(expired);
+  BOOST_CHECK_EQUAL(longCache.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction)
+{
+  repo::SharedCertificateCache cache(ndn::time::seconds(3600), 2);
+  shared_ptr<ndn::IdentityCertificate> first =
+    makeCertificate("/test/KEY/ksk-1", ndn::time::seconds(60));
+  shared_ptr<ndn::IdentityCertificate> second =
+    makeCertificate("/test/KEY/ksk-2", ndn::time::seconds(7200));
+  shared_ptr<ndn::IdentityCertificate> third =
+    makeCertificate("/test/KEY/ksk-3", ndn::time::seconds(7200));
+  cache.insertCertificate(first);
+  cache.insertCertificate(second);
+  cache.insertCertificate(third);
+
+  BOOST_CHECK_EQUAL(cache.getSize(), 2);
+  BOOST_CHECK_EQUAL(cache.getCounters().nEvictions, 1);
+  // the certificate expiring first is the one evicted
+  BOOST_CHECK(!static_cast<bool>(cache.getCertificate(first->getName().getPrefix(-1))));
+  BOOST_CHECK(static_cast<bool>(cache.getCertificate(third->getName().getPrefix(-1))));
+}
+
+BOOST_AUTO_TEST_CASE(RefreshedEntryExpiresLater)
+{
+  repo::SharedCertificateCache cache(ndn::time::seconds(3600), 2);
+  shared_ptr<ndn::IdentityCertificate> first =
+    makeCertificate("/test/KEY/ksk-1", ndn::time::seconds(60));
+  shared_ptr<ndn::IdentityCertificate> second =
+    makeCertificate("/test/KEY/ksk-2", ndn::time::seconds(7200));
+  cache.insertCertificate(first);
+  cache.insertCertificate(second);
+
+  // a renewed certificate replaces the entry, and its place in the expiry order
+  shared_ptr<ndn::IdentityCertificate> renewed =
+    makeCertificate("/test/KEY/ksk-1", ndn::time::seconds(7200));
+  cache.insertCertificate(renewed);
+  BOOST_CHECK_EQUAL(cache.getSize(), 2);
+  BOOST_CHECK_EQUAL(cache.getCounters().nEvictions, 0);
+
+  cache.insertCertificate(makeCertificate("/test/KEY/ksk-3", ndn::time::seconds(7200)));
+  BOOST_CHECK_EQUAL(cache.getSize(), 2);
+  BOOST_CHECK_EQUAL(cache.getCounters().nEvictions, 1);
+  BOOST_CHECK(cache.getCertificate(first->getName().getPrefix(-1)) == renewed);
+  BOOST_CHECK(!static_cast<bool>(cache.getCertificate(second->getName().getPrefix(-1))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
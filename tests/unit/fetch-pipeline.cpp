@@ -0,0 +1,321 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/fetch-pipeline.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(FetchPipeline)
+
+BOOST_AUTO_TEST_CASE(RttEstimatorRto)
+{
+  repo::RttEstimator estimator(ndn::time::milliseconds(1000), ndn::time::milliseconds(200),
+                               ndn::time::milliseconds(4000));
+  BOOST_CHECK_EQUAL(estimator.getRto(), ndn::time::milliseconds(1000));
+
+  estimator.addMeasurement(ndn::time::milliseconds(100));
+  BOOST_CHECK_CLOSE(estimator.getSmoothedRtt(), 100.0, 0.001);
+  BOOST_CHECK_CLOSE(estimator.getRttVariation(), 50.0, 0.001);
+  BOOST_CHECK_EQUAL(estimator.getRto(), ndn::time::milliseconds(300));
+
+  // a stable RTT makes RTTVAR shrink, until RTO hits its lower bound
+  for (int i = 0; i < 50; ++i)
+    estimator.addMeasurement(ndn::time::milliseconds(100));
+  BOOST_CHECK_EQUAL(estimator.getRto(), ndn::time::milliseconds(200));
+
+  estimator.backoff();
+  BOOST_CHECK_EQUAL(estimator.getRto(), ndn::time::milliseconds(400));
+  for (int i = 0; i < 10; ++i)
+    estimator.backoff();
+  BOOST_CHECK_EQUAL(estimator.getRto(), ndn::time::milliseconds(4000));
+}
+
+BOOST_AUTO_TEST_CASE(CongestionWindowAimd)
+{
+  repo::CongestionWindow window(2.0, 1.0, 64.0);
+  BOOST_CHECK(window.isInSlowStart());
+
+  // slow start: one more segment per acknowledged segment
+  for (int i = 0; i < 6; ++i)
+    window.increase();
+  BOOST_CHECK_EQUAL(window.getSize(), 8);
+
+  window.decrease();
+  BOOST_CHECK_EQUAL(window.getSize(), 4);
+  BOOST_CHECK(!window.isInSlowStart());
+
+  // congestion avoidance: one more segment per window of acknowledged segments
+  for (int i = 0; i < 4; ++i)
+    window.increase();
+  BOOST_CHECK_EQUAL(window.getSize(), 4);
+  window.increase();
+  BOOST_CHECK_EQUAL(window.getSize(), 5);
+
+  for (int i = 0; i < 10000; ++i)
+    window.increase();
+  BOOST_CHECK_EQUAL(window.getSize(), 64);
+
+  for (int i = 0; i < 20; ++i)
+    window.decrease();
+  BOOST_CHECK_EQUAL(window.getSize(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FastRetransmit)
+{
+  typedef repo::FetchPipeline::TimePoint TimePoint;
+  TimePoint now;
+
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(5.0), repo::RttEstimator(), 3);
+  pipeline.setEndBlockId(9);
+
+  SegmentNo segment = 0;
+  for (SegmentNo i = 0; i < 5; ++i) {
+    BOOST_REQUIRE(pipeline.getNextSegment(segment));
+    BOOST_CHECK_EQUAL(segment, i);
+    pipeline.onSent(segment, static_cast<uint32_t>(segment), now);
+  }
+  BOOST_CHECK(!pipeline.getNextSegment(segment));
+
+  now += ndn::time::milliseconds(10);
+  BOOST_CHECK(pipeline.onData(1, 1, now));
+  BOOST_CHECK(pipeline.onData(2, 2, now));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 7);
+  BOOST_CHECK(pipeline.onData(3, 3, now));
+
+  // segment 0 was overtaken three times, so it is requested again before new segments,
+  // and the window of 7 is halved
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 3);
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  BOOST_CHECK_EQUAL(segment, 0);
+  pipeline.onSent(segment, 100, now);
+  BOOST_CHECK_EQUAL(pipeline.getRetransmissionCount(), 1);
+
+  // the original Interest timing out later is not a new loss
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(0, 0), repo::FetchPipeline::TIMEOUT_IGNORED);
+
+  // Data answering either transmission completes the segment, but only once
+  BOOST_CHECK(pipeline.onData(0, 0, now));
+  BOOST_CHECK(!pipeline.onData(0, 100, now));
+  BOOST_CHECK(!pipeline.isComplete());
+}
+
+BOOST_AUTO_TEST_CASE(RetryLimit)
+{
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(1.0), repo::RttEstimator(), 2);
+  pipeline.setEndBlockId(0);
+
+  SegmentNo segment = 0;
+  uint32_t nonce = 0;
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  pipeline.onSent(segment, nonce, repo::FetchPipeline::TimePoint());
+  for (int i = 0; i < 2; ++i) {
+    BOOST_CHECK_EQUAL(pipeline.onTimeout(segment, nonce), repo::FetchPipeline::TIMEOUT_RETRY);
+    BOOST_REQUIRE(pipeline.getNextSegment(segment));
+    pipeline.onSent(segment, ++nonce, repo::FetchPipeline::TimePoint());
+  }
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(segment, nonce), repo::FetchPipeline::TIMEOUT_FAILED);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidData)
+{
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(4.0), repo::RttEstimator(), 1);
+  pipeline.setEndBlockId(9);
+
+  SegmentNo segment = 0;
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  pipeline.onSent(segment, 0, repo::FetchPipeline::TimePoint());
+
+  // the segment is requested again, without any congestion reaction
+  BOOST_CHECK_EQUAL(pipeline.onInvalidData(0, 0), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.getInFlight(), 0);
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 4);
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(1000));
+  BOOST_CHECK_EQUAL(pipeline.onInvalidData(0, 0), repo::FetchPipeline::TIMEOUT_IGNORED);
+
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  BOOST_CHECK_EQUAL(segment, 0);
+  pipeline.onSent(segment, 1, repo::FetchPipeline::TimePoint());
+  BOOST_CHECK_EQUAL(pipeline.onInvalidData(0, 1), repo::FetchPipeline::TIMEOUT_FAILED);
+}
+
+BOOST_AUTO_TEST_CASE(MultipleObjects)
+{
+  typedef repo::FetchPipeline::TimePoint TimePoint;
+  TimePoint now;
+
+  repo::FetchPipeline pipeline(repo::CongestionWindow(6.0), repo::RttEstimator(), 3);
+  BOOST_CHECK_EQUAL(pipeline.addObject(0), 0);
+  BOOST_CHECK_EQUAL(pipeline.addObject(5), 1);
+  BOOST_CHECK_EQUAL(pipeline.addObject(0), 2);
+  pipeline.setEndBlockId(2, 0);
+
+  uint64_t nSegments = 0;
+  BOOST_CHECK(!pipeline.getSegmentCount(nSegments));
+
+  // new segments are taken from the objects in turn, skipping finished objects
+  static const size_t expectedObjects[] = { 0, 1, 2, 0, 1, 0 };
+  static const SegmentNo expectedSegments[] = { 0, 5, 0, 1, 6, 2 };
+  size_t object = 0;
+  SegmentNo segment = 0;
+  for (size_t i = 0; i < 6; ++i) {
+    BOOST_REQUIRE(pipeline.getNextSegment(object, segment));
+    BOOST_CHECK_EQUAL(object, expectedObjects[i]);
+    BOOST_CHECK_EQUAL(segment, expectedSegments[i]);
+    pipeline.onSent(object, segment, static_cast<uint32_t>(i), now);
+  }
+  // the window is shared by all objects
+  BOOST_CHECK(!pipeline.getNextSegment(object, segment));
+  BOOST_CHECK_EQUAL(pipeline.getInFlight(), 6);
+
+  // same segment number of another object is a different segment
+  BOOST_CHECK(pipeline.onData(2, 0, 2, now));
+  BOOST_CHECK(!pipeline.onData(2, 0, 2, now));
+  BOOST_CHECK(pipeline.isComplete(2));
+  BOOST_CHECK(!pipeline.isComplete(0));
+
+  pipeline.setEndBlockId(0, 1);
+  pipeline.setEndBlockId(1, 6);
+  BOOST_CHECK(pipeline.getSegmentCount(nSegments));
+  BOOST_CHECK_EQUAL(nSegments, 5);
+  // segment 2 of object 0 lies beyond its end, and is no longer in flight
+  BOOST_CHECK_EQUAL(pipeline.getInFlight(), 4);
+
+  BOOST_CHECK(pipeline.onData(0, 0, 0, now));
+  BOOST_CHECK(pipeline.onData(0, 1, 3, now));
+  BOOST_CHECK(pipeline.onData(1, 5, 1, now));
+  BOOST_CHECK(!pipeline.isComplete());
+  BOOST_CHECK(pipeline.onData(1, 6, 4, now));
+  BOOST_CHECK(pipeline.isComplete());
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutBackoffOncePerEvent)
+{
+  typedef repo::FetchPipeline::TimePoint TimePoint;
+  TimePoint now;
+
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(8.0, 1.0, 64.0),
+                               repo::RttEstimator(ndn::time::milliseconds(1000)), 10);
+  pipeline.setEndBlockId(99);
+
+  SegmentNo segment = 0;
+  uint32_t nonce = 0;
+  for (SegmentNo i = 0; i < 8; ++i) {
+    BOOST_REQUIRE(pipeline.getNextSegment(segment));
+    pipeline.onSent(segment, nonce++, now);
+  }
+
+  // the whole window times out: one timeout event
+  for (SegmentNo i = 0; i < 8; ++i) {
+    BOOST_CHECK_EQUAL(pipeline.onTimeout(i, i), repo::FetchPipeline::TIMEOUT_RETRY);
+  }
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(2000));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 4);
+  BOOST_CHECK_EQUAL(pipeline.getInFlight(), 0);
+
+  // lost segments are retransmitted first, within the reduced window
+  for (SegmentNo i = 0; i < 4; ++i) {
+    BOOST_REQUIRE(pipeline.getNextSegment(segment));
+    BOOST_CHECK_EQUAL(segment, i);
+    pipeline.onSent(segment, nonce++, now);
+  }
+  BOOST_CHECK(!pipeline.getNextSegment(segment));
+
+  // retransmissions timing out again are a new event, but only once
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(0, 8), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(4000));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 2);
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(1, 9), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(2, 10), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(4000));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 2);
+  BOOST_CHECK_EQUAL(pipeline.getInFlight(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(KarnRtoAfterBackoff)
+{
+  typedef repo::FetchPipeline::TimePoint TimePoint;
+  TimePoint now;
+
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(2.0, 1.0, 64.0),
+                               repo::RttEstimator(ndn::time::milliseconds(1000)), 10);
+  pipeline.setEndBlockId(99);
+
+  SegmentNo segment = 0;
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  pipeline.onSent(segment, 0, now);
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(0, 0), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(2000));
+
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  BOOST_CHECK_EQUAL(segment, 0);
+  pipeline.onSent(segment, 1, now);
+
+  // Data of a retransmitted segment is no RTT sample, so the backed off RTO is kept
+  now += ndn::time::milliseconds(100);
+  BOOST_CHECK(pipeline.onData(0, 1, now));
+  BOOST_CHECK(!pipeline.getRttEstimator().hasSamples());
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(2000));
+
+  // the first segment sent once gives a sample, which replaces the backed off RTO
+  BOOST_REQUIRE(pipeline.getNextSegment(segment));
+  BOOST_CHECK_EQUAL(segment, 1);
+  pipeline.onSent(segment, 2, now);
+  now += ndn::time::milliseconds(100);
+  BOOST_CHECK(pipeline.onData(1, 2, now));
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(300));
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutAfterFastRetransmit)
+{
+  typedef repo::FetchPipeline::TimePoint TimePoint;
+  TimePoint now;
+
+  repo::FetchPipeline pipeline(0, repo::CongestionWindow(8.0, 1.0, 64.0),
+                               repo::RttEstimator(ndn::time::milliseconds(1000)), 10);
+  pipeline.setEndBlockId(99);
+
+  SegmentNo segment = 0;
+  for (SegmentNo i = 0; i < 8; ++i) {
+    BOOST_REQUIRE(pipeline.getNextSegment(segment));
+    pipeline.onSent(segment, static_cast<uint32_t>(segment), now);
+  }
+
+  // segments 0 and 4 are lost; Data of 1, 2 and 3 trigger fast retransmit of 0
+  now += ndn::time::milliseconds(100);
+  BOOST_CHECK(pipeline.onData(1, 1, now));
+  BOOST_CHECK(pipeline.onData(2, 2, now));
+  BOOST_CHECK(pipeline.onData(3, 3, now));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 5);
+  // three samples of 100ms: SRTT 100ms, RTTVAR 28.125ms
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(213));
+
+  // segment 4 was sent in the same window, so its timeout backs off RTO
+  // without cutting the window a second time
+  BOOST_CHECK_EQUAL(pipeline.onTimeout(4, 4), repo::FetchPipeline::TIMEOUT_RETRY);
+  BOOST_CHECK_EQUAL(pipeline.getInterestLifetime(), ndn::time::milliseconds(425));
+  BOOST_CHECK_EQUAL(pipeline.getWindow().getSize(), 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -301,6 +301,50 @@ BOOST_AUTO_TEST_CASE(DigestExclude)
   BOOST_CHECK_EQUAL(find(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(PublisherPublicKeyLocator)
+{
+  Name n1 = insert(1, "ndn:/A/1");
+
+  // DigestSha256 signed Data have no KeyLocator and never match
+  startInterest("ndn:/A")
+    .setPublisherPublicKeyLocator(KeyLocator("ndn:/KEY"));
+  BOOST_CHECK_EQUAL(find(), 0);
+
+  startInterest("ndn:/A");
+  BOOST_CHECK_EQUAL(find(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(BatchMixedChildSelectors)
+{
+  insert(1, "ndn:/A");
+  insert(2, "ndn:/B/p/1");
+  insert(3, "ndn:/B/p/2");
+  insert(4, "ndn:/B/q/1");
+  insert(5, "ndn:/B/q/2");
+  insert(6, "ndn:/C");
+  // more entries under /D than a batched lookup steps over
+  for (int i = 0; i < 40; ++i)
+    insert(10 + i, Name("ndn:/D").appendNumber(i));
+
+  std::vector<Interest> interests;
+  interests.push_back(Interest("ndn:/D").setChildSelector(1));
+  interests.push_back(Interest("ndn:/B").setChildSelector(0));
+  interests.push_back(Interest("ndn:/E").setChildSelector(1));
+  interests.push_back(Interest("ndn:/B").setChildSelector(1));
+  interests.push_back(Interest("ndn:/A").setChildSelector(1));
+  interests.push_back(Interest("ndn:/D").setChildSelector(0));
+  interests.push_back(Interest("ndn:/C").setChildSelector(0));
+  interests.push_back(Interest("ndn:/B/q").setChildSelector(1));
+
+  static const int64_t expected[] = {49, 2, 0, 4, 1, 10, 6, 5};
+  std::vector<std::pair<int64_t, Name> > found = m_index.find(interests);
+  BOOST_REQUIRE_EQUAL(found.size(), interests.size());
+  for (size_t i = 0; i < interests.size(); ++i) {
+    BOOST_CHECK_EQUAL(found[i].first, expected[i]);
+    BOOST_CHECK_EQUAL(found[i].first, m_index.find(interests[i]).first);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // Find
 
 
@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/keylocator-hash-cache.hpp"
+
+#include <ndn-cxx/util/crypto.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(KeyLocatorHashCache)
+
+BOOST_AUTO_TEST_CASE(Memoize)
+{
+  repo::KeyLocatorHashCache cache(2);
+  KeyLocator a(Name("/A/KEY"));
+  KeyLocator b(Name("/B/KEY"));
+  KeyLocator c(Name("/C/KEY"));
+
+  ndn::ConstBufferPtr hashA = cache.get(a);
+  const Block& wire = a.wireEncode();
+  ndn::ConstBufferPtr expected = ndn::crypto::sha256(wire.wire(), wire.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(hashA->begin(), hashA->end(), expected->begin(), expected->end());
+
+  // an equal KeyLocator gets the same digest buffer
+  BOOST_CHECK_EQUAL(cache.get(KeyLocator(Name("/A/KEY"))), hashA);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 1);
+
+  ndn::ConstBufferPtr hashB = cache.get(b);
+  BOOST_CHECK(*hashB != *hashA);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  // a full cache starts over
+  cache.get(c);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK(cache.get(a) != hashA);
+  BOOST_CHECK(*cache.get(a) == *hashA);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
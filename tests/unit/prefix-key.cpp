@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/prefix-key.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(PrefixKey)
+
+static bool
+isKeyLess(const ndn::Buffer& a, const ndn::Buffer& b)
+{
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+static bool
+isKeyPrefix(const ndn::Buffer& prefix, const ndn::Buffer& key)
+{
+  return prefix.size() <= key.size() &&
+         std::equal(prefix.begin(), prefix.end(), key.begin());
+}
+
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+  Name name("/a/bb/%00%01");
+  name.appendSegment(42);
+
+  ndn::Buffer key = encodePrefixKey(name);
+  BOOST_CHECK_EQUAL(decodePrefixKey(key.buf(), key.size()), name);
+
+  ndn::Buffer rootKey = encodePrefixKey(Name());
+  BOOST_CHECK_EQUAL(rootKey.size(), 0);
+  BOOST_CHECK_EQUAL(decodePrefixKey(rootKey.buf(), rootKey.size()), Name());
+
+  BOOST_CHECK_THROW(decodePrefixKey(key.buf(), key.size() - 1), ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Order)
+{
+  std::vector<Name> names;
+  names.push_back(Name("/a"));
+  names.push_back(Name("/a/b"));
+  names.push_back(Name("/a/b/c"));
+  names.push_back(Name("/a/c"));
+  names.push_back(Name("/a/aa"));
+  names.push_back(Name("/b"));
+  names.push_back(Name("/aa"));
+  std::sort(names.begin(), names.end());
+
+  for (size_t i = 1; i < names.size(); ++i) {
+    BOOST_CHECK(isKeyLess(encodePrefixKey(names[i - 1]), encodePrefixKey(names[i])));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PrefixRange)
+{
+  Name prefix("/a/b");
+  ndn::Buffer lower = encodePrefixKey(prefix);
+  ndn::Buffer upper = getPrefixKeySuccessor(lower);
+
+  Name inside[] = {Name("/a/b"), Name("/a/b/c"), Name("/a/b/%FF%FF")};
+  Name outside[] = {Name("/a"), Name("/a/bb"), Name("/a/c"), Name("/a/ba/c")};
+
+  for (size_t i = 0; i < sizeof(inside) / sizeof(inside[0]); ++i) {
+    ndn::Buffer key = encodePrefixKey(inside[i]);
+    BOOST_CHECK(isKeyPrefix(lower, key));
+    BOOST_CHECK(!isKeyLess(key, lower));
+    BOOST_CHECK(isKeyLess(key, upper));
+  }
+
+  for (size_t i = 0; i < sizeof(outside) / sizeof(outside[0]); ++i) {
+    ndn::Buffer key = encodePrefixKey(outside[i]);
+    BOOST_CHECK(!isKeyPrefix(lower, key));
+    BOOST_CHECK(isKeyLess(key, lower) || !isKeyLess(key, upper));
+  }
+
+  BOOST_CHECK(getPrefixKeySuccessor(encodePrefixKey(Name())).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
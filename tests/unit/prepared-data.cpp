@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/prepared-data.hpp"
+#include "storage/index.hpp"
+
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(PreparedData)
+
+BOOST_FIXTURE_TEST_CASE(Fields, BasicDataset)
+{
+  for (DataContainer::iterator i = this->data.begin(); i != this->data.end(); ++i) {
+    // as received, without a cached full name
+    Data data((*i)->wireEncode());
+    repo::PreparedData prepared(data);
+
+    const Block& wire = (*i)->wireEncode();
+    BOOST_CHECK_EQUAL_COLLECTIONS(prepared.wire.begin(), prepared.wire.end(),
+                                  wire.begin(), wire.end());
+    BOOST_CHECK_EQUAL(prepared.fullName, (*i)->getFullName());
+    const Block& fullNameWire = (*i)->getFullName().wireEncode();
+    BOOST_CHECK_EQUAL_COLLECTIONS(prepared.fullNameWire.begin(), prepared.fullNameWire.end(),
+                                  fullNameWire.begin(), fullNameWire.end());
+    BOOST_REQUIRE(static_cast<bool>(prepared.keyLocatorHash));
+    BOOST_CHECK(*prepared.keyLocatorHash == *repo::Index::computeKeyLocatorHash(**i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NoKeyLocator)
+{
+  Data data("/digest/signed");
+  ndn::KeyChain keyChain;
+  keyChain.signWithSha256(data);
+
+  repo::PreparedData prepared(data);
+  BOOST_CHECK_EQUAL(prepared.fullName, data.getFullName());
+  BOOST_CHECK(!static_cast<bool>(prepared.keyLocatorHash));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/read-cache.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(ReadCache)
+
+static shared_ptr<Data>
+makeData(const Name& dataName)
+{
+  static ndn::KeyChain keyChain;
+  static std::vector<uint8_t> content(1000, 0x55);
+
+  shared_ptr<Data> data = make_shared<Data>(dataName);
+  data->setContent(content.data(), content.size());
+  keyChain.signWithSha256(*data);
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(LeastRecentlyUsed)
+{
+  shared_ptr<Data> a = makeData("/a");
+  shared_ptr<Data> b = makeData("/b");
+  shared_ptr<Data> c = makeData("/c");
+
+  // room for two of them
+  repo::ReadCache cache(a->wireEncode().size() * 2 + 100);
+  cache.insert(1, a);
+  cache.insert(2, b);
+  BOOST_CHECK_EQUAL(cache.size(), a->wireEncode().size() + b->wireEncode().size());
+
+  BOOST_CHECK_EQUAL(cache.find(1), a);
+  cache.insert(3, c);
+  BOOST_CHECK(cache.contains(1));
+  BOOST_CHECK(!cache.contains(2));
+  BOOST_CHECK(cache.contains(3));
+  BOOST_CHECK(!static_cast<bool>(cache.find(2)));
+
+  cache.erase(1);
+  BOOST_CHECK(!cache.contains(1));
+  BOOST_CHECK_EQUAL(cache.size(), c->wireEncode().size());
+
+  BOOST_CHECK_EQUAL(cache.getCounters().nHits, 1);
+  BOOST_CHECK_EQUAL(cache.getCounters().nMisses, 1);
+  BOOST_CHECK_EQUAL(cache.getCounters().nInsertions, 3);
+  BOOST_CHECK_EQUAL(cache.getCounters().nEvictions, 1);
+}
+
+BOOST_AUTO_TEST_CASE(Disabled)
+{
+  repo::ReadCache cache(0);
+  cache.insert(1, makeData("/a"));
+  BOOST_CHECK(!cache.contains(1));
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
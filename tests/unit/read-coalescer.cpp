@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/read-coalescer.hpp"
+#include "storage/sqlite-storage.hpp"
+#include "../repo-storage-fixture.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+class ReadCoalescerFixture : public RepoStorageFixture
+{
+public:
+  ReadCoalescerFixture()
+    : cachingHandle(static_cast<int64_t>(65535), *store, 1048576)
+    , coalescer(ioService, cachingHandle, 2)
+    , inlineCoalescer(ioService, *handle)
+    , data(make_shared<Data>("/coalesced/object"))
+  {
+    ndn::KeyChain keyChain;
+    keyChain.signWithSha256(*data);
+    cachingHandle.insertData(*data);
+  }
+
+  void
+  onRead(const shared_ptr<Data>& data)
+  {
+    results.push_back(data);
+  }
+
+  /**
+   * @brief run the main loop until @p nResults reads have completed
+   */
+  void
+  waitForResults(size_t nResults)
+  {
+    while (results.size() < nResults) {
+      ioService.run_one();
+      ioService.reset();
+    }
+  }
+
+public:
+  boost::asio::io_service ioService;
+  repo::RepoStorage cachingHandle;
+  repo::ReadCoalescer coalescer;
+  repo::ReadCoalescer inlineCoalescer;
+  shared_ptr<Data> data;
+  std::vector<shared_ptr<Data> > results;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ReadCoalescer, ReadCoalescerFixture)
+
+BOOST_AUTO_TEST_CASE(SameRecord)
+{
+  for (int i = 0; i < 3; ++i)
+    coalescer.read(Interest("/coalesced"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  BOOST_CHECK_EQUAL(coalescer.getNInFlight(), 1);
+  BOOST_CHECK_EQUAL(coalescer.getNStorageReads(), 1);
+  BOOST_CHECK_EQUAL(coalescer.getNCoalesced(), 2);
+
+  waitForResults(3);
+  BOOST_CHECK_EQUAL(coalescer.getNInFlight(), 0);
+  BOOST_REQUIRE(static_cast<bool>(results[0]));
+  BOOST_CHECK_EQUAL(*results[0], *data);
+  BOOST_CHECK_EQUAL(results[1], results[0]);
+  BOOST_CHECK_EQUAL(results[2], results[0]);
+
+  // answered from the read cache right away
+  coalescer.read(Interest("/coalesced/object"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  BOOST_REQUIRE_EQUAL(results.size(), 4);
+  BOOST_CHECK_EQUAL(results[3], results[0]);
+  BOOST_CHECK_EQUAL(coalescer.getNStorageReads(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(NoData)
+{
+  coalescer.read(Interest("/no/such/data"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  BOOST_REQUIRE_EQUAL(results.size(), 1);
+  BOOST_CHECK(!static_cast<bool>(results[0]));
+  BOOST_CHECK_EQUAL(coalescer.getNStorageReads(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Inline)
+{
+  inlineCoalescer.read(Interest("/coalesced"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  inlineCoalescer.read(Interest("/coalesced"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  BOOST_REQUIRE_EQUAL(results.size(), 2);
+  BOOST_CHECK_EQUAL(*results[0], *data);
+  BOOST_CHECK_EQUAL(*results[1], *data);
+  BOOST_CHECK_EQUAL(inlineCoalescer.getNStorageReads(), 2);
+  BOOST_CHECK_EQUAL(inlineCoalescer.getNCoalesced(), 0);
+}
+
+/**
+ * @brief a storage that can only be read through itself
+ */
+class SharedConnectionStorage : public SqliteStorage
+{
+public:
+  SharedConnectionStorage()
+    : SqliteStorage("unittestdb")
+  {
+  }
+
+  virtual shared_ptr<Storage::Reader>
+  openReader()
+  {
+    return shared_ptr<Storage::Reader>();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(NoReaders)
+{
+  SharedConnectionStorage storage;
+  repo::RepoStorage storageHandle(static_cast<int64_t>(65535), storage);
+  storageHandle.initialize();
+
+  // workers are not started, the record is read on the main loop
+  repo::ReadCoalescer readingCoalescer(ioService, storageHandle, 2);
+  readingCoalescer.read(Interest("/coalesced"), bind(&ReadCoalescerFixture::onRead, this, _1));
+  BOOST_REQUIRE_EQUAL(results.size(), 1);
+  BOOST_CHECK_EQUAL(*results[0], *data);
+  BOOST_CHECK_EQUAL(readingCoalescer.getNInFlight(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -67,6 +67,93 @@ BOOST_AUTO_TEST_CASE(EncodeDecode)
                     parameter.getSelectors().getMaxSuffixComponents());
 }
 
+BOOST_AUTO_TEST_CASE(MaxPageNum)
+{
+  repo::RepoCommandParameter parameter;
+  BOOST_CHECK(!parameter.hasMaxPageNum());
+  parameter.setMaxPageNum(256);
+
+  ndn::Block wire = parameter.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xc9, 0x04, 0xd5, 0x02, 0x01, 0x00
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoCommandParameter decoded(wire);
+  BOOST_CHECK(decoded.hasMaxPageNum());
+  BOOST_CHECK_EQUAL(decoded.getMaxPageNum(), 256);
+  BOOST_CHECK(!decoded.hasName());
+}
+
+BOOST_AUTO_TEST_CASE(ObjectNames)
+{
+  repo::RepoCommandParameter parameter;
+  BOOST_CHECK(!parameter.hasObjectNames());
+  parameter.addObjectName("/a");
+  parameter.addObjectName("/b/c");
+
+  ndn::Block wire = parameter.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xc9, 0x0f, 0xd7, 0x0d, 0x07, 0x03, 0x08, 0x01, 0x61, 0x07, 0x06, 0x08,
+    0x01, 0x62, 0x08, 0x01, 0x63
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoCommandParameter decoded(wire);
+  BOOST_REQUIRE_EQUAL(decoded.getObjectNames().size(), 2);
+  BOOST_CHECK_EQUAL(decoded.getObjectNames()[0], Name("/a"));
+  BOOST_CHECK_EQUAL(decoded.getObjectNames()[1], Name("/b/c"));
+  BOOST_CHECK(!decoded.hasName());
+}
+
+BOOST_AUTO_TEST_CASE(ManifestName)
+{
+  repo::RepoCommandParameter parameter;
+  BOOST_CHECK(!parameter.hasManifestName());
+  parameter.setManifestName("/m");
+
+  ndn::Block wire = parameter.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xc9, 0x07, 0xd8, 0x05, 0x07, 0x03, 0x08, 0x01, 0x6d
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoCommandParameter decoded(wire);
+  BOOST_CHECK(decoded.hasManifestName());
+  BOOST_CHECK_EQUAL(decoded.getManifestName(), Name("/m"));
+  BOOST_CHECK(!decoded.hasName());
+}
+
+BOOST_AUTO_TEST_CASE(WatchWindow)
+{
+  repo::RepoCommandParameter parameter;
+  BOOST_CHECK(!parameter.hasWatchWindow());
+  parameter.setWatchWindow(8);
+
+  ndn::Block wire = parameter.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xc9, 0x03, 0xda, 0x01, 0x08
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoCommandParameter decoded(wire);
+  BOOST_CHECK(decoded.hasWatchWindow());
+  BOOST_CHECK_EQUAL(decoded.getWatchWindow(), 8);
+  BOOST_CHECK(!decoded.hasName());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -61,6 +61,28 @@ BOOST_AUTO_TEST_CASE(EncodeDecode)
   BOOST_CHECK_EQUAL(decoded.getProcessId(), response.getProcessId());
   BOOST_CHECK_EQUAL(decoded.getInsertNum(), response.getInsertNum());
   BOOST_CHECK_EQUAL(decoded.getDeleteNum(), response.getDeleteNum());
+  BOOST_CHECK(!decoded.hasFreedBytes());
+}
+
+BOOST_AUTO_TEST_CASE(FreedBytes)
+{
+  repo::RepoCommandResponse response;
+  response.setStatusCode(200);
+  response.setFreedBytes(8192);
+
+  ndn::Block wire = response.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xcf, 0x07, 0xd0, 0x01, 0xc8, 0xd6, 0x02, 0x20, 0x00
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoCommandResponse decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.getStatusCode(), 200);
+  BOOST_CHECK(decoded.hasFreedBytes());
+  BOOST_CHECK_EQUAL(decoded.getFreedBytes(), 8192);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "repo-manifest.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(RepoManifest)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  uint8_t digest[32];
+  std::fill_n(digest, sizeof(digest), 0xaa);
+  Name entry("/a");
+  entry.append(ndn::name::Component::fromImplicitSha256Digest(digest, sizeof(digest)));
+
+  repo::RepoManifest manifest;
+  manifest.addEntry(entry);
+
+  ndn::Block wire = manifest.wireEncode();
+
+  static const uint8_t expected[] = {
+    0xd9, 0x27, 0x07, 0x25, 0x08, 0x01, 0x61, 0x01, 0x20,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa
+  };
+
+  BOOST_REQUIRE_EQUAL_COLLECTIONS(expected, expected + sizeof(expected),
+                                  wire.begin(), wire.end());
+
+  repo::RepoManifest decoded(wire);
+  BOOST_REQUIRE_EQUAL(decoded.getEntries().size(), 1);
+  BOOST_CHECK_EQUAL(decoded.getEntries()[0], entry);
+}
+
+BOOST_AUTO_TEST_CASE(EntryWithoutDigest)
+{
+  repo::RepoManifest manifest;
+  BOOST_CHECK_THROW(manifest.addEntry("/a/b"), repo::RepoManifest::Error);
+
+  // Manifest containing Name /a
+  static const uint8_t wire[] = {
+    0xd9, 0x05, 0x07, 0x03, 0x08, 0x01, 0x61
+  };
+  BOOST_CHECK_THROW(manifest.wireDecode(ndn::Block(wire, sizeof(wire))),
+                    repo::RepoManifest::Error);
+
+  // empty Manifest
+  static const uint8_t emptyWire[] = {
+    0xd9, 0x00
+  };
+  BOOST_CHECK_THROW(manifest.wireDecode(ndn::Block(emptyWire, sizeof(emptyWire))),
+                    repo::RepoManifest::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
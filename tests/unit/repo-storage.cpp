@@ -73,6 +73,83 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(Bulk, T, Datasets, Fixture<T>)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(ReadBatch, T, Datasets, Fixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  for (typename T::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    {
+      BOOST_CHECK_EQUAL(this->handle->insertData(**i), true);
+    }
+
+  // Interests in reverse order, one of them twice, and one without matching Data
+  std::vector<Interest> interests;
+  for (typename T::InterestContainer::reverse_iterator i = this->interests.rbegin();
+       i != this->interests.rend(); ++i)
+    interests.push_back(i->first);
+  interests.push_back(this->interests.begin()->first);
+  interests.push_back(Interest("/no/such/data"));
+
+  std::vector<shared_ptr<Data> > results = this->handle->readDataBatch(interests);
+  BOOST_REQUIRE_EQUAL(results.size(), interests.size());
+  for (size_t i = 0; i + 1 < interests.size(); ++i) {
+    BOOST_REQUIRE(static_cast<bool>(results[i]));
+    BOOST_CHECK_EQUAL(*results[i], *this->handle->readData(interests[i]));
+  }
+  BOOST_CHECK(!static_cast<bool>(results.back()));
+}
+
+BOOST_FIXTURE_TEST_CASE(InsertBatch, Fixture<SamePrefixDataset<10> >)
+{
+  DatasetBase::DataContainer::iterator middle = this->data.begin();
+  std::advance(middle, 5);
+  std::vector<shared_ptr<const Data> > batch(this->data.begin(), middle);
+
+  BOOST_CHECK_EQUAL(this->handle->insertDataBatch(batch), 5);
+  BOOST_CHECK_EQUAL(this->store->size(), 5);
+
+  // already stored and repeated Data are skipped
+  batch.assign(this->data.begin(), this->data.end());
+  batch.push_back(this->data.back());
+  std::vector<repo::RepoStorage::InsertResult> results;
+  BOOST_CHECK_EQUAL(this->handle->insertDataBatch(batch, results), 5);
+  BOOST_CHECK_EQUAL(this->store->size(), 10);
+  BOOST_REQUIRE_EQUAL(results.size(), 11);
+  for (size_t i = 0; i < results.size(); ++i) {
+    BOOST_CHECK_EQUAL(results[i], i >= 5 && i < 10 ? repo::RepoStorage::INSERT_OK :
+                                                     repo::RepoStorage::INSERT_DUPLICATE);
+  }
+
+  for (DatasetBase::InterestContainer::iterator i = this->interests.begin();
+       i != this->interests.end(); ++i) {
+    BOOST_CHECK_EQUAL(*this->handle->readData(i->first), *i->second);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(InsertBatchFull, Fixture<SamePrefixDataset<10> >)
+{
+  repo::RepoStorage smallRepo(static_cast<int64_t>(6), *this->store);
+  BOOST_CHECK(smallRepo.insertData(*this->data.front()));
+
+  // the Data beyond the capacity of the index are not written to the database
+  std::vector<shared_ptr<const Data> > batch(this->data.begin(), this->data.end());
+  std::vector<repo::RepoStorage::InsertResult> results;
+  BOOST_CHECK_EQUAL(smallRepo.insertDataBatch(batch, results), 5);
+  BOOST_CHECK_EQUAL(this->store->size(), 6);
+  BOOST_REQUIRE_EQUAL(results.size(), 10);
+  BOOST_CHECK_EQUAL(results[0], repo::RepoStorage::INSERT_DUPLICATE);
+  for (size_t i = 1; i < results.size(); ++i) {
+    BOOST_CHECK_EQUAL(results[i], i < 6 ? repo::RepoStorage::INSERT_OK :
+                                          repo::RepoStorage::INSERT_FULL);
+  }
+
+  std::vector<shared_ptr<const Data> > rest(1, this->data.back());
+  BOOST_CHECK_EQUAL(smallRepo.insertDataBatch(rest, results), 0);
+  BOOST_CHECK_EQUAL(results[0], repo::RepoStorage::INSERT_FULL);
+  BOOST_CHECK_EQUAL(this->store->size(), 6);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/response-signer.hpp"
+
+#include <ndn-cxx/security/digest-sha256.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(ResponseSigner)
+
+class Fixture
+{
+public:
+  Fixture()
+    : signer(io, keyChain)
+    , data(make_shared<Data>("/repo/command/insert/check"))
+    , nSigned(0)
+  {
+    static const uint8_t content[4] = {3, 1, 4, 1};
+    data->setContent(content, sizeof(content));
+  }
+
+  void
+  onSigned(const shared_ptr<Data>& signedData)
+  {
+    BOOST_CHECK_EQUAL(signedData, data);
+    ++nSigned;
+  }
+
+public:
+  boost::asio::io_service io;
+  KeyChain keyChain;
+  repo::ResponseSigner signer;
+  shared_ptr<Data> data;
+  size_t nSigned;
+};
+
+BOOST_AUTO_TEST_CASE(ParsePolicy)
+{
+  BOOST_CHECK_EQUAL(repo::ResponseSigner::parsePolicy("identity"),
+                    repo::ResponseSigner::POLICY_IDENTITY);
+  BOOST_CHECK_EQUAL(repo::ResponseSigner::parsePolicy("digest"),
+                    repo::ResponseSigner::POLICY_DIGEST_SHA256);
+  BOOST_CHECK_EQUAL(repo::ResponseSigner::parsePolicy("hmac"),
+                    repo::ResponseSigner::POLICY_HMAC_SHA256);
+  BOOST_CHECK_EQUAL(repo::ResponseSigner::parsePolicy("ecdsa"),
+                    repo::ResponseSigner::POLICY_ECDSA);
+  BOOST_CHECK_THROW(repo::ResponseSigner::parsePolicy("rsa"), repo::ResponseSigner::Error);
+}
+
+BOOST_FIXTURE_TEST_CASE(Digest, Fixture)
+{
+  signer.setPolicy(repo::ResponseSigner::POLICY_DIGEST_SHA256);
+  signer.signAsync(data, bind(&Fixture::onSigned, this, _1));
+  io.run();
+  BOOST_CHECK_EQUAL(nSigned, 1);
+
+  Data decoded(data->wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getSignature().getType(), ndn::tlv::DigestSha256);
+  BOOST_CHECK(ndn::Validator::verifySignature(decoded, ndn::DigestSha256(decoded.getSignature())));
+}
+
+BOOST_FIXTURE_TEST_CASE(Hmac, Fixture)
+{
+  BOOST_CHECK_THROW(signer.setPolicy(repo::ResponseSigner::POLICY_HMAC_SHA256),
+                    repo::ResponseSigner::Error);
+
+  static const uint8_t key[16] = {0};
+  signer.setHmacKey("/repo/KEY/hmac", make_shared<ndn::Buffer>(key, sizeof(key)));
+  signer.setPolicy(repo::ResponseSigner::POLICY_HMAC_SHA256);
+  signer.sign(*data);
+
+  Data decoded(data->wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getSignature().getType(),
+                    repo::ResponseSigner::SIGNATURE_TYPE_HMAC_SHA256);
+  BOOST_CHECK_EQUAL(decoded.getSignature().getKeyLocator().getName(), Name("/repo/KEY/hmac"));
+  // HMAC-SHA256 is as long as SHA256
+  BOOST_CHECK_EQUAL(decoded.getSignature().getValue().value_size(), 32);
+
+  // a different key gives a different signature
+  static const uint8_t otherKey[16] = {1};
+  Data other(*data);
+  signer.setHmacKey("/repo/KEY/hmac", make_shared<ndn::Buffer>(otherKey, sizeof(otherKey)));
+  signer.sign(other);
+  BOOST_CHECK(other.getSignature().getValue() != decoded.getSignature().getValue());
+}
+
+BOOST_FIXTURE_TEST_CASE(HmacKnownAnswer, Fixture)
+{
+  // Name, empty MetaInfo, Content and SignatureInfo of the fixture Data
+  static const uint8_t SIGNED_PORTION[] = {
+    0x07, 0x1e, 0x08, 0x04, 0x72, 0x65, 0x70, 0x6f, 0x08, 0x07, 0x63, 0x6f, 0x6d, 0x6d,
+    0x61, 0x6e, 0x64, 0x08, 0x06, 0x69, 0x6e, 0x73, 0x65, 0x72, 0x74, 0x08, 0x05, 0x63,
+    0x68, 0x65, 0x63, 0x6b, 0x14, 0x00, 0x15, 0x04, 0x03, 0x01, 0x04, 0x01, 0x16, 0x18,
+    0x1b, 0x01, 0x04, 0x1c, 0x13, 0x07, 0x11, 0x08, 0x04, 0x72, 0x65, 0x70, 0x6f, 0x08,
+    0x03, 0x4b, 0x45, 0x59, 0x08, 0x04, 0x68, 0x6d, 0x61, 0x63
+  };
+  // HMAC-SHA256 of SIGNED_PORTION with the key of RFC 4231 test case 2
+  static const uint8_t MAC[] = {
+    0x4f, 0x5b, 0xb2, 0xa8, 0x84, 0xfc, 0xc3, 0x64, 0xe2, 0xbd, 0xdf, 0xd1, 0x68, 0x40,
+    0xa9, 0xa9, 0x57, 0x31, 0x42, 0x19, 0x78, 0x9c, 0x07, 0x5c, 0xe2, 0xc1, 0x84, 0x0b,
+    0x58, 0x75, 0xaf, 0x43
+  };
+
+  static const uint8_t key[] = { 'J', 'e', 'f', 'e' };
+  signer.setHmacKey("/repo/KEY/hmac", make_shared<ndn::Buffer>(key, sizeof(key)));
+  signer.setPolicy(repo::ResponseSigner::POLICY_HMAC_SHA256);
+  signer.sign(*data);
+
+  Block wire = data->wireEncode();
+  wire.parse();
+  const Block& signatureValue = wire.get(ndn::tlv::SignatureValue);
+  BOOST_CHECK_EQUAL_COLLECTIONS(wire.value_begin(), signatureValue.begin(),
+                                SIGNED_PORTION, SIGNED_PORTION + sizeof(SIGNED_PORTION));
+  BOOST_CHECK_EQUAL_COLLECTIONS(signatureValue.value_begin(), signatureValue.value_end(),
+                                MAC, MAC + sizeof(MAC));
+}
+
+BOOST_FIXTURE_TEST_CASE(Ecdsa, Fixture)
+{
+  Name identity("/repo/test/response-signer/ecdsa");
+  identity.appendVersion();
+  signer.setPolicy(repo::ResponseSigner::POLICY_ECDSA, identity);
+  signer.sign(*data);
+
+  Data decoded(data->wireEncode());
+  BOOST_CHECK_EQUAL(decoded.getSignature().getType(), ndn::tlv::SignatureSha256WithEcdsa);
+  shared_ptr<ndn::IdentityCertificate> certificate =
+    keyChain.getCertificate(keyChain.getDefaultCertificateNameForIdentity(identity));
+  BOOST_CHECK_EQUAL(certificate->getPublicKeyInfo().getKeyType(), ndn::KEY_TYPE_ECDSA);
+  BOOST_CHECK(ndn::Validator::verifySignature(decoded, certificate->getPublicKeyInfo()));
+
+  keyChain.deleteIdentity(identity);
+}
+
+BOOST_FIXTURE_TEST_CASE(EcdsaRejectsRsaIdentity, Fixture)
+{
+  Name identity("/repo/test/response-signer/rsa");
+  identity.appendVersion();
+  keyChain.createIdentity(identity, ndn::RsaKeyParams());
+
+  // the identity exists, so its RSA default key would be used without the check
+  BOOST_CHECK_THROW(signer.setPolicy(repo::ResponseSigner::POLICY_ECDSA, identity),
+                    repo::ResponseSigner::Error);
+  BOOST_CHECK_EQUAL(signer.getPolicy(), repo::ResponseSigner::POLICY_IDENTITY);
+
+  keyChain.deleteIdentity(identity);
+}
+
+BOOST_FIXTURE_TEST_CASE(Identity, Fixture)
+{
+  signer.sign(*data);
+  shared_ptr<ndn::IdentityCertificate> certificate =
+    keyChain.getCertificate(keyChain.getDefaultCertificateName());
+  BOOST_CHECK(ndn::Validator::verifySignature(*data, certificate->getPublicKeyInfo()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
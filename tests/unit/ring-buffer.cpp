@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/ring-buffer.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(RingBuffer)
+
+BOOST_AUTO_TEST_CASE(Wraparound)
+{
+  repo::RingBuffer ring(8);
+  static const uint8_t first[] = {1, 2, 3, 4, 5, 6};
+  ring.write(first, sizeof(first));
+  ring.consume(4);
+  BOOST_CHECK_EQUAL(ring.size(), 2);
+  BOOST_CHECK_EQUAL(ring.getFreeSpace(), 6);
+
+  // free space runs from position 6 to the end, then from the start up to position 4
+  repo::RingBuffer::MutableBuffers buffers = ring.prepare();
+  BOOST_CHECK_EQUAL(boost::asio::buffer_size(buffers[0]), 2);
+  BOOST_CHECK_EQUAL(boost::asio::buffer_size(buffers[1]), 4);
+
+  static const uint8_t second[] = {7, 8, 9, 10, 11};
+  ring.write(second, sizeof(second));
+  BOOST_CHECK_EQUAL(ring.size(), 7);
+  BOOST_CHECK_EQUAL(ring.at(0), 5);
+  BOOST_CHECK_EQUAL(ring.at(6), 11);
+
+  uint8_t copied[7];
+  ring.copy(0, sizeof(copied), copied);
+  static const uint8_t expected[] = {5, 6, 7, 8, 9, 10, 11};
+  BOOST_CHECK_EQUAL_COLLECTIONS(copied, copied + sizeof(copied),
+                                expected, expected + sizeof(expected));
+
+  ring.consume(7);
+  BOOST_CHECK_EQUAL(ring.size(), 0);
+  buffers = ring.prepare();
+  BOOST_CHECK_EQUAL(boost::asio::buffer_size(buffers[0]), 8);
+  BOOST_CHECK_EQUAL(boost::asio::buffer_size(buffers[1]), 0);
+}
+
+BOOST_AUTO_TEST_CASE(VarNumberAcrossWraparound)
+{
+  repo::RingBuffer ring(6);
+  static const uint8_t padding[] = {0, 0, 0, 0};
+  ring.write(padding, sizeof(padding));
+  ring.consume(sizeof(padding));
+
+  // a 3-octet VarNumber 0x1234 whose last octet is stored at the start
+  static const uint8_t header[] = {0xfd, 0x12};
+  ring.write(header, sizeof(header));
+
+  size_t offset = 0;
+  uint64_t number = 0;
+  BOOST_CHECK(!ring.readVarNumber(offset, number));
+  BOOST_CHECK_EQUAL(offset, 0);
+
+  static const uint8_t rest[] = {0x34, 0x05};
+  ring.write(rest, sizeof(rest));
+  BOOST_REQUIRE(ring.readVarNumber(offset, number));
+  BOOST_CHECK_EQUAL(number, 0x1234);
+  BOOST_CHECK_EQUAL(offset, 3);
+  BOOST_REQUIRE(ring.readVarNumber(offset, number));
+  BOOST_CHECK_EQUAL(number, 5);
+  BOOST_CHECK_EQUAL(offset, 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/scrubber.hpp"
+#include "storage/sqlite-storage.hpp"
+
+#include "../repo-storage-fixture.hpp"
+#include "../dataset-fixtures.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <sqlite3.h>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(Scrubber)
+
+class Fixture : public SamePrefixDataset<100>, public RepoStorageFixture
+{
+public:
+  Fixture()
+    : scheduler(io)
+    , scrubber(*handle, scheduler)
+  {
+    for (DataContainer::iterator i = data.begin(); i != data.end(); ++i) {
+      BOOST_REQUIRE(handle->insertData(**i));
+    }
+  }
+
+  /**
+   * @brief flip one octet in the middle of the stored Data wire of a record
+   */
+  void
+  corrupt(int64_t id)
+  {
+    sqlite3* db = 0;
+    BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+
+    sqlite3_stmt* stmt = 0;
+    sqlite3_prepare_v2(db, "SELECT data FROM NDN_REPO WHERE id = ?;", -1, &stmt, 0);
+    sqlite3_bind_int64(stmt, 1, id);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_ROW);
+    ndn::Buffer wire(sqlite3_column_blob(stmt, 0), sqlite3_column_bytes(stmt, 0));
+    sqlite3_finalize(stmt);
+
+    wire[wire.size() / 2] ^= 0xFF;
+
+    sqlite3_prepare_v2(db, "UPDATE NDN_REPO SET data = ? WHERE id = ?;", -1, &stmt, 0);
+    sqlite3_bind_blob(stmt, 1, wire.buf(), wire.size(), 0);
+    sqlite3_bind_int64(stmt, 2, id);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_DONE);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+  }
+
+  /**
+   * @brief overwrite the stored name of a record with octets that are not a Name TLV
+   */
+  void
+  corruptName(int64_t id)
+  {
+    sqlite3* db = 0;
+    BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+
+    static const uint8_t GARBAGE[] = { 0xFF, 0xFF, 0xFF };
+    sqlite3_stmt* stmt = 0;
+    sqlite3_prepare_v2(db, "UPDATE NDN_REPO SET name = ? WHERE id = ?;", -1, &stmt, 0);
+    sqlite3_bind_blob(stmt, 1, GARBAGE, sizeof(GARBAGE), 0);
+    sqlite3_bind_int64(stmt, 2, id);
+    BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_DONE);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+  }
+
+public:
+  boost::asio::io_service io;
+  ndn::Scheduler scheduler;
+  repo::Scrubber scrubber;
+};
+
+BOOST_FIXTURE_TEST_CASE(CleanPass, Fixture)
+{
+  // the budget is met after a few records, not after the whole storage
+  scrubber.step(1);
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nItems, 1);
+  BOOST_CHECK_GT(scrubber.getPosition(), 0);
+
+  while (scrubber.getCounters().nPasses == 0) {
+    scrubber.step(10000);
+  }
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nItems, data.size());
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nCorruptedItems, 0);
+  BOOST_CHECK_EQUAL(scrubber.getPosition(), 0);
+  BOOST_CHECK_EQUAL(store->size(), data.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(Quarantine, Fixture)
+{
+  shared_ptr<Data> victim = data.front();
+  corrupt(1);
+
+  while (scrubber.getCounters().nPasses == 0) {
+    scrubber.step(10000);
+  }
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nItems, data.size());
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nCorruptedItems, 1);
+  BOOST_CHECK_EQUAL(store->size(), data.size() - 1);
+
+  // the damaged Data is no longer served, the others still are
+  BOOST_CHECK(!handle->readData(Interest(victim->getFullName())));
+  BOOST_CHECK(static_cast<bool>(handle->readData(Interest(data.back()->getFullName()))));
+}
+
+BOOST_FIXTURE_TEST_CASE(QuarantineMalformedName, Fixture)
+{
+  shared_ptr<Data> victim = data.front();
+  corruptName(1);
+
+  while (scrubber.getCounters().nPasses == 0) {
+    scrubber.step(10000);
+  }
+  BOOST_CHECK_EQUAL(scrubber.getCounters().nCorruptedItems, 1);
+  BOOST_CHECK_EQUAL(store->size(), data.size() - 1);
+
+  // the Index entry is found by record ID, as the stored name cannot be decoded
+  BOOST_CHECK(!handle->hasData(*victim));
+  BOOST_CHECK(handle->hasData(*data.back()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/segment-prefetcher.hpp"
+#include "storage/sqlite-storage.hpp"
+#include "../repo-storage-fixture.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+class SegmentPrefetcherFixture : public RepoStorageFixture
+{
+public:
+  SegmentPrefetcherFixture()
+    : cachingHandle(static_cast<int64_t>(65535), *store, 1048576)
+    , prefetcher(ioService, cachingHandle, 4)
+  {
+    ndn::KeyChain keyChain;
+    for (uint64_t segment = 0; segment < N_SEGMENTS; ++segment) {
+      shared_ptr<Data> data = make_shared<Data>(Name("/object").appendSegment(segment));
+      data->setFinalBlockId(Name::Component::fromSegment(N_SEGMENTS - 1));
+      keyChain.signWithSha256(*data);
+      cachingHandle.insertData(*data);
+      segments.push_back(data);
+    }
+  }
+
+  /**
+   * @brief read a segment the way ReadHandle does, then run the prefetch
+   */
+  void
+  read(uint64_t segment)
+  {
+    shared_ptr<Data> data = cachingHandle.readData(Interest(segments[segment]->getName()));
+    BOOST_REQUIRE(static_cast<bool>(data));
+    prefetcher.onRead(*data);
+    ioService.poll();
+    ioService.reset();
+  }
+
+public:
+  static const uint64_t N_SEGMENTS = 10;
+
+  boost::asio::io_service ioService;
+  repo::RepoStorage cachingHandle;
+  repo::SegmentPrefetcher prefetcher;
+  std::vector<shared_ptr<Data> > segments;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SegmentPrefetcher, SegmentPrefetcherFixture)
+
+BOOST_AUTO_TEST_CASE(AdaptiveDepth)
+{
+  read(0);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 0);
+
+  // depth grows 1, 2, 4 while the reads are sequential
+  read(1);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 1);
+  read(2);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 3);
+  read(3);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 6);
+
+  uint64_t nHits = cachingHandle.getReadCache().getCounters().nHits;
+  read(4);
+  BOOST_CHECK_EQUAL(cachingHandle.getReadCache().getCounters().nHits, nHits + 1);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 7);
+
+  // nothing beyond FinalBlockId
+  read(5);
+  read(6);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(RandomAccess)
+{
+  read(0);
+  read(1);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 1);
+
+  read(7);
+  read(3);
+  read(5);
+  BOOST_CHECK_EQUAL(prefetcher.getNPrefetched(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/shared-memory-ring.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace repo {
+namespace tests {
+
+class SharedMemoryRingFixture
+{
+public:
+  SharedMemoryRingFixture()
+    : path((boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path()).string())
+    , owner(::geteuid())
+  {
+  }
+
+  ~SharedMemoryRingFixture()
+  {
+    boost::filesystem::remove(path);
+  }
+
+public:
+  std::string path;
+  repo::SharedMemoryRing::Owner owner;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SharedMemoryRing, SharedMemoryRingFixture)
+
+BOOST_AUTO_TEST_CASE(Wraparound)
+{
+  repo::SharedMemoryRing producer(path, 16);
+  repo::SharedMemoryRing consumer(path, owner);
+  BOOST_CHECK_EQUAL(consumer.getCapacity(), 16);
+
+  const uint8_t* element = nullptr;
+  size_t elementSize = 0;
+  BOOST_CHECK(!consumer.front(element, elementSize));
+
+  static const uint8_t first[] = {0x08, 0x04, 1, 2, 3, 4};
+  static const uint8_t second[] = {0x08, 0x05, 5, 6, 7, 8, 9};
+  BOOST_CHECK(producer.write(first, sizeof(first)));
+  BOOST_CHECK(producer.write(second, sizeof(second)));
+  // 13 of 16 bytes are used
+  BOOST_CHECK(!producer.write(first, sizeof(first)));
+
+  BOOST_REQUIRE(consumer.front(element, elementSize));
+  BOOST_CHECK_EQUAL_COLLECTIONS(element, element + elementSize, first, first + sizeof(first));
+  consumer.pop(elementSize);
+
+  // does not fit between offset 13 and the end, so it is written at the beginning
+  BOOST_CHECK(producer.write(first, sizeof(first)));
+  BOOST_CHECK_EQUAL(consumer.size(), 7 + 3 + 6);
+
+  BOOST_REQUIRE(consumer.front(element, elementSize));
+  BOOST_CHECK_EQUAL_COLLECTIONS(element, element + elementSize, second, second + sizeof(second));
+  consumer.pop(elementSize);
+
+  BOOST_REQUIRE(consumer.front(element, elementSize));
+  BOOST_CHECK_EQUAL_COLLECTIONS(element, element + elementSize, first, first + sizeof(first));
+  consumer.pop(elementSize);
+
+  BOOST_CHECK(!consumer.front(element, elementSize));
+  BOOST_CHECK_EQUAL(consumer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  static const uint8_t notRing[] = {0x06, 0x00};
+  {
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file.write(reinterpret_cast<const char*>(notRing), sizeof(notRing));
+  }
+  BOOST_CHECK_THROW(repo::SharedMemoryRing ring(path, owner), repo::SharedMemoryRing::Error);
+
+  repo::SharedMemoryRing producer(path, 16);
+  static const uint8_t tooLarge[17] = {0x08, 0x0f};
+  BOOST_CHECK_THROW(producer.write(tooLarge, sizeof(tooLarge)), repo::SharedMemoryRing::Error);
+
+  // the length claims more bytes than the producer published
+  static const uint8_t truncated[] = {0x06, 0x08, 1, 2};
+  BOOST_CHECK(producer.write(truncated, sizeof(truncated)));
+  repo::SharedMemoryRing consumer(path, owner);
+  const uint8_t* element = nullptr;
+  size_t elementSize = 0;
+  BOOST_CHECK_THROW(consumer.front(element, elementSize), repo::SharedMemoryRing::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+  repo::SharedMemoryRing producer(path, 16);
+  repo::SharedMemoryRing consumer(path, owner);
+  static const uint8_t element[] = {0x08, 0x02, 1, 2};
+  BOOST_CHECK(producer.write(element, sizeof(element)));
+
+  // reading the cut off data area would raise SIGBUS
+  BOOST_REQUIRE_EQUAL(::truncate(path.c_str(), 64), 0);
+  const uint8_t* front = nullptr;
+  size_t frontSize = 0;
+  BOOST_CHECK_THROW(consumer.front(front, frontSize), repo::SharedMemoryRing::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Untrusted)
+{
+  repo::SharedMemoryRing producer(path, 16);
+
+  // a ring of another user
+  repo::SharedMemoryRing::Owner stranger(owner.uid + 1);
+  BOOST_CHECK_THROW(repo::SharedMemoryRing ring(path, stranger), repo::SharedMemoryRing::Error);
+
+  // a ring that others can write to
+  BOOST_REQUIRE_EQUAL(::chmod(path.c_str(), 0620), 0);
+  BOOST_CHECK_THROW(repo::SharedMemoryRing ring(path, owner), repo::SharedMemoryRing::Error);
+  BOOST_REQUIRE_EQUAL(::chmod(path.c_str(), 0600), 0);
+  BOOST_CHECK_NO_THROW(repo::SharedMemoryRing ring(path, owner));
+
+  // a link to a ring
+  std::string link = path + ".link";
+  boost::filesystem::create_symlink(path, link);
+  BOOST_CHECK_THROW(repo::SharedMemoryRing ring(link, owner), repo::SharedMemoryRing::Error);
+  boost::filesystem::remove(link);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
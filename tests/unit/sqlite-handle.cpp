@@ -23,6 +23,7 @@
 #include "../dataset-fixtures.hpp"
 
 #include <boost/test/unit_test.hpp>
+#include <sqlite3.h>
 
 namespace repo {
 namespace tests {
@@ -73,6 +74,274 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(InsertReadDelete, T, CommonDatasets, Fixture<T>
   BOOST_CHECK_EQUAL(this->handle->size(), 0);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(Statistics, T, CommonDatasets, Fixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  std::vector<int64_t> ids;
+  int64_t nBytes = 0;
+
+  for (typename T::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    {
+      int64_t id = -1;
+      BOOST_REQUIRE_NO_THROW(id = this->handle->insert(**i));
+      ids.push_back(id);
+      nBytes += (*i)->wireEncode().size();
+    }
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+  BOOST_CHECK_EQUAL(this->handle->byteSize(), nBytes);
+
+  // statistics must survive reopening the database
+  delete this->handle;
+  this->handle = new repo::SqliteStorage("unittestdb");
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+  BOOST_CHECK_EQUAL(this->handle->byteSize(), nBytes);
+
+  for (std::vector<int64_t>::iterator i = ids.begin(); i != ids.end(); ++i) {
+    BOOST_CHECK_EQUAL(this->handle->erase(*i), true);
+  }
+  BOOST_CHECK_EQUAL(this->handle->size(), 0);
+  BOOST_CHECK_EQUAL(this->handle->byteSize(), 0);
+}
+
+static void
+collectItem(std::vector<Name>& names, const Storage::ItemMeta& item)
+{
+  names.push_back(item.fullName);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(PrefixEnumerateErase, T, CommonDatasets, Fixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  for (typename T::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    {
+      BOOST_REQUIRE_NO_THROW(this->handle->insert(**i));
+    }
+
+  // every Data is found under its own name, with the full name preserved
+  for (typename T::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    {
+      std::vector<Name> names;
+      this->handle->prefixEnumerate((*i)->getName(), bind(&collectItem, std::ref(names), _1));
+      BOOST_CHECK(std::find(names.begin(), names.end(), (*i)->getFullName()) != names.end());
+      for (std::vector<Name>::iterator name = names.begin(); name != names.end(); ++name) {
+        BOOST_CHECK((*i)->getName().isPrefixOf(*name));
+      }
+    }
+
+  // the root prefix enumerates everything in name order
+  std::vector<Name> all;
+  this->handle->prefixEnumerate(Name(), bind(&collectItem, std::ref(all), _1));
+  BOOST_CHECK_EQUAL(all.size(), this->data.size());
+  BOOST_CHECK(std::is_sorted(all.begin(), all.end()));
+
+  int64_t nErased = 0;
+  BOOST_REQUIRE_NO_THROW(nErased = this->handle->erase(Name()));
+  BOOST_CHECK_EQUAL(nErased, this->data.size());
+  BOOST_CHECK_EQUAL(this->handle->size(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(ReadBatch, Fixture<SamePrefixDataset<10> >)
+{
+  std::vector<int64_t> ids;
+  for (DatasetBase::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    {
+      int64_t id = this->handle->insert(**i);
+      this->idToDataMap.insert(std::make_pair(id, *i));
+      ids.push_back(id);
+    }
+
+  std::random_shuffle(ids.begin(), ids.end());
+  ids.push_back(ids.front());
+  ids.push_back(-1);
+
+  std::vector<shared_ptr<Data> > retrievedData = this->handle->readBatch(ids);
+  BOOST_REQUIRE_EQUAL(retrievedData.size(), ids.size());
+  for (size_t i = 0; i + 1 < ids.size(); ++i) {
+    BOOST_REQUIRE(static_cast<bool>(retrievedData[i]));
+    BOOST_CHECK_EQUAL(*this->idToDataMap[ids[i]], *retrievedData[i]);
+  }
+  BOOST_CHECK(!static_cast<bool>(retrievedData.back()));
+
+  // the same record is decoded once
+  BOOST_CHECK_EQUAL(retrievedData.front(), retrievedData[ids.size() - 2]);
+}
+
+BOOST_FIXTURE_TEST_CASE(ReadBatchUndecodable, Fixture<SamePrefixDataset<10> >)
+{
+  std::vector<int64_t> ids;
+  for (DatasetBase::DataContainer::iterator i = this->data.begin();
+       i != this->data.end(); ++i)
+    ids.push_back(this->handle->insert(**i));
+
+  sqlite3* db = 0;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  static const uint8_t GARBAGE[] = { 0x06, 0xFF };
+  sqlite3_stmt* stmt = 0;
+  sqlite3_prepare_v2(db, "UPDATE NDN_REPO SET data = ? WHERE id = ?;", -1, &stmt, 0);
+  sqlite3_bind_blob(stmt, 1, GARBAGE, sizeof(GARBAGE), 0);
+  sqlite3_bind_int64(stmt, 2, ids.front());
+  BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_DONE);
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+
+  // the damaged record is not found, and the others still are
+  std::vector<shared_ptr<Data> > retrievedData;
+  BOOST_REQUIRE_NO_THROW(retrievedData = this->handle->readBatch(ids));
+  BOOST_REQUIRE_EQUAL(retrievedData.size(), ids.size());
+  BOOST_CHECK(!static_cast<bool>(retrievedData.front()));
+  for (size_t i = 1; i < ids.size(); ++i)
+    BOOST_CHECK(static_cast<bool>(retrievedData[i]));
+}
+
+BOOST_FIXTURE_TEST_CASE(Reader, Fixture<SamePrefixDataset<10> >)
+{
+  int64_t id = this->handle->insert(*this->data.front());
+  shared_ptr<Storage::Reader> reader = this->handle->openReader();
+
+  // without WAL, a reader would hold locks the writer has to wait for
+  if (!this->handle->isWal()) {
+    BOOST_CHECK(!static_cast<bool>(reader));
+    return;
+  }
+
+  BOOST_REQUIRE(static_cast<bool>(reader));
+  shared_ptr<Data> retrievedData = reader->read(id);
+  BOOST_REQUIRE(static_cast<bool>(retrievedData));
+  BOOST_CHECK_EQUAL(*retrievedData, *this->data.front());
+}
+
+static void
+collectKeyLocatorHash(std::map<Name, ndn::ConstBufferPtr>& hashes, const Storage::ItemMeta& item)
+{
+  hashes[item.fullName] = item.keyLocatorHash;
+}
+
+BOOST_FIXTURE_TEST_CASE(KeyLocatorHash, Fixture<SamePrefixDataset<10> >)
+{
+  // Data signed with a key have a KeyLocator, a DigestSha256 signature does not
+  shared_ptr<Data> digestSigned = make_shared<Data>("/digest/signed");
+  ndn::KeyChain keyChain;
+  keyChain.signWithSha256(*digestSigned);
+  this->data.push_back(digestSigned);
+
+  for (DataContainer::iterator i = this->data.begin(); i != this->data.end(); ++i) {
+    BOOST_REQUIRE_NO_THROW(this->handle->insert(**i));
+  }
+
+  std::map<Name, ndn::ConstBufferPtr> enumerated;
+  this->handle->fullEnumerate(bind(&collectKeyLocatorHash, std::ref(enumerated), _1));
+  std::map<Name, ndn::ConstBufferPtr> prefixEnumerated;
+  this->handle->prefixEnumerate(Name(), bind(&collectKeyLocatorHash,
+                                             std::ref(prefixEnumerated), _1));
+  BOOST_REQUIRE_EQUAL(enumerated.size(), this->data.size());
+  BOOST_REQUIRE_EQUAL(prefixEnumerated.size(), this->data.size());
+
+  for (DataContainer::iterator i = this->data.begin(); i != this->data.end(); ++i) {
+    ndn::ConstBufferPtr expected = repo::Index::computeKeyLocatorHash(**i);
+    ndn::ConstBufferPtr hash = enumerated[(*i)->getFullName()];
+    ndn::ConstBufferPtr prefixHash = prefixEnumerated[(*i)->getFullName()];
+    if (*i == digestSigned) {
+      BOOST_CHECK(!static_cast<bool>(hash));
+      BOOST_CHECK(!static_cast<bool>(prefixHash));
+      continue;
+    }
+    BOOST_REQUIRE(static_cast<bool>(hash));
+    BOOST_REQUIRE(static_cast<bool>(prefixHash));
+    BOOST_CHECK_EQUAL_COLLECTIONS(hash->begin(), hash->end(), expected->begin(), expected->end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(prefixHash->begin(), prefixHash->end(),
+                                  expected->begin(), expected->end());
+  }
+}
+
+static int64_t
+readPragma(const std::string& pragma)
+{
+  sqlite3* db = 0;
+  BOOST_REQUIRE_EQUAL(sqlite3_open("unittestdb/ndn_repo.db", &db), SQLITE_OK);
+  sqlite3_stmt* stmt = 0;
+  std::string sql("PRAGMA " + pragma + ";");
+  sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, 0);
+  BOOST_REQUIRE_EQUAL(sqlite3_step(stmt), SQLITE_ROW);
+  int64_t value = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+  return value;
+}
+
+BOOST_FIXTURE_TEST_CASE(BackgroundCheckpoint, Fixture<SamePrefixDataset<100> >)
+{
+  delete this->handle;
+  repo::SqliteStorage::Options options;
+  options.checkpointInterval = ndn::time::milliseconds(1);
+  this->handle = new repo::SqliteStorage("unittestdb", options);
+
+  // inserts and reads go on while checkpoints run on their own connection
+  std::vector<int64_t> ids;
+  for (DataContainer::iterator i = this->data.begin(); i != this->data.end(); ++i) {
+    BOOST_REQUIRE_NO_THROW(ids.push_back(this->handle->insert(**i)));
+    boost::this_thread::sleep_for(boost::chrono::milliseconds(5));
+  }
+
+  boost::filesystem::path walPath("unittestdb/ndn_repo.db-wal");
+  if (this->handle->isWal()) {
+    // every insert appends at least one page to the WAL, which is rewound only after
+    // a checkpoint copied it back, so without checkpoints the WAL would outgrow this
+    BOOST_REQUIRE(boost::filesystem::exists(walPath));
+    BOOST_CHECK_LT(boost::filesystem::file_size(walPath),
+                   ids.size() / 2 * static_cast<uintmax_t>(readPragma("page_size")));
+  }
+  else {
+    BOOST_TEST_MESSAGE("WAL is unavailable, checkpoints are disabled");
+    BOOST_CHECK(!boost::filesystem::exists(walPath));
+  }
+
+  DataContainer::iterator data = this->data.begin();
+  for (size_t i = 0; i < ids.size(); ++i, ++data) {
+    shared_ptr<Data> retrievedData = this->handle->read(ids[i]);
+    BOOST_REQUIRE(static_cast<bool>(retrievedData));
+    BOOST_CHECK_EQUAL(*retrievedData, **data);
+  }
+  BOOST_CHECK_EQUAL(this->handle->size(), this->data.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(Reclaim, Fixture<SamePrefixDataset<100> >)
+{
+  // incremental vacuum can only be enabled on a new database
+  delete this->handle;
+  boost::filesystem::remove_all(boost::filesystem::path("unittestdb"));
+  repo::SqliteStorage::Options options;
+  options.incrementalVacuum = true;
+  this->handle = new repo::SqliteStorage("unittestdb", options);
+
+  for (DataContainer::iterator i = this->data.begin(); i != this->data.end(); ++i) {
+    BOOST_REQUIRE_NO_THROW(this->handle->insert(**i));
+  }
+  BOOST_CHECK_EQUAL(this->handle->reclaim(16), 0);
+
+  BOOST_CHECK_EQUAL(this->handle->erase(Name()), this->data.size());
+  int64_t nFreePages = readPragma("freelist_count");
+  int64_t nPages = readPragma("page_count");
+  BOOST_REQUIRE_GT(nFreePages, 1);
+
+  // budget is respected: one page leaves the freelist, and the file shrinks
+  BOOST_CHECK_GT(this->handle->reclaim(1), 0);
+  BOOST_CHECK_EQUAL(readPragma("freelist_count"), nFreePages - 1);
+  BOOST_CHECK_LT(readPragma("page_count"), nPages);
+
+  // repeated calls eventually empty the freelist
+  while (this->handle->reclaim(1) > 0) {
+  }
+  BOOST_CHECK_EQUAL(readPragma("freelist_count"), 0);
+  BOOST_CHECK_LE(readPragma("page_count"), nPages - nFreePages);
+  BOOST_CHECK_EQUAL(this->handle->reclaim(16), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -18,10 +18,13 @@
  */
 
 #include "handles/tcp-bulk-insert-handle.hpp"
+#include "bulk-insert-ack.hpp"
+#include "util/shared-memory-ring.hpp"
 #include "storage/sqlite-storage.hpp"
 #include "../repo-storage-fixture.hpp"
 #include "../dataset-fixtures.hpp"
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 namespace repo {
@@ -78,9 +81,12 @@ class TcpBulkInsertFixture : public TcpClient,
                              public Dataset
 {
 public:
-  TcpBulkInsertFixture()
-    : scheduler(ioService)
-    , bulkInserter(ioService, *handle)
+  explicit
+  TcpBulkInsertFixture(size_t nThreads = 0,
+                       const shared_ptr<Storage>& storage = make_shared<SqliteStorage>("unittestdb"))
+    : RepoStorageFixture(storage)
+    , scheduler(ioService)
+    , bulkInserter(ioService, *handle, nThreads)
   {
     guardEvent = scheduler.scheduleEvent(ndn::time::seconds(2),
                                          bind(&TcpBulkInsertFixture::fail, this, "Test timed out"));
@@ -152,6 +158,159 @@ public:
   repo::TcpBulkInsertHandle bulkInserter;
 };
 
+template<class Dataset>
+class TcpBulkInsertThreadsFixture : public TcpBulkInsertFixture<Dataset>
+{
+public:
+  TcpBulkInsertThreadsFixture()
+    : TcpBulkInsertFixture<Dataset>(2)
+  {
+  }
+};
+
+template<class Dataset>
+class TcpBulkInsertAckFixture : public TcpBulkInsertFixture<Dataset>
+{
+public:
+  explicit
+  TcpBulkInsertAckFixture(const shared_ptr<Storage>& storage =
+                            make_shared<SqliteStorage>("unittestdb"))
+    : TcpBulkInsertFixture<Dataset>(0, storage)
+  {
+  }
+
+  virtual void
+  onSuccessfullConnect(const boost::system::error_code& error)
+  {
+    static const uint8_t ACK_REQUEST[] = {
+      0xdb, 0x00
+    };
+
+    this->socket.async_send(boost::asio::buffer(ACK_REQUEST, sizeof(ACK_REQUEST)),
+                            bind(&TcpBulkInsertAckFixture::onSendFinished, this, _1, false));
+
+    TcpBulkInsertFixture<Dataset>::onSuccessfullConnect(error);
+
+    receiveAck();
+  }
+
+  void
+  receiveAck()
+  {
+    this->socket.async_receive(boost::asio::buffer(buffer, sizeof(buffer)),
+                               bind(&TcpBulkInsertAckFixture::onAckReceived, this, _1, _2));
+  }
+
+  void
+  onAckReceived(const boost::system::error_code& error, std::size_t nBytesReceived)
+  {
+    if (error)
+      return;
+
+    input.insert(input.end(), buffer, buffer + nBytesReceived);
+
+    Block element;
+    while (Block::fromBuffer(input.data(), input.size(), element)) {
+      lastAck.wireDecode(element);
+      input.erase(input.begin(), input.begin() + element.size());
+    }
+
+    receiveAck();
+  }
+
+public:
+  uint8_t buffer[8800];
+  std::vector<uint8_t> input;
+  repo::BulkInsertAck lastAck;
+};
+
+/**
+ * @brief a storage whose every batch insert fails, as on a full or broken disk
+ */
+class FailingStorage : public SqliteStorage
+{
+public:
+  FailingStorage()
+    : SqliteStorage("unittestdb")
+  {
+  }
+
+  virtual std::vector<int64_t>
+  insertBatch(const std::vector<shared_ptr<const PreparedData> >&)
+  {
+    throw Error("batch insert commit failed");
+  }
+};
+
+template<class Dataset>
+class StorageErrorFixture : public TcpBulkInsertAckFixture<Dataset>
+{
+public:
+  StorageErrorFixture()
+    : TcpBulkInsertAckFixture<Dataset>(make_shared<FailingStorage>())
+  {
+  }
+};
+
+template<class Dataset>
+class LocalBulkInsertRingFixture : public RepoStorageFixture,
+                                   public Dataset
+{
+public:
+  LocalBulkInsertRingFixture()
+    : scheduler(ioService)
+    , socket(ioService)
+    , bulkInserter(ioService, *handle)
+    , socketPath((boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path()).string())
+    , ringPath((boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path()).string())
+  {
+  }
+
+  ~LocalBulkInsertRingFixture()
+  {
+    boost::filesystem::remove(socketPath);
+    boost::filesystem::remove(ringPath);
+  }
+
+  void
+  run()
+  {
+    bulkInserter.listenLocal(socketPath, true);
+
+    repo::SharedMemoryRing ring(ringPath, 1048576);
+    for (typename Dataset::DataContainer::iterator i = this->data.begin();
+         i != this->data.end(); ++i) {
+      BOOST_REQUIRE(ring.write((*i)->wireEncode().wire(), (*i)->wireEncode().size()));
+    }
+
+    socket.connect(boost::asio::local::stream_protocol::endpoint(socketPath));
+    Block element = ndn::dataBlock(tlv::BulkInsertRing, ringPath.data(), ringPath.size());
+    boost::asio::write(socket, boost::asio::buffer(element.wire(), element.size()));
+
+    scheduler.scheduleEvent(ndn::time::seconds(1),
+                            bind(&LocalBulkInsertRingFixture::stop, this));
+    ioService.run();
+
+    BOOST_CHECK_EQUAL(ring.size(), 0);
+  }
+
+  void
+  stop()
+  {
+    socket.close();
+    bulkInserter.stop();
+  }
+
+public:
+  boost::asio::io_service ioService;
+  Scheduler scheduler;
+  boost::asio::local::stream_protocol::socket socket;
+  repo::TcpBulkInsertHandle bulkInserter;
+  std::string socketPath;
+  std::string ringPath;
+};
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(BulkInsertAndRead, T, CommonDatasets, TcpBulkInsertFixture<T>)
 {
@@ -173,6 +332,63 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(BulkInsertAndRead, T, CommonDatasets, TcpBulkIn
   }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(BulkInsertWithThreads, T, CommonDatasets,
+                                 TcpBulkInsertThreadsFixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  this->bulkInserter.listen("localhost", "17378");
+  this->start("localhost", "17378");
+  this->ioService.run();
+
+  for (typename T::InterestContainer::iterator i = this->interests.begin();
+       i != this->interests.end(); ++i) {
+      BOOST_CHECK_EQUAL(*this->handle->readData(i->first), *i->second);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(BulkInsertWithAck, T, CommonDatasets, TcpBulkInsertAckFixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  this->bulkInserter.listen("localhost", "17377");
+  this->start("localhost", "17377");
+  this->ioService.run();
+
+  // the last acknowledgement covers every Data sent on the connection
+  BOOST_CHECK_EQUAL(this->lastAck.getStatusCode(), 200);
+  BOOST_CHECK_EQUAL(this->lastAck.getFailedNum(), 0);
+  BOOST_CHECK_EQUAL(this->lastAck.getProcessedNum(), this->data.size());
+  BOOST_CHECK_EQUAL(this->lastAck.getLastName(), this->data.back()->getName());
+}
+
+BOOST_FIXTURE_TEST_CASE(BulkInsertStorageError, StorageErrorFixture<BasicDataset>)
+{
+  bulkInserter.listen("localhost", "17379");
+  start("localhost", "17379");
+  ioService.run();
+
+  // every Data is acknowledged as failed, and none is in repo
+  BOOST_CHECK_EQUAL(lastAck.getStatusCode(), 500);
+  BOOST_CHECK_EQUAL(lastAck.getInsertNum(), 0);
+  BOOST_CHECK_EQUAL(lastAck.getFailedNum(), data.size());
+  BOOST_CHECK_EQUAL(lastAck.getProcessedNum(), data.size());
+  for (InterestContainer::iterator i = interests.begin(); i != interests.end(); ++i)
+    BOOST_CHECK(!static_cast<bool>(handle->readData(i->first)));
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(LocalBulkInsertWithRing, T, CommonDatasets,
+                                 LocalBulkInsertRingFixture<T>)
+{
+  BOOST_TEST_MESSAGE(T::getName());
+
+  this->run();
+
+  for (typename T::InterestContainer::iterator i = this->interests.begin();
+       i != this->interests.end(); ++i) {
+      BOOST_CHECK_EQUAL(*this->handle->readData(i->first), *i->second);
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
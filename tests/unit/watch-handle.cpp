@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handles/watch-handle.hpp"
+
+#include "../handle-fixture.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+using ndn::time::milliseconds;
+
+/**
+ * @brief InterestLifetime of the watch, long enough for the margins HandleFixture asks for
+ */
+static const milliseconds LIFETIME(200);
+
+/**
+ * @brief a WatchHandle watching /stream with a window of 4, whose first Data is number 5
+ */
+class WatchHandleFixture : public HandleFixture
+{
+public:
+  WatchHandleFixture()
+    : watchHandle(*face, *handle, signer, scheduler, validator, validationPool)
+    , prefix("/stream")
+  {
+    watchHandle.listen(Name("/repo/command"));
+    advance(milliseconds(10));
+
+    RepoCommandParameter parameter;
+    parameter.setName(prefix);
+    parameter.setWatchWindow(4);
+    parameter.setInterestLifetime(LIFETIME);
+    BOOST_REQUIRE_EQUAL(sendCommand(Name("/repo/command/watch/start"), parameter)
+                          .getStatusCode(), 100);
+    BOOST_REQUIRE_EQUAL(countInterests(prefix), 1);
+
+    face->receive(*makeSequence(5));
+    advance(milliseconds(10));
+  }
+
+  shared_ptr<Data>
+  makeSequence(uint64_t sequence)
+  {
+    return makeData(Name(prefix).appendSequenceNumber(sequence), "sequence");
+  }
+
+  /**
+   * @brief get the number of Interests guessing @p sequence
+   */
+  size_t
+  countGuesses(uint64_t sequence) const
+  {
+    return countInterests(Name(prefix).appendSequenceNumber(sequence));
+  }
+
+  uint64_t
+  getInsertNum()
+  {
+    RepoCommandParameter parameter;
+    parameter.setName(prefix);
+    return sendCommand(Name("/repo/command/watch/check"), parameter).getInsertNum();
+  }
+
+public:
+  repo::WatchHandle watchHandle;
+  Name prefix;
+};
+
+BOOST_FIXTURE_TEST_SUITE(WatchHandle, WatchHandleFixture)
+
+BOOST_AUTO_TEST_CASE(FillWindow)
+{
+  for (uint64_t sequence = 6; sequence < 10; ++sequence)
+    BOOST_CHECK_EQUAL(countGuesses(sequence), 1);
+  BOOST_CHECK_EQUAL(countGuesses(10), 0);
+  BOOST_CHECK_EQUAL(getInsertNum(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(OutOfOrder)
+{
+  shared_ptr<Data> eighth = makeSequence(8);
+  shared_ptr<Data> sixth = makeSequence(6);
+  face->receive(*eighth);
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countGuesses(10), 1);
+  BOOST_CHECK_EQUAL(countGuesses(11), 0);
+
+  face->receive(*sixth);
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countGuesses(11), 1);
+  BOOST_CHECK_EQUAL(countGuesses(12), 0);
+
+  // 7 is still awaited, and not guessed again
+  BOOST_CHECK_EQUAL(countGuesses(7), 1);
+  BOOST_CHECK_EQUAL(getInsertNum(), 3);
+  BOOST_CHECK(handle->hasData(*eighth));
+  BOOST_CHECK(handle->hasData(*sixth));
+}
+
+BOOST_AUTO_TEST_CASE(Duplicate)
+{
+  shared_ptr<Data> seventh = makeSequence(7);
+  BOOST_REQUIRE(handle->insertData(*seventh));
+
+  // Data already in repo frees its slot, but is not counted as inserted
+  face->receive(*seventh);
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countGuesses(10), 1);
+  BOOST_CHECK_EQUAL(getInsertNum(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutRetry)
+{
+  face->receive(*makeSequence(8));
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countGuesses(10), 1);
+
+  // guesses 6 to 9 were sent when 5 arrived, and time out every LIFETIME from then on;
+  // each check below is made about half a LIFETIME after a timeout
+
+  // 6 and 7 are below the highest number received, and are retried after a timeout
+  advance(LIFETIME + LIFETIME / 2);
+  BOOST_CHECK_EQUAL(countGuesses(6), 2);
+  BOOST_CHECK_EQUAL(countGuesses(7), 2);
+  BOOST_CHECK_EQUAL(countGuesses(11), 0);
+
+  // after the third retry times out, they are taken as skipped and their slots refilled
+  advance(LIFETIME * 3);
+  BOOST_CHECK_EQUAL(countGuesses(6), 4);
+  BOOST_CHECK_EQUAL(countGuesses(7), 4);
+  BOOST_CHECK_EQUAL(countGuesses(11), 1);
+  BOOST_CHECK_EQUAL(countGuesses(12), 1);
+
+  // 9 is not produced yet, and is asked for as long as the watch runs
+  BOOST_CHECK_EQUAL(countGuesses(9), 5);
+
+  advance(LIFETIME);
+  BOOST_CHECK_EQUAL(countGuesses(6), 4);
+  BOOST_CHECK_EQUAL(countGuesses(7), 4);
+  BOOST_CHECK_GT(countGuesses(9), 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
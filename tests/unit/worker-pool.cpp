@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util/worker-pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(WorkerPool)
+
+class Fixture
+{
+public:
+  Fixture()
+    : work(new boost::asio::io_service::work(io))
+    , nCompleted(0)
+  {
+  }
+
+  static void
+  spin(size_t worker, uint64_t nIterations)
+  {
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < nIterations; ++i)
+      sum += i;
+  }
+
+  void
+  onComplete(uint64_t key, size_t index, size_t nTotal)
+  {
+    completions[key].push_back(index);
+    if (++nCompleted == nTotal)
+      work.reset();
+  }
+
+public:
+  boost::asio::io_service io;
+  std::unique_ptr<boost::asio::io_service::work> work;
+  std::map<uint64_t, std::vector<size_t> > completions;
+  size_t nCompleted;
+};
+
+BOOST_FIXTURE_TEST_CASE(OrderPerKey, Fixture)
+{
+  static const size_t N_TASKS = 600;
+  repo::WorkerPool pool(io, 4);
+
+  for (size_t i = 0; i < N_TASKS; ++i) {
+    // work of uneven length finishes out of order
+    pool.submit(i % 3,
+                bind(&Fixture::spin, _1, (i * 7919) % 20000),
+                bind(&Fixture::onComplete, this, i % 3, i, N_TASKS));
+  }
+  io.run();
+
+  BOOST_REQUIRE_EQUAL(completions.size(), 3);
+  for (uint64_t key = 0; key < 3; ++key) {
+    const std::vector<size_t>& indices = completions[key];
+    BOOST_REQUIRE_EQUAL(indices.size(), N_TASKS / 3);
+    for (size_t i = 0; i < indices.size(); ++i)
+      BOOST_CHECK_EQUAL(indices[i], i * 3 + key);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(CompletionWithoutWork, Fixture)
+{
+  repo::WorkerPool pool(io, 2);
+
+  pool.submit(1, bind(&Fixture::spin, _1, 1000000), bind(&Fixture::onComplete, this, 1, 0, 3));
+  pool.submit(1, bind(&Fixture::onComplete, this, 1, 1, 3));
+  pool.submit(2, bind(&Fixture::onComplete, this, 2, 2, 3));
+  io.run();
+
+  // only completions of the same key wait for each other
+  BOOST_REQUIRE_EQUAL(completions[1].size(), 2);
+  BOOST_CHECK_EQUAL(completions[1][0], 0);
+  BOOST_CHECK_EQUAL(completions[1][1], 1);
+  BOOST_CHECK_EQUAL(completions[2].size(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(Destroyed, Fixture)
+{
+  {
+    repo::WorkerPool pool(io, 2);
+    for (size_t i = 0; i < 10; ++i)
+      pool.submit(i, bind(&Fixture::spin, _1, 1000), bind(&Fixture::onComplete, this, i, i, 10));
+    pool.submit(0, bind(&Fixture::onComplete, this, 0, 10, 10));
+  }
+
+  // completions posted before the pool was destroyed are dropped
+  work.reset();
+  io.run();
+  BOOST_CHECK_EQUAL(nCompleted, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(Inline, Fixture)
+{
+  repo::WorkerPool pool(io, 0);
+
+  pool.submit(1, bind(&Fixture::spin, _1, 10), bind(&Fixture::onComplete, this, 1, 0, 1));
+  BOOST_CHECK_EQUAL(nCompleted, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
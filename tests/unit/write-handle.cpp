@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014,  Regents of the University of California.
+ *
+ * This file is part of NDN repo-ng (Next generation of NDN repository).
+ * See AUTHORS.md for complete list of repo-ng authors and contributors.
+ *
+ * repo-ng is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * repo-ng is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * repo-ng, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handles/write-handle.hpp"
+
+#include "../handle-fixture.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+namespace repo {
+namespace tests {
+
+using ndn::time::milliseconds;
+
+/**
+ * @brief InterestLifetime of a manifest fetch, long enough for the margins HandleFixture asks for
+ */
+static const milliseconds LIFETIME(200);
+
+/**
+ * @brief a WriteHandle on a DummyClientFace, which accepts every command and Data
+ */
+class WriteHandleFixture : public HandleFixture
+{
+public:
+  WriteHandleFixture()
+    : writeHandle(*face, *handle, signer, scheduler, validator, validationPool)
+  {
+    writeHandle.listen(Name("/repo/command"));
+    advance(milliseconds(10));
+  }
+
+  /**
+   * @brief send an insert command, and return the ProcessId of the response
+   */
+  ProcessId
+  insert(const RepoCommandParameter& parameter)
+  {
+    return sendCommand(Name("/repo/command/insert"), parameter).getProcessId();
+  }
+
+  RepoCommandResponse
+  check(ProcessId processId)
+  {
+    RepoCommandParameter parameter;
+    parameter.setProcessId(processId);
+    return sendCommand(Name("/repo/command").append("insert check"), parameter);
+  }
+
+public:
+  repo::WriteHandle writeHandle;
+};
+
+/**
+ * @brief two Data and a manifest listing them by full name
+ */
+class ManifestFixture : public WriteHandleFixture
+{
+public:
+  ManifestFixture()
+  {
+    data.push_back(makeData("/object/a", "a"));
+    data.push_back(makeData("/object/b", "b"));
+
+    RepoManifest content;
+    for (size_t i = 0; i < data.size(); ++i)
+      content.addEntry(data[i]->getFullName());
+    manifest = make_shared<Data>("/object/manifest");
+    manifest->setContent(content.wireEncode());
+    keyChain.sign(*manifest);
+
+    parameter.setManifestName(manifest->getName());
+    parameter.setInterestLifetime(LIFETIME);
+  }
+
+  /**
+   * @brief answer the manifest and the Data it lists
+   */
+  void
+  serve()
+  {
+    face->receive(*manifest);
+    advance(milliseconds(10));
+    for (size_t i = 0; i < data.size(); ++i) {
+      BOOST_CHECK_EQUAL(countInterests(data[i]->getFullName()), 1);
+      face->receive(*data[i]);
+    }
+    advance(milliseconds(10));
+  }
+
+public:
+  std::vector<shared_ptr<Data> > data;
+  shared_ptr<Data> manifest;
+  RepoCommandParameter parameter;
+};
+
+BOOST_AUTO_TEST_SUITE(WriteHandle)
+
+BOOST_FIXTURE_TEST_CASE(Manifest, ManifestFixture)
+{
+  ProcessId processId = insert(parameter);
+  BOOST_CHECK_EQUAL(countInterests(manifest->getName()), 1);
+
+  serve();
+
+  RepoCommandResponse response = check(processId);
+  BOOST_CHECK_EQUAL(response.getStatusCode(), 200);
+  BOOST_CHECK_EQUAL(response.getInsertNum(), data.size());
+  BOOST_CHECK(handle->hasData(*manifest));
+  for (size_t i = 0; i < data.size(); ++i)
+    BOOST_CHECK(handle->hasData(*data[i]));
+}
+
+BOOST_FIXTURE_TEST_CASE(ManifestReinsert, ManifestFixture)
+{
+  insert(parameter);
+  serve();
+
+  // manifest and Data are already in repo, and still count as inserted
+  face->sentInterests.clear();
+  ProcessId processId = insert(parameter);
+  serve();
+
+  RepoCommandResponse response = check(processId);
+  BOOST_CHECK_EQUAL(response.getStatusCode(), 200);
+  BOOST_CHECK_EQUAL(response.getInsertNum(), data.size());
+}
+
+BOOST_FIXTURE_TEST_CASE(ManifestTimeout, ManifestFixture)
+{
+  ProcessId processId = insert(parameter);
+
+  // the manifest is requested again after each timeout
+  advance(LIFETIME + LIFETIME / 2);
+  BOOST_CHECK_EQUAL(countInterests(manifest->getName()), 2);
+  BOOST_CHECK_EQUAL(check(processId).getStatusCode(), 300);
+
+  // the third retry times out at four lifetimes
+  advance(LIFETIME * 3);
+  BOOST_CHECK_EQUAL(countInterests(manifest->getName()), 4);
+  BOOST_CHECK_EQUAL(check(processId).getStatusCode(), 408);
+  BOOST_CHECK(!handle->hasData(*manifest));
+}
+
+/**
+ * @brief a segmented object whose first segment lists the second by full name
+ */
+class TrustedSegmentFixture : public WriteHandleFixture
+{
+public:
+  TrustedSegmentFixture()
+  {
+    Name objectName("/object");
+    secondSegment = makeData(Name(objectName).appendSegment(1), "second");
+    forgedSegment = makeData(secondSegment->getName(), "forged");
+
+    RepoManifest content;
+    content.addEntry(secondSegment->getFullName());
+    firstSegment = make_shared<Data>(Name(objectName).appendSegment(0));
+    firstSegment->setContentType(tlv::ContentType_Manifest);
+    firstSegment->setContent(content.wireEncode());
+    keyChain.sign(*firstSegment);
+
+    parameter.setName(objectName);
+    parameter.setStartBlockId(0);
+    parameter.setEndBlockId(1);
+    parameter.setInterestLifetime(milliseconds(1000));
+  }
+
+public:
+  shared_ptr<Data> firstSegment;
+  shared_ptr<Data> secondSegment;
+  shared_ptr<Data> forgedSegment;
+  RepoCommandParameter parameter;
+};
+
+BOOST_FIXTURE_TEST_CASE(DigestMismatch, TrustedSegmentFixture)
+{
+  ProcessId processId = insert(parameter);
+  face->receive(*firstSegment);
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countInterests(secondSegment->getName()), 1);
+
+  // Data that is not the one vouched for is requested again right away
+  face->receive(*forgedSegment);
+  advance(milliseconds(10));
+  BOOST_CHECK_EQUAL(countInterests(secondSegment->getName()), 2);
+  BOOST_CHECK_EQUAL(check(processId).getStatusCode(), 300);
+
+  face->receive(*secondSegment);
+  advance(milliseconds(10));
+  RepoCommandResponse response = check(processId);
+  BOOST_CHECK_EQUAL(response.getStatusCode(), 200);
+  BOOST_CHECK_EQUAL(response.getInsertNum(), 2);
+  BOOST_CHECK(handle->hasData(*secondSegment));
+  BOOST_CHECK(!handle->hasData(*forgedSegment));
+}
+
+BOOST_FIXTURE_TEST_CASE(DigestMismatchRetryLimit, TrustedSegmentFixture)
+{
+  ProcessId processId = insert(parameter);
+  face->receive(*firstSegment);
+  advance(milliseconds(10));
+
+  // the first transmission and three retransmissions are all answered with forged Data
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(countInterests(secondSegment->getName()), i + 1);
+    face->receive(*forgedSegment);
+    advance(milliseconds(10));
+  }
+  BOOST_CHECK_EQUAL(countInterests(secondSegment->getName()), 4);
+  BOOST_CHECK_EQUAL(check(processId).getStatusCode(), 401);
+  BOOST_CHECK(!handle->hasData(*forgedSegment));
+}
+
+BOOST_FIXTURE_TEST_CASE(IndexFull, HandleFixture)
+{
+  // a repo with room for two of the three segments
+  RepoStorage smallStorage(static_cast<int64_t>(2), *store);
+  repo::WriteHandle writeHandle(*face, smallStorage, signer, scheduler, validator,
+                                validationPool);
+  writeHandle.listen(Name("/repo/command"));
+  advance(milliseconds(10));
+
+  Name objectName("/object");
+  RepoCommandParameter parameter;
+  parameter.setName(objectName);
+  parameter.setStartBlockId(0);
+  parameter.setEndBlockId(2);
+  parameter.setInterestLifetime(milliseconds(1000));
+  ProcessId processId = sendCommand(Name("/repo/command/insert"), parameter).getProcessId();
+
+  for (uint64_t segment = 0; segment <= 2; ++segment) {
+    face->receive(*makeData(Name(objectName).appendSegment(segment), "segment"));
+    advance(milliseconds(10));
+  }
+
+  // the segment that did not fit fails the process, instead of leaving it at 300
+  RepoCommandParameter checkParameter;
+  checkParameter.setProcessId(processId);
+  RepoCommandResponse response =
+    sendCommand(Name("/repo/command").append("insert check"), checkParameter);
+  BOOST_CHECK_EQUAL(response.getStatusCode(), 507);
+  BOOST_CHECK_EQUAL(response.getInsertNum(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace repo
@@ -70,6 +70,7 @@ public:
     , watchTimeout(0)
     , hasMaxInterestNum(false)
     , maxInterestNum(0)
+    , watchWindow(1)
     , status(START)
     , isVerbose(false)
 
@@ -122,6 +123,7 @@ public:
   milliseconds watchTimeout;
   bool hasMaxInterestNum;
   int64_t maxInterestNum;
+  uint64_t watchWindow;
   CommandType status;
   ndn::Name repoPrefix;
   ndn::Name ndnName;
@@ -164,6 +166,9 @@ NdnRepoWatch::startWatchCommand()
     if (hasTimeout) {
       parameters.setWatchTimeout(watchTimeout);
     }
+    if (watchWindow > 1) {
+      parameters.setWatchWindow(watchWindow);
+    }
     ndn::Interest commandInterest = generateCommandInterest(repoPrefix, "start", parameters);
     m_face.expressInterest(commandInterest,
                            bind(&NdnRepoWatch::onWatchCommandResponse, this,
@@ -295,7 +300,7 @@ usage()
   fprintf(stderr,
           "NdnRepoWatch [-I identity]"
           "  [-x freshness] [-l lifetime] [-w watchtimeout]"
-          "  [-n maxinterestnum][-s stop] [-c check]repo-prefix ndn-name\n"
+          "  [-n maxinterestnum] [-p window] [-s stop] [-c check]repo-prefix ndn-name\n"
           "\n"
           " Write a file into a repo.\n"
           "  -I: specify identity used for signing commands\n"
@@ -303,6 +308,8 @@ usage()
           "  -l: InterestLifetime in milliseconds for each command\n"
           "  -w: timeout in milliseconds for whole process (default unlimited)\n"
           "  -n: total number of interests to be sent for whole process (default unlimited)\n"
+          "  -p: number of interests kept outstanding when Data names carry sequence numbers\n"
+          "      (default 1)\n"
           "  -s: stop the whole process\n"
           "  -c: check the process\n"
           "  repo-prefix: repo command prefix\n"
@@ -316,7 +323,7 @@ main(int argc, char** argv)
 {
   NdnRepoWatch app;
   int opt;
-  while ((opt = getopt(argc, argv, "x:l:w:n:scI:")) != -1) {
+  while ((opt = getopt(argc, argv, "x:l:w:n:p:scI:")) != -1) {
     switch (opt) {
     case 'x':
       try {
@@ -356,6 +363,15 @@ main(int argc, char** argv)
         return 1;
       }
       break;
+    case 'p':
+      try {
+        app.watchWindow = boost::lexical_cast<uint64_t>(optarg);
+      }
+      catch (boost::bad_lexical_cast&) {
+        std::cerr << "-p option should be an integer.";
+        return 1;
+      }
+      break;
     case 's':
       app.status = STOP;
       break;
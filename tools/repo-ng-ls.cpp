@@ -18,6 +18,7 @@
  */
 
 #include "../src/common.hpp"
+#include "../src/storage/prefix-key.hpp"
 #include "config.hpp"
 #include <string>
 #include <sqlite3.h>
@@ -34,7 +35,7 @@ printUsage(const char* programName)
 
   std::cout
     << "Usage:\n"
-    << "  " << programName << " [-c <path/to/repo-ng.conf>] [-n] [-h]\n"
+    << "  " << programName << " [-c <path/to/repo-ng.conf>] [-p <prefix>] [-n] [-h]\n"
     << "\n"
     << "List names of Data packets in NDN repository. "
     << "By default, all names will include the implicit digest of Data packets\n"
@@ -42,6 +43,7 @@ printUsage(const char* programName)
     << "Options:\n"
     << "  -h: show help message\n"
     << "  -c: set config file path\n"
+    << "  -p: list only names under this prefix\n"
     << "  -n: do not show implicit digest\n"
     << std::endl;
   ;
@@ -66,7 +68,21 @@ public:
   uint64_t
   enumerate(bool showImplicitDigest);
 
+  /**
+   * @brief list names under a prefix using a range scan over the prefixKey index
+   *
+   * Falls back to a filtered full scan for databases without prefixKey column.
+   */
+  uint64_t
+  enumerate(const Name& prefix, bool showImplicitDigest);
+
 private:
+  uint64_t
+  enumerateByScan(const Name& prefix, bool showImplicitDigest);
+
+  void
+  printName(const Name& name, bool showImplicitDigest);
+
   void
   readConfig(const std::string& configFile);
 
@@ -135,12 +151,7 @@ RepoEnumerator::enumerate(bool showImplicitDigest)
       name.wireDecode(Block(sqlite3_column_blob(m_stmt, 1),
                             sqlite3_column_bytes(m_stmt, 1)));
       try {
-        if (showImplicitDigest) {
-          std::cout << name << std::endl;
-        }
-        else {
-          std::cout << name.getPrefix(-1) << std::endl;
-        }
+        printName(name, showImplicitDigest);
       }
       catch (...){
         sqlite3_finalize(m_stmt);
@@ -160,13 +171,98 @@ RepoEnumerator::enumerate(bool showImplicitDigest)
   return entryNumber;
 }
 
+uint64_t
+RepoEnumerator::enumerate(const Name& prefix, bool showImplicitDigest)
+{
+  ndn::Buffer lowerKey = encodePrefixKey(prefix);
+  ndn::Buffer upperKey = getPrefixKeySuccessor(lowerKey);
+
+  sqlite3_stmt* m_stmt = 0;
+  string sql = upperKey.empty() ?
+    "SELECT prefixKey FROM NDN_REPO WHERE prefixKey >= ? ORDER BY prefixKey;" :
+    "SELECT prefixKey FROM NDN_REPO WHERE prefixKey >= ? AND prefixKey < ? ORDER BY prefixKey;";
+  int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &m_stmt, 0);
+  if (rc != SQLITE_OK) {
+    // database written by a repo without prefixKey column
+    sqlite3_finalize(m_stmt);
+    return enumerateByScan(prefix, showImplicitDigest);
+  }
+
+  sqlite3_bind_blob(m_stmt, 1, lowerKey.buf(), lowerKey.size(), 0);
+  if (!upperKey.empty())
+    sqlite3_bind_blob(m_stmt, 2, upperKey.buf(), upperKey.size(), 0);
+
+  uint64_t entryNumber = 0;
+  while (true) {
+    rc = sqlite3_step(m_stmt);
+    if (rc == SQLITE_ROW) {
+      try {
+        const uint8_t* key = static_cast<const uint8_t*>(sqlite3_column_blob(m_stmt, 0));
+        printName(decodePrefixKey(key, sqlite3_column_bytes(m_stmt, 0)), showImplicitDigest);
+      }
+      catch (...){
+        sqlite3_finalize(m_stmt);
+        throw;
+      }
+      entryNumber++;
+    }
+    else if (rc == SQLITE_DONE) {
+      sqlite3_finalize(m_stmt);
+      break;
+    }
+    else {
+      sqlite3_finalize(m_stmt);
+      throw Error("Read Entries by prefix error");
+    }
+  }
+  return entryNumber;
+}
+
+uint64_t
+RepoEnumerator::enumerateByScan(const Name& prefix, bool showImplicitDigest)
+{
+  sqlite3_stmt* m_stmt = 0;
+  string sql = string("SELECT name FROM NDN_REPO;");
+  int rc = sqlite3_prepare_v2(m_db, sql.c_str(), -1, &m_stmt, 0);
+  if (rc != SQLITE_OK)
+    throw Error("Read Entries from Database Prepare error");
+
+  uint64_t entryNumber = 0;
+  while ((rc = sqlite3_step(m_stmt)) == SQLITE_ROW) {
+    Name name;
+    name.wireDecode(Block(sqlite3_column_blob(m_stmt, 0),
+                          sqlite3_column_bytes(m_stmt, 0)));
+    if (prefix.isPrefixOf(name)) {
+      printName(name, showImplicitDigest);
+      entryNumber++;
+    }
+  }
+  sqlite3_finalize(m_stmt);
+  if (rc != SQLITE_DONE)
+    throw Error("Read Entries error");
+  return entryNumber;
+}
+
+void
+RepoEnumerator::printName(const Name& name, bool showImplicitDigest)
+{
+  if (showImplicitDigest) {
+    std::cout << name << std::endl;
+  }
+  else {
+    std::cout << name.getPrefix(-1) << std::endl;
+  }
+}
+
 int
 main(int argc, char** argv)
 {
   string configPath = DEFAULT_CONFIG_FILE;
   bool showImplicitDigest = true;
+  bool hasPrefix = false;
+  Name prefix;
   int opt;
-  while ((opt = getopt(argc, argv, "hc:n")) != -1) {
+  while ((opt = getopt(argc, argv, "hc:p:n")) != -1) {
     switch (opt) {
     case 'h':
       printUsage(argv[0]);
@@ -174,6 +270,10 @@ main(int argc, char** argv)
     case 'c':
       configPath = string(optarg);
       break;
+    case 'p':
+      prefix = Name(optarg);
+      hasPrefix = true;
+      break;
     case 'n':
       showImplicitDigest = false;
       break;
@@ -183,7 +283,8 @@ main(int argc, char** argv)
   }
 
   RepoEnumerator instance(configPath);
-  uint64_t count = instance.enumerate(showImplicitDigest);
+  uint64_t count = hasPrefix ? instance.enumerate(prefix, showImplicitDigest) :
+                               instance.enumerate(showImplicitDigest);
   std::cerr << "Total number of data = " << count << std::endl;
   return 0;
 }